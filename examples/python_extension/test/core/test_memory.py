@@ -49,15 +49,21 @@ def run_memory_test():
     if (aclshmem_buffer.addr is None) or (aclshmem_buffer.length != g_malloc_size):
         raise ValueError('[ERROR] create buffer failed')
 
-    # 4. get next pe buffer
+    # 4. heap stats
+    stats = core.heap_stats()
+    print(f'pe[{pe}]: heap stats: {stats}')
+    if stats['used_bytes'] < g_malloc_size or stats['largest_free_block'] > stats['free_bytes']:
+        raise ValueError('[ERROR] heap stats mismatch')
+
+    # 5. get next pe buffer
     next_aclshmem_buffer = core.get_peer_buffer(aclshmem_buffer, next)
     if (next_aclshmem_buffer.addr is None) or (next_aclshmem_buffer.length != g_malloc_size):
         raise ValueError('[ERROR] get peer buffer failed')
 
-    # 5. free buffer
+    # 6. free buffer
     core.free(aclshmem_buffer)
 
-    # 6. finialize
+    # 7. finialize
     core.finalize()
 
 
@@ -100,6 +100,65 @@ ACLSHMEM_HOST_API void *aclshmemx_align(size_t alignment, size_t size, aclshmem_
  */
 ACLSHMEM_HOST_API void aclshmemx_free(void *ptr, aclshmem_mem_type_t mem_type = DEVICE_SIDE);
 
+/**
+ * @brief Changes the size of the symmetric memory block pointed to by <i>ptr</i> to <i>size</i> bytes. The block is
+ *        resized in place when that is possible on all PEs, otherwise a new block is allocated, the contents are
+ *        copied up to the smaller of the old and new sizes and the old block is freed. All PEs must pass the same
+ *        <i>ptr</i> and <i>size</i>. If <i>ptr</i> is NULL, this call is equivalent to <b>aclshmemx_malloc()</b>;
+ *        if <i>size</i> is 0, it is equivalent to <b>aclshmemx_free()</b> and returns NULL.
+ *
+ * @param ptr           [in] Pointer to the memory to be resized
+ * @param size          [in] New size of the memory (in bytes)
+ * @param mem_type      [in] Allocation location of symmetric memory (Host/Device)
+ * @return Pointer to the resized memory, or NULL on failure, in which case <i>ptr</i> is left untouched
+ */
+ACLSHMEM_HOST_API void *aclshmemx_realloc(void *ptr, size_t size, aclshmem_mem_type_t mem_type = DEVICE_SIDE);
+
+/**
+ * @brief Allocates <i>count</i> blocks of symmetric memory with a single control barrier. The data is uninitialized.
+ *        All PEs must pass the same <i>count</i> and <i>sizes</i>.
+ *
+ * @param sizes         [in] Memory allocation size of each block (in bytes)
+ * @param count         [in] Number of blocks to allocate
+ * @param ptrs          [out] Pointers to the allocated blocks, all set to NULL on failure
+ * @param mem_type      [in] Allocation location of symmetric memory (Host/Device)
+ * @return Returns 0 on success or an error code on failure
+ */
+ACLSHMEM_HOST_API int32_t aclshmemx_malloc_batch(const size_t *sizes, size_t count, void **ptrs,
+                                                 aclshmem_mem_type_t mem_type = DEVICE_SIDE);
+
+/**
+ * @brief Frees <i>count</i> blocks of symmetric memory with a single control barrier. NULL entries are skipped.
+ *
+ * @param ptrs          [in] Pointers to the memory to be freed
+ * @param count         [in] Number of pointers
+ * @param mem_type      [in] Allocation location of the symmetric memory (Host/Device)
+ */
+ACLSHMEM_HOST_API void aclshmemx_free_batch(void **ptrs, size_t count, aclshmem_mem_type_t mem_type = DEVICE_SIDE);
+
+/**
+ * @brief Queues <i>ptr</i> to be freed after the next control barrier, e.g. the one run by the next
+ *        <b>aclshmem_malloc()</b> or <b>aclshmem_free()</b>. No barrier is run by this call itself.
+ *        All PEs must queue the same pointers in the same order.
+ *
+ * @param ptr           [in] Pointer to the memory to be freed, NULL is ignored
+ * @param mem_type      [in] Allocation location of the symmetric memory (Host/Device)
+ */
+ACLSHMEM_HOST_API void aclshmemx_free_deferred(void *ptr, aclshmem_mem_type_t mem_type = DEVICE_SIDE);
+
+/**
+ * @brief Reads usage and fragmentation statistics of the local symmetric heap. The statistics are maintained on
+ *        every allocation and release, so this call does not walk the heap. A request of <i>size</i> bytes can only
+ *        succeed if it is not larger than <i>largest_free_block</i>; free_bytes much larger than
+ *        largest_free_block means the heap is fragmented rather than exhausted.
+ *
+ * @param stats         [out] Statistics of the heap
+ * @param mem_type      [in] Allocation location of symmetric memory (Host/Device)
+ * @return Returns 0 on success or an error code on failure
+ */
+ACLSHMEM_HOST_API int32_t aclshmemx_heap_stats(aclshmemx_heap_stats_t *stats,
+                                               aclshmem_mem_type_t mem_type = DEVICE_SIDE);
+
 /**
  * @brief Returns the start address (heap_base) of the local symmetric memory heap.
  *        If <i>mem_type</i> is DEVICE_SIDE, returns the device heap base address.
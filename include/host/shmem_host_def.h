@@ -70,6 +70,10 @@ constexpr int DEFAULT_TIMEOUT = 120;
 /// \brief Maximum length of the IP and port string in ACLSHMEM (including null terminator)
 #define ACLSHMEM_MAX_IP_PORT_LEN 64
 
+/// \def ACLSHMEM_HEAP_STATS_BUCKET_NUM
+/// \brief Number of power-of-two buckets in the free block histogram of aclshmemx_heap_stats_t
+#define ACLSHMEM_HEAP_STATS_BUCKET_NUM 32
+
 /**@} */  // end of group_macros
 
 /**
@@ -133,6 +137,15 @@ enum aclshmem_transport_t : uint8_t {
 };
 #define shmem_transport_t aclshmem_transport_t
 
+/**
+ * @brief Connection topology of the config store used by the bootstrap.
+*/
+enum aclshmemx_store_topology_t : uint8_t {
+    ACLSHMEMX_STORE_TOPOLOGY_FLAT = 0,        ///< Every pe connects to the store server of pe 0.
+    ACLSHMEMX_STORE_TOPOLOGY_NODE_RELAY = 1,  ///< The lowest pe of each host relays barrier and allgather of its host.
+};
+#define shmemx_store_topology_t aclshmemx_store_topology_t
+
 /**@} */  // end of group_enums
 
 /**
@@ -172,6 +185,10 @@ typedef struct {
  * - uint64_t local_mem_size: The size of shared memory currently occupied by current pe.
  * - aclshmem_init_optional_attr_t option_attr: Optional Parameters.
  * - void *comm_args: Parameters required for communication during the bootstrap phase when initializing different flags.
+ * - aclshmemx_store_topology_t store_topology: Connection topology of the config store bootstrap, flat by default.
+ *   With ACLSHMEMX_STORE_TOPOLOGY_NODE_RELAY the pes of one host meet on a local relay first and only the relay
+ *   talks to pe 0 for barrier and allgather. Every pe still keeps its own connection to pe 0 for the other
+ *   bootstrap collectives.
 */
 typedef struct aclshmemx_init_attr_t {
     int my_pe;
@@ -181,6 +198,7 @@ typedef struct aclshmemx_init_attr_t {
     aclshmem_init_optional_attr_t option_attr = {(1 << 16) + sizeof(aclshmem_init_optional_attr_t), ACLSHMEM_DATA_OP_MTE, DEFAULT_TIMEOUT, DEFAULT_TIMEOUT, DEFAULT_TIMEOUT};
     void *comm_args = nullptr;
     uint64_t instance_id = 0;
+    aclshmemx_store_topology_t store_topology = ACLSHMEMX_STORE_TOPOLOGY_FLAT;
 } aclshmemx_init_attr_t;
 #define shmem_init_attr_t aclshmemx_init_attr_t
 
@@ -202,6 +220,33 @@ typedef struct {
 } aclshmemx_uniqueid_t;
 #define shmem_uniqueid_t aclshmemx_uniqueid_t
 
+/**
+ * @struct aclshmemx_heap_stats_t
+ * @brief Usage and fragmentation statistics of a symmetric heap, see aclshmemx_heap_stats.
+ *
+ * - uint64_t total_bytes: Size of the symmetric heap.
+ * - uint64_t used_bytes: Bytes held by live allocations, after rounding to the allocator granularity.
+ * - uint64_t free_bytes: total_bytes - used_bytes, including free slots inside small-block spans.
+ * - uint64_t largest_free_block: Largest contiguous free block, the biggest allocation that can succeed.
+ * - uint64_t free_block_count: Number of contiguous free blocks.
+ * - uint64_t high_water_mark: Maximum of used_bytes since the heap was created.
+ * - uint64_t allocated_blocks: Number of live allocations.
+ * - uint64_t slab_bytes: Bytes carved into spans which serve allocations of at most 64KiB.
+ * - uint64_t free_block_histogram[ACLSHMEM_HEAP_STATS_BUCKET_NUM]: Free block count per size class, bucket i
+ *   counts blocks of [2^(i+6), 2^(i+7)) bytes, the first and last buckets also count smaller and larger blocks.
+*/
+typedef struct {
+    uint64_t total_bytes;
+    uint64_t used_bytes;
+    uint64_t free_bytes;
+    uint64_t largest_free_block;
+    uint64_t free_block_count;
+    uint64_t high_water_mark;
+    uint64_t allocated_blocks;
+    uint64_t slab_bytes;
+    uint64_t free_block_histogram[ACLSHMEM_HEAP_STATS_BUCKET_NUM];
+} aclshmemx_heap_stats_t;
+
 /**@} */  // end of group_structs
 
 /**
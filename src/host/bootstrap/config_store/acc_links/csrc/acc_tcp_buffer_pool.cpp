@@ -0,0 +1,216 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+#include <algorithm>
+#include <new>
+
+#include "acc_tcp_buffer_pool.h"
+
+namespace shm {
+namespace acc {
+struct AccBufferPool::ThreadCache {
+    explicit ThreadCache(bool &destroyed) : destroyed_{destroyed} {}
+
+    /* a thread going away hands its blocks to the other threads */
+    ~ThreadCache()
+    {
+        destroyed_ = true;
+        auto &pool = AccBufferPool::Instance();
+        for (uint32_t cls = 0; cls < CLASS_COUNT; cls++) {
+            for (auto ptr : blocks[cls]) {
+                pool.PutShared(cls, ptr);
+            }
+        }
+    }
+
+    /* a trim since the last use leaves the blocks of this thread to the process */
+    void Drop(AccBufferPool &pool)
+    {
+        for (uint32_t cls = 0; cls < CLASS_COUNT; cls++) {
+            std::vector<uint8_t *> dropped;
+            dropped.swap(blocks[cls]);
+            for (auto ptr : dropped) {
+                pool.Release(cls, ptr);
+            }
+        }
+    }
+
+    std::array<std::vector<uint8_t *>, CLASS_COUNT> blocks;
+    uint64_t generation = 0;
+    bool &destroyed_;
+};
+
+AccBufferPool &AccBufferPool::Instance() noexcept
+{
+    /* never destroyed, buffers may still be released by static objects at exit */
+    static auto *pool = new AccBufferPool();
+    return *pool;
+}
+
+uint32_t AccBufferPool::ClassOf(uint32_t size) noexcept
+{
+    if (size <= (1U << MIN_CLASS_BITS)) {
+        return 0;
+    }
+    auto bits = static_cast<uint32_t>(32 - __builtin_clz(size - 1U));
+    return bits - MIN_CLASS_BITS;
+}
+
+uint32_t AccBufferPool::ClassSize(uint32_t cls) noexcept
+{
+    return 1U << (MIN_CLASS_BITS + cls);
+}
+
+uint64_t AccBufferPool::ClassLimit(uint64_t bytes, uint32_t cls) noexcept
+{
+    return std::max<uint64_t>(MIN_CACHED_BLOCKS, bytes / ClassSize(cls));
+}
+
+AccBufferPool::ThreadCache *AccBufferPool::LocalCache() noexcept
+{
+    static thread_local bool destroyed = false;
+    if (destroyed) {
+        return nullptr;
+    }
+    static thread_local ThreadCache cache{destroyed};
+    auto &pool = Instance();
+    auto generation = pool.generation_.load(std::memory_order_acquire);
+    if (cache.generation != generation) {
+        cache.Drop(pool);
+        cache.generation = generation;
+    }
+    return &cache;
+}
+
+uint8_t *AccBufferPool::Alloc(uint32_t size, uint32_t &capacity) noexcept
+{
+    if (size > MAX_POOLED_SIZE) {
+        capacity = size;
+        heapAllocCount_.fetch_add(1U, std::memory_order_relaxed);
+        return new (std::nothrow) uint8_t[size];
+    }
+
+    auto cls = ClassOf(size);
+    capacity = ClassSize(cls);
+    allocCount_.fetch_add(1U, std::memory_order_relaxed);
+    uint8_t *ptr = nullptr;
+    auto cache = LocalCache();
+    if (cache != nullptr && !cache->blocks[cls].empty()) {
+        ptr = cache->blocks[cls].back();
+        cache->blocks[cls].pop_back();
+    } else {
+        ptr = TakeShared(cls);
+    }
+
+    if (ptr != nullptr) {
+        hitCount_.fetch_add(1U, std::memory_order_relaxed);
+        cachedBytes_.fetch_sub(capacity, std::memory_order_relaxed);
+        cachedBuffers_.fetch_sub(1U, std::memory_order_relaxed);
+        return ptr;
+    }
+    heapAllocCount_.fetch_add(1U, std::memory_order_relaxed);
+    return new (std::nothrow) uint8_t[capacity];
+}
+
+void AccBufferPool::Free(uint8_t *ptr, uint32_t capacity) noexcept
+{
+    if (ptr == nullptr) {
+        return;
+    }
+    if (capacity > MAX_POOLED_SIZE || servers_.load(std::memory_order_relaxed) == 0) {
+        delete[] ptr;
+        return;
+    }
+
+    auto cls = ClassOf(capacity);
+    cachedBytes_.fetch_add(ClassSize(cls), std::memory_order_relaxed);
+    cachedBuffers_.fetch_add(1U, std::memory_order_relaxed);
+    auto cache = LocalCache();
+    if (cache != nullptr && cache->blocks[cls].size() < ClassLimit(THREAD_CACHE_BYTES, cls)) {
+        cache->blocks[cls].push_back(ptr);
+        return;
+    }
+    PutShared(cls, ptr);
+}
+
+uint8_t *AccBufferPool::TakeShared(uint32_t cls) noexcept
+{
+    auto &list = shared_[cls];
+    std::lock_guard<std::mutex> guard(list.mutex);
+    if (list.blocks.empty()) {
+        return nullptr;
+    }
+    auto ptr = list.blocks.back();
+    list.blocks.pop_back();
+    return ptr;
+}
+
+void AccBufferPool::PutShared(uint32_t cls, uint8_t *ptr) noexcept
+{
+    auto &list = shared_[cls];
+    {
+        std::lock_guard<std::mutex> guard(list.mutex);
+        if (list.blocks.size() < ClassLimit(SHARED_CACHE_BYTES, cls) &&
+            servers_.load(std::memory_order_relaxed) != 0) {
+            list.blocks.push_back(ptr);
+            return;
+        }
+    }
+    /* both caches are full or no server runs, the block goes back to the process */
+    Release(cls, ptr);
+}
+
+void AccBufferPool::Release(uint32_t cls, uint8_t *ptr) noexcept
+{
+    cachedBytes_.fetch_sub(ClassSize(cls), std::memory_order_relaxed);
+    cachedBuffers_.fetch_sub(1U, std::memory_order_relaxed);
+    delete[] ptr;
+}
+
+void AccBufferPool::ServerStarted() noexcept
+{
+    servers_.fetch_add(1U, std::memory_order_relaxed);
+}
+
+void AccBufferPool::ServerStopped() noexcept
+{
+    if (servers_.fetch_sub(1U, std::memory_order_relaxed) == 1U) {
+        Trim();
+    }
+}
+
+/* threads still alive drop their caches on their next use, the stopping thread does it right away */
+void AccBufferPool::Trim() noexcept
+{
+    generation_.fetch_add(1U, std::memory_order_acq_rel);
+    for (uint32_t cls = 0; cls < CLASS_COUNT; cls++) {
+        std::vector<uint8_t *> dropped;
+        {
+            std::lock_guard<std::mutex> guard(shared_[cls].mutex);
+            dropped.swap(shared_[cls].blocks);
+        }
+        for (auto ptr : dropped) {
+            Release(cls, ptr);
+        }
+    }
+    (void)LocalCache();
+}
+
+AccBufferPoolStats AccBufferPool::Stats() const noexcept
+{
+    AccBufferPoolStats stats;
+    stats.allocCount = allocCount_.load(std::memory_order_relaxed);
+    stats.hitCount = hitCount_.load(std::memory_order_relaxed);
+    stats.heapAllocCount = heapAllocCount_.load(std::memory_order_relaxed);
+    stats.cachedBytes = cachedBytes_.load(std::memory_order_relaxed);
+    stats.cachedBuffers = cachedBuffers_.load(std::memory_order_relaxed);
+    return stats;
+}
+}  // namespace acc
+}  // namespace shm
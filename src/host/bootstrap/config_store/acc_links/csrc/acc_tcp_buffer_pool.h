@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+#ifndef ACC_LINKS_ACC_TCP_BUFFER_POOL_H
+#define ACC_LINKS_ACC_TCP_BUFFER_POOL_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "acc_def.h"
+
+namespace shm {
+namespace acc {
+/**
+ * @brief Process wide pool recycling the memory of message buffers in power of two size classes from 64B to 64KB.
+ * Every thread, i.e. every worker, keeps a small cache per class and only goes to the shared lists under lock when
+ * its own cache is empty or full, so a buffer allocated on one worker and released on another still gets reused.
+ * Larger sizes go to the process allocator directly.
+ * The pool holds at most SHARED_CACHE_BYTES per class plus THREAD_CACHE_BYTES per class of each thread, and gives all
+ * of it back once the last server of the process stops; while no server runs released blocks are not cached.
+ */
+class AccBufferPool {
+public:
+    static AccBufferPool &Instance() noexcept;
+
+    /**
+     * @brief Allocate a block of at least size bytes
+     *
+     * @param size         [in] size demanded
+     * @param capacity     [out] real size of the block, to be passed back to Free
+     * @return block, nullptr if out of memory
+     */
+    uint8_t *Alloc(uint32_t size, uint32_t &capacity) noexcept;
+
+    /**
+     * @brief Give a block back to the pool
+     *
+     * @param ptr          [in] block from Alloc
+     * @param capacity     [in] capacity returned by Alloc, or the size demanded
+     */
+    void Free(uint8_t *ptr, uint32_t capacity) noexcept;
+
+    AccBufferPoolStats Stats() const noexcept;
+
+    /**
+     * @brief Count a started server, blocks are cached while any server runs
+     */
+    void ServerStarted() noexcept;
+
+    /**
+     * @brief Count a stopped server, the last one drops every cached block
+     */
+    void ServerStopped() noexcept;
+
+private:
+    static constexpr uint32_t MIN_CLASS_BITS = 6U;
+    static constexpr uint32_t CLASS_COUNT = 11U;
+    static constexpr uint32_t MAX_POOLED_SIZE = 1U << (MIN_CLASS_BITS + CLASS_COUNT - 1U);
+    static constexpr uint64_t THREAD_CACHE_BYTES = 64ULL * 1024U; /* per class of each thread */
+    static constexpr uint64_t SHARED_CACHE_BYTES = 1024ULL * 1024U; /* per class of the process */
+    static constexpr uint64_t MIN_CACHED_BLOCKS = 4U; /* kept per class even for the largest one */
+
+    struct ThreadCache;
+    struct SharedList {
+        std::mutex mutex;
+        std::vector<uint8_t *> blocks;
+    };
+
+    AccBufferPool() = default;
+    static uint32_t ClassOf(uint32_t size) noexcept;
+    static uint32_t ClassSize(uint32_t cls) noexcept;
+    static uint64_t ClassLimit(uint64_t bytes, uint32_t cls) noexcept;
+    static ThreadCache *LocalCache() noexcept;
+    uint8_t *TakeShared(uint32_t cls) noexcept;
+    void PutShared(uint32_t cls, uint8_t *ptr) noexcept;
+    void Release(uint32_t cls, uint8_t *ptr) noexcept;
+    void Trim() noexcept;
+
+    std::array<SharedList, CLASS_COUNT> shared_;
+    std::atomic<uint64_t> allocCount_{0};
+    std::atomic<uint64_t> hitCount_{0};
+    std::atomic<uint64_t> heapAllocCount_{0};
+    std::atomic<uint64_t> cachedBytes_{0};
+    std::atomic<uint64_t> cachedBuffers_{0};
+    std::atomic<uint32_t> servers_{0};
+    std::atomic<uint64_t> generation_{0}; /* bumped by every trim, thread caches of an older one are dropped */
+};
+}  // namespace acc
+}  // namespace shm
+
+#endif  // ACC_LINKS_ACC_TCP_BUFFER_POOL_H
@@ -30,6 +30,8 @@ namespace acc {
  */
 struct AccTcpWorkerOptions {
     uint16_t pollingTimeoutMs = UNO_500; /* poll/epoll timeout */
+    uint16_t pollBatchMax = UNO_1024;    /* max events of one epoll wait */
+    uint32_t busyPollUs = 0;             /* spin time after the last event, 0 is off */
     uint16_t index = 0;                  /* index of the worker */
     int16_t cpuId = -1;                  /* cpu id for bounding */
     int16_t threadPriority = -1;         /* thread nice */
@@ -39,7 +41,8 @@ struct AccTcpWorkerOptions {
     {
         std::ostringstream oss;
         oss << "name " << name_ << ", index " << index << ", cpu " << cpuId << ", thread-priority " << threadPriority
-            << ", poll-timeout-ms " << pollingTimeoutMs;
+            << ", poll-timeout-ms " << pollingTimeoutMs << ", poll-batch-max " << pollBatchMax << ", busy-poll-us "
+            << busyPollUs;
         return oss.str();
     }
 
@@ -24,6 +24,11 @@ Result AccTcpLinkComplexDefault::Initialize(uint16_t sendQueueCap, int32_t workI
     ASSERT_RETURN(data_.Get() != nullptr, ACC_NEW_OBJECT_FAIL);
     ASSERT_RETURN(data_->DataPtr() != nullptr, ACC_NEW_OBJECT_FAIL);
 
+    readAhead_ = AccDataBuffer::Create(ACC_READ_AHEAD_SIZE);
+    ASSERT_RETURN(readAhead_.Get() != nullptr, ACC_NEW_OBJECT_FAIL);
+    readAheadBegin_ = 0;
+    readAheadEnd_ = 0;
+
     header_ = AccMsgHeader();
     receiveState_ = AccLinkReceiveState();
 
@@ -39,6 +44,7 @@ void AccTcpLinkComplexDefault::UnInitialize()
 {
     queue_ = nullptr;
     data_ = nullptr;
+    readAhead_ = nullptr;
     if (worker_ != nullptr) {
         worker_->DecreaseRef();
         worker_ = nullptr;
@@ -48,13 +54,22 @@ Result AccTcpLinkComplexDefault::EnqueueAndModifyEpoll(const AccMsgHeader &h, co
                                                        const AccDataBufferPtr &cbCtx)
 {
     ASSERT_RETURN(worker_ != nullptr, ACC_ERROR);
-    auto result = queue_->EnqueueBack(h, d, cbCtx);
+    bool wasEmpty = false;
+    auto result = queue_->EnqueueBack(h, d, cbCtx, &wasEmpty);
     if (UNLIKELY(result != ACC_OK)) {
         LOG_WARN("Failed to enqueue message into link " << this->id_ << ", errorCode:" << result
                                                         << ", queue size:" << queue_->GetSize());
         return result;
     }
 
+    /* messages queued before have the worker sending already, it takes this one along */
+    if (!wasEmpty) {
+        return ACC_OK;
+    }
+
+    if (worker_->RequestFlush(this)) {
+        return ACC_OK;
+    }
     return worker_->ModifyLink(this, POLLIN | POLLOUT | EPOLLET);
 }
 }  // namespace acc
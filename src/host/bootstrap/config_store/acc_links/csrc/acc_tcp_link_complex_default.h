@@ -10,6 +10,8 @@
 #ifndef ACC_LINKS_ACC_TCP_LINK_COMPLEX_DEFAULT_H
 #define ACC_LINKS_ACC_TCP_LINK_COMPLEX_DEFAULT_H
 
+#include <algorithm>
+#include <cstring>
 #include <list>
 
 #include "acc_tcp_link_default.h"
@@ -18,6 +20,9 @@ namespace shm {
 namespace acc {
 class AccTcpWorker;
 
+constexpr uint32_t ACC_SEND_BATCH_SIZE = UNO_32; /* messages gathered into one writev, two iovecs each */
+constexpr uint32_t ACC_READ_AHEAD_SIZE = 4U * UNO_1024; /* bytes one recv may pull ahead of the current message */
+
 /**
  * @brief Message node of message queue
  */
@@ -71,6 +76,16 @@ struct AccLinkedMessageNode {
         dataRemain -= size;
         return false;
     }
+
+    /* account written bytes to the header first then the data, returns the bytes taken by this message */
+    inline uint64_t Advance(uint64_t size)
+    {
+        auto headerPart = std::min<uint64_t>(size, headerRemain);
+        headerRemain -= static_cast<uint32_t>(headerPart);
+        auto dataPart = std::min<uint64_t>(size - headerPart, dataRemain);
+        dataRemain -= static_cast<uint32_t>(dataPart);
+        return headerPart + dataPart;
+    }
 };
 
 /**
@@ -116,9 +131,11 @@ public:
      *
      * @param h            [in] header
      * @param d            [in] data buffer ptr
+     * @param wasEmpty     [out] optional, whether the queue was empty before
      * @return 0 if successful, ACC_QUEUE_IS_FULL if full
      */
-    Result EnqueueBack(const AccMsgHeader& h, const AccDataBufferPtr& d, const AccDataBufferPtr& cbCtx)
+    Result EnqueueBack(const AccMsgHeader& h, const AccDataBufferPtr& d, const AccDataBufferPtr& cbCtx,
+                       bool* wasEmpty = nullptr)
     {
         ASSERT_RETURN(d.Get() != nullptr, ACC_INVALID_PARAM);
 
@@ -136,6 +153,10 @@ public:
                 return ACC_QUEUE_IS_FULL;
             }
 
+            if (wasEmpty != nullptr) {
+                *wasEmpty = headNode_ == nullptr;
+            }
+
             /* if the empty */
             if (headNode_ == nullptr) {
                 headNode_ = tmpNode;
@@ -181,6 +202,61 @@ public:
         return tmpNode;
     }
 
+    /**
+     * @brief Dequeue up to maxCount nodes from front as one chain, next of the last node is cleared
+     *
+     * @param maxCount     [in] max number of nodes to take
+     * @param last         [out] last node of the chain
+     * @param count        [out] number of nodes taken
+     * @return first node of the chain, nullptr if empty
+     */
+    AccLinkedMessageNode* DequeueFront(uint32_t maxCount, AccLinkedMessageNode*& last, uint32_t& count)
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        count = 0;
+        last = nullptr;
+        if (headNode_ == nullptr || maxCount == 0) {
+            return nullptr;
+        }
+
+        auto first = headNode_;
+        last = first;
+        count = 1;
+        while (count < maxCount && last->next != nullptr) {
+            last = last->next;
+            ++count;
+        }
+        headNode_ = last->next;
+        if (headNode_ == nullptr) {
+            tailNode_ = nullptr;
+        }
+        last->next = nullptr;
+        size_ -= count;
+        return first;
+    }
+
+    /**
+     * @brief Push a chain of nodes back on front place keeping its order, ignore the cap
+     *
+     * @param first        [in] first node of the chain
+     * @param last         [in] last node of the chain
+     * @param count        [in] number of nodes in the chain
+     * @return 0 if successful
+     */
+    Result EnqueueFront(AccLinkedMessageNode* first, AccLinkedMessageNode* last, uint32_t count)
+    {
+        ASSERT_RETURN(first != nullptr && last != nullptr, ACC_INVALID_PARAM);
+
+        std::lock_guard<std::mutex> guard(mutex_);
+        last->next = headNode_;
+        headNode_ = first;
+        if (tailNode_ == nullptr) {
+            tailNode_ = last;
+        }
+        size_ += count;
+        return ACC_OK;
+    }
+
     /**
      * @brief Push a node back on front place, ignore the cap
      *
@@ -264,15 +340,20 @@ protected:
     AccLinkedMessageNode* TakeAwayMessages();
 
     ssize_t PollInRecv(void* ptr, ssize_t len) noexcept;
-    ssize_t PollOutWrite(void* ptr, ssize_t len) noexcept;
+    Result PollInRecvPostProcess(ssize_t result, const char* part) noexcept;
+    Result FillReadAhead() noexcept;
+    ssize_t PollOutWriteV(struct iovec* iov, int32_t count) noexcept;
     Result HandlePollIn() noexcept;
-    Result HandlePollOut(AccMsgHeader& header, AccDataBufferPtr& cbCtx) noexcept;
+    Result HandlePollOut(const AccReqSentHandler& sentHandle) noexcept;
     Result SendPostProcess(int32_t errorNumber) noexcept;
 
 protected:
     AccLinkReceiveState receiveState_{};      /* state of receiving message for worker polling only */
     AccMsgHeader header_{};                   /* header to be received for worker polling only */
     AccDataBufferPtr data_{nullptr};          /* data being received for worker polling only */
+    AccDataBufferPtr readAhead_{nullptr};     /* bytes received but not parsed yet for worker polling only */
+    uint32_t readAheadBegin_ = 0;             /* first unparsed byte in readAhead_ */
+    uint32_t readAheadEnd_ = 0;               /* end of received bytes in readAhead_ */
     AccLinkedMessageQueuePtr queue_{nullptr}; /* send message queue */
     std::atomic<uint32_t> seqNo_{0};          /* seqNo */
     uint32_t workerIndex_ = 0;                /* attached to which worker */
@@ -302,148 +383,201 @@ inline AccLinkedMessageNode* AccTcpLinkComplexDefault::TakeAwayMessages()
     return queue_->TakeAwayMessages();
 }
 
+/*
+ * the link socket is in blocking mode and HandlePollIn reads until it runs dry, so never wait here:
+ * plain recv doesn't wait, ssl read only starts when the socket has bytes or is closed by peer
+ */
 inline ssize_t AccTcpLinkComplexDefault::PollInRecv(void* ptr, ssize_t len) noexcept
 {
     if (LIKELY(ssl_ == nullptr)) {
-        return ::recv(fd_, ptr, len, 0);
-    } else {
-        return OpenSslApiWrapper::SslRead(ssl_, ptr, len);
+        return ::recv(fd_, ptr, len, MSG_DONTWAIT);
     }
+
+    char peek = 0;
+    if (::recv(fd_, &peek, sizeof(peek), MSG_PEEK | MSG_DONTWAIT) < 0) {
+        return -1;
+    }
+    return OpenSslApiWrapper::SslRead(ssl_, ptr, len);
 }
 
-inline ssize_t AccTcpLinkComplexDefault::PollOutWrite(void* ptr, ssize_t len) noexcept
+inline ssize_t AccTcpLinkComplexDefault::PollOutWriteV(struct iovec* iov, int32_t count) noexcept
 {
     if (LIKELY(ssl_ == nullptr)) {
-        return ::write(fd_, ptr, len);
-    } else {
-        return OpenSslApiWrapper::SslWrite(ssl_, ptr, len);
+        return ::writev(fd_, iov, count);
+    }
+
+    /* no scatter write for ssl, write the pieces in order and stop at the first short one */
+    ssize_t total = 0;
+    for (int32_t i = 0; i < count; i++) {
+        auto result = OpenSslApiWrapper::SslWrite(ssl_, iov[i].iov_base, static_cast<int>(iov[i].iov_len));
+        if (result <= 0) {
+            return total > 0 ? total : result;
+        }
+        total += result;
+        if (static_cast<size_t>(result) < iov[i].iov_len) {
+            break;
+        }
     }
+    return total;
 }
 
+inline Result AccTcpLinkComplexDefault::PollInRecvPostProcess(ssize_t result, const char* part) noexcept
+{
+    if (LIKELY(result > 0)) {
+        return ACC_OK;
+    }
+
+    /* ECONNRESET is broken during io, 0 bytes is broken during idle time, errno of it may be left by an earlier call */
+    const auto errorNumber = errno; // avoid errno writed by log
+    if (result == 0 || errorNumber == ECONNRESET) {
+        LOG_WARN("Link " << id_ << " receive " << part << " failed, reset by peer, errno " << errorNumber);
+        return ACC_LINK_ERROR; /* socket is closed by peer, socket is error */
+    }
+    /* if errno is eagain is normal, need to continue to receive */
+    /* else meaning failed to read from socket, socket is error */
+    if (errorNumber != EAGAIN) {
+        LOG_ERROR("Link " << id_ << " receive " << part << " failed, errno " << errorNumber);
+    }
+
+    return (errorNumber == EAGAIN ? ACC_LINK_EAGAIN : ACC_LINK_ERROR);
+}
+
+/* called once every buffered byte is parsed, pulls as much as the socket has up to the buffer size */
+inline Result AccTcpLinkComplexDefault::FillReadAhead() noexcept
+{
+    readAheadBegin_ = 0;
+    readAheadEnd_ = 0;
+    auto result = PollInRecv(readAhead_->DataPtrVoid(), ACC_READ_AHEAD_SIZE);
+    if (LIKELY(result > 0)) {
+        readAheadEnd_ = static_cast<uint32_t>(result);
+    }
+    return PollInRecvPostProcess(result, "data");
+}
+
+/*
+ * parse one message out of the read-ahead buffer, refilling it when it runs dry. A burst of pipelined messages
+ * costs one recv for all of them, the worker calls this again until it stops returning ACC_LINK_MSG_READY.
+ * A body larger than the buffer is received straight into data_ after its buffered head
+ */
 inline Result AccTcpLinkComplexDefault::HandlePollIn() noexcept
 {
     const auto headDataPtr = reinterpret_cast<uintptr_t>(&header_);
+    const auto readAheadPtr = readAhead_->DataPtr();
 
     /* receive header */
-    ssize_t result = 0;
-    if (receiveState_.ShouldReceiveHeader()) {
-        result = PollInRecv(
-            reinterpret_cast<void*>(headDataPtr + receiveState_.ReceivedHeaderLen()), receiveState_.headerToBeReceived);
-        if (LIKELY((result) > 0)) {
-            if (receiveState_.HeaderSatisfied(result)) { /* header is full, continue to receive body */
-                // validate header
-                if (UNLIKELY(!data_->AllocIfNeed(header_.bodyLen))) {
-                    LOG_ERROR("Failed to expand receive buffer to " << header_.bodyLen << ", probably out of memory");
-                    receiveState_.ResetHeader();
-                    return ACC_MALLOC_FAIL;
-                }
-                receiveState_.bodyToBeReceived = header_.bodyLen; /* expand memory size */
-                data_->SetDataSize(0);
-            } else { /* header is not fully, need to continue to receive */
-                return ACC_LINK_EAGAIN;
+    while (receiveState_.ShouldReceiveHeader()) {
+        if (readAheadBegin_ == readAheadEnd_) {
+            auto result = FillReadAhead();
+            if (result != ACC_OK) {
+                return result;
             }
-        } else {                            /* ECONNRESET is broken during io, SUCCESS is broken during idle time. */
-            const auto errorNumber = errno; // avoid errno writed by log
-            if (errorNumber == ECONNRESET || errorNumber == 0) {
-                LOG_WARN("Link " << id_ << " receive header failed, reset by peer, errno " << errorNumber);
-                return ACC_LINK_ERROR; /* socket is closed by peer, socket is error */
-            }
-            /* if errno is eagain is normal, need to continue to receive */
-            /* else meaning failed to read from socket, socket is error */
-            if (errorNumber != EAGAIN) {
-                LOG_ERROR("Link " << id_ << " receive header failed, errno " << errorNumber);
+        }
+        auto size = std::min<uint32_t>(readAheadEnd_ - readAheadBegin_, receiveState_.headerToBeReceived);
+        (void)memcpy(reinterpret_cast<void*>(headDataPtr + receiveState_.ReceivedHeaderLen()),
+                     readAheadPtr + readAheadBegin_, size);
+        readAheadBegin_ += size;
+        if (receiveState_.HeaderSatisfied(static_cast<uint16_t>(size))) { /* header is full, go on with body */
+            // validate header
+            if (UNLIKELY(!data_->AllocIfNeed(header_.bodyLen))) {
+                LOG_ERROR("Failed to expand receive buffer to " << header_.bodyLen << ", probably out of memory");
+                receiveState_.ResetHeader();
+                return ACC_MALLOC_FAIL;
             }
-
-            return (errorNumber == EAGAIN ? ACC_LINK_EAGAIN : ACC_LINK_ERROR);
+            receiveState_.bodyToBeReceived = header_.bodyLen; /* expand memory size */
+            data_->SetDataSize(0);
         }
     }
 
-    /* receive body */
-    auto dataPtr = data_->DataIntPtr() + (header_.bodyLen - static_cast<size_t>(receiveState_.bodyToBeReceived));
-    result = PollInRecv(reinterpret_cast<void*>(dataPtr), receiveState_.bodyToBeReceived);
-    if (LIKELY((result) > 0)) {
-        if (receiveState_.BodySatisfied(result)) { /* body is full */
-            receiveState_.ResetHeader();
-            data_->SetDataSize(header_.bodyLen);
-            return ACC_LINK_MSG_READY; /* message fully received, we can do the upper call */
-        }
-
-        LOG_INFO("Receive sock " << id_ << " not full body size: " << receiveState_.bodyToBeReceived);
-        /* body is not fully received, continue to receive */
-        return ACC_LINK_EAGAIN;
-    } else {                            /* ECONNRESET is broken during io, SUCCESS is broken during idle time. */
-        const auto errorNumber = errno; // avoid errno writed by log
-        if (errorNumber == ECONNRESET || errorNumber == 0) {
-            LOG_INFO("Link " << id_ << " receive body failed, reset by peer, errno " << errorNumber);
-            return ACC_LINK_ERROR; /* socket is closed by peer, socket is error */
-        }
-        /* if errno is eagain is normal, need to continue to receive */
-        /* else meaning failed to read from socket,socket is error */
-        if (errorNumber != EAGAIN) {
-            LOG_ERROR("Link " << id_ << " receive body failed, errno " << errorNumber);
+    /* receive body, buffered bytes first */
+    while (receiveState_.bodyToBeReceived > 0) {
+        auto dataPtr = data_->DataPtr() + (header_.bodyLen - static_cast<size_t>(receiveState_.bodyToBeReceived));
+        if (readAheadBegin_ == readAheadEnd_) {
+            if (receiveState_.bodyToBeReceived >= static_cast<ssize_t>(ACC_READ_AHEAD_SIZE)) {
+                auto result = PollInRecv(dataPtr, receiveState_.bodyToBeReceived);
+                auto ret = PollInRecvPostProcess(result, "body");
+                if (ret != ACC_OK) {
+                    return ret;
+                }
+                receiveState_.BodySatisfied(result);
+                continue;
+            }
+            auto result = FillReadAhead();
+            if (result != ACC_OK) {
+                return result;
+            }
         }
-
-        return (errorNumber == EAGAIN ? ACC_LINK_EAGAIN : ACC_LINK_ERROR);
+        auto size = std::min<uint64_t>(readAheadEnd_ - readAheadBegin_, receiveState_.bodyToBeReceived);
+        (void)memcpy(dataPtr, readAheadPtr + readAheadBegin_, size);
+        readAheadBegin_ += static_cast<uint32_t>(size);
+        receiveState_.BodySatisfied(static_cast<ssize_t>(size));
     }
+
+    receiveState_.ResetHeader();
+    data_->SetDataSize(header_.bodyLen);
+    return ACC_LINK_MSG_READY; /* message fully received, we can do the upper call */
 }
 
-inline Result AccTcpLinkComplexDefault::HandlePollOut(AccMsgHeader& header, AccDataBufferPtr& cbCtx) noexcept
+/*
+ * drain the queue in batches, headers and bodies of a batch go out in one writev. Messages fully written are
+ * reported to sentHandle, a partially written one goes back to the front with the rest of its batch
+ */
+inline Result AccTcpLinkComplexDefault::HandlePollOut(const AccReqSentHandler& sentHandle) noexcept
 {
     ASSERT_RETURN(queue_.Get() != nullptr, ACC_NOT_INITIALIZED);
-    AccLinkedMessageNode* oneMsg = queue_->DequeueFront();
-    if (UNLIKELY(oneMsg == nullptr)) {
-        return ACC_OK;
-    }
+    struct iovec iov[ACC_SEND_BATCH_SIZE * UNO_2];
+    bool anySent = false;
+    while (true) {
+        AccLinkedMessageNode* last = nullptr;
+        uint32_t count = 0;
+        AccLinkedMessageNode* oneMsg = queue_->DequeueFront(ACC_SEND_BATCH_SIZE, last, count);
+        if (oneMsg == nullptr) {
+            return anySent ? ACC_LINK_MSG_SENT : ACC_OK;
+        }
 
-    ASSERT_RETURN(!oneMsg->Sent(), ACC_OK);
-    header = oneMsg->header;
-    cbCtx = oneMsg->cbCtx;
-
-    /* send header if not sent */
-    if (!oneMsg->HeaderSent()) {
-        auto result = PollOutWrite(oneMsg->HeaderPtrToBeSend(), oneMsg->headerRemain);
-        if (LIKELY(result > 0)) {
-            if (!oneMsg->HeaderAllSent(result)) { /* not all sent */
-                queue_->EnqueueFront(oneMsg);
-                return ACC_LINK_EAGAIN;
+        int32_t iovCount = 0;
+        for (auto node = oneMsg; node != nullptr; node = node->next) {
+            if (!node->HeaderSent()) {
+                iov[iovCount].iov_base = node->HeaderPtrToBeSend();
+                iov[iovCount++].iov_len = node->headerRemain;
             }
-            /* if no data body send finished */
-            if (oneMsg->DataSent()) {
-                delete oneMsg;
-                oneMsg = nullptr;
-                return ACC_LINK_MSG_SENT;
+            if (!node->DataSent()) {
+                iov[iovCount].iov_base = node->DataPtrToBeSend();
+                iov[iovCount++].iov_len = node->dataRemain;
             }
-
-            /* continue to send data part */
-        } else {
-            delete oneMsg;
-            oneMsg = nullptr;
-            return SendPostProcess(errno);
         }
-    }
 
-    /* send data if not sent */
-    if (!oneMsg->DataSent()) {
-        auto result = PollOutWrite(oneMsg->DataPtrToBeSend(), oneMsg->dataRemain);
-        if (LIKELY(result > 0)) {
-            if (!oneMsg->DataAllSent(result)) { /* not all sent */
-                queue_->EnqueueFront(oneMsg);
-                return ACC_LINK_EAGAIN;
+        uint64_t written = 0;
+        if (LIKELY(iovCount > 0)) {
+            auto result = PollOutWriteV(iov, iovCount);
+            if (UNLIKELY(result <= 0)) {
+                const auto errorNumber = errno; // avoid errno writed by log
+                /* keep them queued, a broken link reports them to the upper layer */
+                queue_->EnqueueFront(oneMsg, last, count);
+                return SendPostProcess(errorNumber);
             }
+            written = static_cast<uint64_t>(result);
+        }
 
+        while (oneMsg != nullptr) {
+            written -= oneMsg->Advance(written);
+            if (!oneMsg->Sent()) {
+                break;
+            }
+            auto nextMsg = oneMsg->next;
+            if (sentHandle != nullptr) { /* call sent callback if set */
+                (void)sentHandle(MSG_SENT, oneMsg->header, oneMsg->cbCtx);
+            }
             delete oneMsg;
-            oneMsg = nullptr;
-            return ACC_LINK_MSG_SENT;
-        } else {
-            delete oneMsg;
-            oneMsg = nullptr;
-            return SendPostProcess(errno);
+            oneMsg = nextMsg;
+            --count;
+            anySent = true;
         }
-    }
 
-    delete oneMsg;
-    oneMsg = nullptr;
-    return ACC_OK;
+        if (oneMsg != nullptr) { /* not all sent, socket buffer is full */
+            queue_->EnqueueFront(oneMsg, last, count);
+            return ACC_LINK_EAGAIN;
+        }
+    }
 }
 
 inline Result AccTcpLinkComplexDefault::SendPostProcess(int32_t errorNumber) noexcept
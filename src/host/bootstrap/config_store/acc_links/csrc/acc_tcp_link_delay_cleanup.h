@@ -52,6 +52,7 @@ private:
     std::mutex mutex_;
     std::mutex queueMutex_;
     std::list<AccTcpLinkCleanupItem> queue_;
+    std::condition_variable queueCond_;
     std::atomic<bool> started_{false};
     std::atomic<bool> threadStarted_{ false };
     std::thread cleanupThread_;
@@ -99,6 +100,7 @@ inline void AccTcpLinkDelayCleanup::Stop(bool afterFork)
                 std::lock_guard<std::mutex> guardQueue(queueMutex_);
                 queue_.emplace_front(item);
             }
+            queueCond_.notify_one();
 
             cleanupThread_.join();
         }
@@ -118,7 +120,10 @@ inline void AccTcpLinkDelayCleanup::RunInThread(std::atomic<bool> *started)
     while (!stop) {
         auto gotItem = CheckAndPop(UNO_7, item);
         if (!gotItem) {
-            sleep(UNO_1);
+            /* a stop request is picked up at once instead of after the poll period */
+            std::unique_lock<std::mutex> lk(queueMutex_);
+            (void)queueCond_.wait_for(lk, std::chrono::seconds(UNO_1),
+                                      [this]() { return !queue_.empty() && queue_.front().stop; });
         } else if (item.stop) {
             stop = true;
         } else {
@@ -11,6 +11,7 @@
 
 #include <net/if.h>
 #include <netdb.h>
+#include <sys/eventfd.h>
 #include <sys/time.h>
 
 #include "acc_common_util.h"
@@ -94,7 +95,7 @@ Result AccTcpListener::BindAndListenSocket(int tmpFD, mf_sockaddr &addr) noexcep
     } else if (addr.type == IpV6) {
         result_bind = ::bind(tmpFD, reinterpret_cast<struct sockaddr *>(&addr.ip.ipv6), sizeof(addr.ip.ipv6));
     }
-    if (result_bind < 0 || ::listen(tmpFD, 200L) < 0) {
+    if (result_bind < 0 || ::listen(tmpFD, backlog_) < 0) {
         auto errorNum = errno;
         SafeCloseFd(tmpFD);
         if (errorNum == EADDRINUSE) {
@@ -147,6 +148,12 @@ Result AccTcpListener::Start() noexcept
                 LOG_ERROR("Failed to set reuse port of " << NameAndPort() << " as " << strerror(errno));
                 return ACC_ERROR;
             }
+            /* the other acceptors bind the port too, then kernel spreads new connections over the sockets */
+            if (acceptorCount_ > UNO_1 &&
+                ::setsockopt(tmpFD, SOL_SOCKET, SO_REUSEPORT, reinterpret_cast<void *>(&flags), sizeof(flags)) < 0) {
+                LOG_WARN("Failed to set SO_REUSEPORT of " << NameAndPort() << " as " << strerror(errno)
+                    << ", acceptors will share one socket");
+            }
         }
         if (addr.type == IpV4) {
             result_bind = ::bind(tmpFD, reinterpret_cast<struct sockaddr *>(&addr.ip.ipv4), sizeof(addr.ip.ipv4));
@@ -155,7 +162,7 @@ Result AccTcpListener::Start() noexcept
         }
         LOG_INFO("bind ip port success" << tmpFD);
     }
-    if (result_bind < 0 || ::listen(tmpFD, 200L) < 0) {
+    if (result_bind < 0 || ::listen(tmpFD, backlog_) < 0) {
         auto errorNum = errno;
         SafeCloseFd(tmpFD);
         if (errorNum == EADDRINUSE) {
@@ -168,42 +175,90 @@ Result AccTcpListener::Start() noexcept
         return ACC_ERROR;
     }
 
-    auto ret = StartAcceptThread();
+    listenFd_ = tmpFD;
+    OpenAcceptorSockets(addr);
+
+    auto ret = StartAcceptThreads();
     if (ret != ACC_OK) {
-        SafeCloseFd(tmpFD);
-        listenFd_ = -1;
+        Stop();
         return ret;
     }
 
-    listenFd_ = tmpFD;
+    started_ = true;
+    return ACC_OK;
+}
 
-    while (!threadStarted_.load()) {
-        usleep(100L);
+void AccTcpListener::OpenAcceptorSockets(mf_sockaddr &addr) noexcept
+{
+    int flags = 1;
+    socklen_t len = sizeof(flags);
+    bool reusable = ::getsockopt(listenFd_, SOL_SOCKET, SO_REUSEPORT, &flags, &len) == 0 && flags != 0;
+
+    acceptFds_.clear();
+    acceptFds_.push_back(listenFd_);
+    for (uint16_t i = 1; i < acceptorCount_; i++) {
+        int fd = -1;
+        if (reusable) {
+            fd = ::socket(addr.type == IpV6 ? AF_INET6 : AF_INET, SOCK_STREAM, 0);
+            flags = 1;
+            if (fd >= 0 &&
+                (::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<void *>(&flags), sizeof(flags)) < 0 ||
+                 ::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, reinterpret_cast<void *>(&flags), sizeof(flags)) < 0)) {
+                SafeCloseFd(fd);
+            }
+            if (fd >= 0 && BindAndListenSocket(fd, addr) != ACC_OK) {
+                fd = -1;
+            }
+        }
+        if (fd < 0) {
+            /* an applied fd or failed SO_REUSEPORT, the accept threads take turns on one socket */
+            LOG_INFO("Acceptor " << i << " of " << NameAndPort() << " shares listen fd " << listenFd_);
+            fd = listenFd_;
+        }
+        acceptFds_.push_back(fd);
     }
 
-    started_ = true;
-    return ACC_OK;
+    /* accept threads sharing a socket are all woken by poll, the ones losing the race must not block */
+    for (auto fd : acceptFds_) {
+        auto value = fcntl(fd, F_GETFL, 0);
+        if (value == -1 || fcntl(fd, F_SETFL, static_cast<uint32_t>(value) | O_NONBLOCK) == -1) {
+            LOG_WARN("Failed to set listen fd " << fd << " non-blocking, errno " << errno);
+        }
+    }
 }
 
-Result AccTcpListener::StartAcceptThread() noexcept
+Result AccTcpListener::StartAcceptThreads() noexcept
 {
-    threadStarted_.store(false);
-
-    try {
-        acceptThread_ = std::thread([this]() {
-            this->RunInThread();
-        });
-    } catch (const std::system_error& e) {
-        LOG_ERROR("Failed to create accept thread: " << e.what());
-        return ACC_ERROR;
-    } catch (...) {
-        LOG_ERROR("Unknown error creating accept thread");
+    threadsStarted_.store(0);
+    needStop_ = false;
+    stopFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (stopFd_ < 0) {
+        LOG_ERROR("Failed to create stop event fd of listener, errno " << errno);
         return ACC_ERROR;
     }
 
-    std::string thrName = "AccListener";
-    if (pthread_setname_np(acceptThread_.native_handle(), thrName.c_str()) != 0) {
-        LOG_WARN("Failed to set thread name of oob tcp server");
+    for (uint32_t i = 0; i < acceptFds_.size(); i++) {
+        auto fd = acceptFds_[i];
+        try {
+            acceptThreads_.emplace_back([this, fd]() {
+                this->RunInThread(fd);
+            });
+        } catch (const std::system_error& e) {
+            LOG_ERROR("Failed to create accept thread: " << e.what());
+            return ACC_ERROR;
+        } catch (...) {
+            LOG_ERROR("Unknown error creating accept thread");
+            return ACC_ERROR;
+        }
+
+        std::string thrName = "AccListener" + std::to_string(i);
+        if (pthread_setname_np(acceptThreads_.back().native_handle(), thrName.c_str()) != 0) {
+            LOG_WARN("Failed to set thread name of oob tcp server");
+        }
+    }
+
+    while (threadsStarted_.load() < acceptThreads_.size()) {
+        usleep(100L);
     }
 
     return ACC_OK;
@@ -211,42 +266,59 @@ Result AccTcpListener::StartAcceptThread() noexcept
 
 void AccTcpListener::Stop(bool afterFork) noexcept
 {
-    if (!started_) {
+    if (!started_ && acceptFds_.empty()) {
         return;
     }
 
     needStop_ = true;
-    if (acceptThread_.joinable()) {
+    /* don't wait for the poll timeout, a forked child shares the event fd and must leave the parent alone */
+    uint64_t one = 1;
+    if (!afterFork && stopFd_ != -1 && write(stopFd_, &one, sizeof(one)) != sizeof(one)) {
+        LOG_WARN("Failed to wake up accept threads, errno " << errno);
+    }
+    for (auto &thread : acceptThreads_) {
+        if (!thread.joinable()) {
+            continue;
+        }
         if (afterFork) {
-            acceptThread_.detach();
+            thread.detach();
         } else {
-            acceptThread_.join();
+            thread.join();
+        }
+    }
+    acceptThreads_.clear();
+    for (auto fd : acceptFds_) {
+        if (fd != listenFd_) {
+            SafeCloseFd(fd, !afterFork);
         }
     }
+    acceptFds_.clear();
     SafeCloseFd(listenFd_, !afterFork);
+    SafeCloseFd(stopFd_, false);
     started_ = false;
 }
 
-void AccTcpListener::RunInThread() noexcept
+void AccTcpListener::RunInThread(int listenFd) noexcept
 {
-    LOG_INFO("Acc listener accept thread for " << NameAndPort() << " start ...");
-    threadStarted_.store(true);
+    LOG_INFO("Acc listener accept thread for " << NameAndPort() << " on fd " << listenFd << " start ...");
+    threadsStarted_.fetch_add(1);
 
     while (!needStop_) {
         try {
-            struct pollfd pollEventFd = {};
-            pollEventFd.fd = listenFd_;
-            pollEventFd.events = POLLIN;
-            pollEventFd.revents = 0;
+            struct pollfd pollEventFds[UNO_2] = {};
+            pollEventFds[0].fd = listenFd;
+            pollEventFds[0].events = POLLIN;
+            pollEventFds[1].fd = stopFd_;
+            pollEventFds[1].events = POLLIN;
 
-            int rc = poll(&pollEventFd, 1, 500L);
+            int rc = poll(pollEventFds, UNO_2, 500L);
             if (rc < 0 && errno != EINTR) {
                 LOG_ERROR("Get poll event failed  , errno " << strerror(errno));
                 break;
             } else if (needStop_) {
                 LOG_WARN("Acc listener accept thread get stop signal, will exit...");
                 break;
-            } else if (rc == 0) {
+            } else if (rc <= 0 || (pollEventFds[0].revents & POLLIN) == 0) {
                 continue;
             }
 
@@ -254,13 +326,15 @@ void AccTcpListener::RunInThread() noexcept
             auto fd {-1};
             if (ipType_ == IpV6) {
                 socklen_t len = sizeof(sockaddr_in6);
-                fd = ::accept(listenFd_, reinterpret_cast<struct sockaddr *>(&addressIn.ip.ipv6), &len);
+                fd = ::accept(listenFd, reinterpret_cast<struct sockaddr *>(&addressIn.ip.ipv6), &len);
             } else if (ipType_ == IpV4) {
                 socklen_t len = sizeof(sockaddr_in);
-                fd = ::accept(listenFd_, reinterpret_cast<struct sockaddr *>(&addressIn.ip.ipv4), &len);
+                fd = ::accept(listenFd, reinterpret_cast<struct sockaddr *>(&addressIn.ip.ipv4), &len);
             }
             if (fd < 0) {
-                LOG_WARN("Failed to accept on new socket with " << strerror(errno) << ", ignore and continue");
+                if (errno != EAGAIN && errno != EWOULDBLOCK) { /* taken by another accept thread */
+                    LOG_WARN("Failed to accept on new socket with " << strerror(errno) << ", ignore and continue");
+                }
                 continue;
             }
 
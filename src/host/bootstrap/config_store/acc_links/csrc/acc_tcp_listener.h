@@ -23,10 +23,13 @@ using NewConnHandlerInner = std::function<int(const AccConnReq &reg, const AccTc
 class AccTcpListener : public AccReferable {
 public:
     AccTcpListener(std::string ip, uint16_t port, bool reusePort, int32_t sockFd = -1,
-                   bool enableTls = false, SSL_CTX *sslCtx = nullptr)
+                   bool enableTls = false, SSL_CTX *sslCtx = nullptr, uint16_t acceptorCount = UNO_1,
+                   int32_t backlog = 4 * UNO_1024)
         : listenIp_(std::move(ip)),
           listenPort_(port),
           reusePort_(reusePort),
+          acceptorCount_(acceptorCount == 0 ? UNO_1 : acceptorCount),
+          backlog_(backlog),
           listenFd_(sockFd),
           enableTls_(enableTls),
           sslCtx_(sslCtx)
@@ -41,10 +44,11 @@ public:
     void Stop(bool afterFork = false) noexcept;
 
 private:
-    void RunInThread() noexcept;
+    void RunInThread(int fd) noexcept;
     void ProcessNewConnection(int fd, mf_sockaddr addressIn) noexcept;
     bool PrepareSockAddr(mf_sockaddr& addr) noexcept;
-    Result StartAcceptThread() noexcept;
+    Result StartAcceptThreads() noexcept;
+    void OpenAcceptorSockets(mf_sockaddr &addr) noexcept;
     Result CreateSocketForStrat(mf_sockaddr &addr, int &tmpFD) noexcept;
     void FormatIPAddressAndPort(mf_sockaddr addressIn, std::string &ipPort) noexcept;
     Result BindAndListenSocket(int tmpFD, mf_sockaddr &addr) noexcept;
@@ -52,14 +56,18 @@ private:
 
 private:
     int listenFd_ = -1; /* listen fd */
+    std::vector<int> acceptFds_; /* listen fd of each accept thread, extra SO_REUSEPORT sockets or listenFd_ */
+    int stopFd_ = -1; /* event fd waking the accept threads on stop */
     volatile bool needStop_ = false; /* stop thread flag */
     NewConnHandlerInner connHandler_ = nullptr; /* new connection handler */
-    std::thread acceptThread_; /* accept thread */
+    std::vector<std::thread> acceptThreads_; /* accept threads */
     bool started_ = false; /* listener started or not */
-    std::atomic<bool> threadStarted_{false}; /* flag to ensure thread started */
+    std::atomic<uint32_t> threadsStarted_{0}; /* to ensure threads started */
     const std::string listenIp_; /* listen ip */
     const uint16_t listenPort_; /* listen port */
     const bool reusePort_; /* reuse listen port or not */
+    const uint16_t acceptorCount_; /* accept threads */
+    const int32_t backlog_; /* backlog of listen sockets */
     const bool enableTls_; /* enable tls */
     SSL_CTX* sslCtx_ = nullptr; /* ssl ctx */
     IpType ipType_ {IPNONE}; /* listenIp_ is ipv4 or ipv6 */
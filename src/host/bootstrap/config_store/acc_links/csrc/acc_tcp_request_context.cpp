@@ -7,8 +7,13 @@
  * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
  * See LICENSE in the root of the software repository for the full text of the License.
  */
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 #include "acc_includes.h"
 #include "acc_tcp_request_context.h"
+#include "acc_tcp_worker.h"
 
 namespace shm {
 namespace acc {
@@ -24,5 +29,48 @@ Result AccTcpRequestContext::Reply(int16_t result, const AccDataBufferPtr &d) co
     AccMsgHeader replyHeader(header_.type, result, d->DataLen(), header_.seqNo);
     return link_->EnqueueAndModifyEpoll(replyHeader, d, nullptr);
 }
+
+void AccTcpRequestContext::ReplyAll(const std::list<AccTcpRequestContext> &contexts, int16_t result,
+                                    const AccDataBufferPtr &d)
+{
+    /* a few replies are cheaper to enqueue here than to hand over */
+    const size_t inlineMax = UNO_32;
+    if (contexts.size() < inlineMax) {
+        for (auto &ctx : contexts) {
+            (void)ctx.Reply(result, d);
+        }
+        return;
+    }
+
+    using ContextBatch = std::vector<AccTcpRequestContext>;
+    std::unordered_map<AccTcpWorker *, ContextBatch> batches;
+    for (auto &ctx : contexts) {
+        auto link = static_cast<AccTcpLinkComplexDefault *>(ctx.link_.Get());
+        if (link != nullptr) {
+            batches[link->worker_].emplace_back(ctx, nullptr);
+        }
+    }
+
+    /* other workers are handed their batches first, the links of the calling worker are done here meanwhile */
+    ContextBatch local;
+    for (auto &batch : batches) {
+        if (batch.first == nullptr || batch.first == AccTcpWorker::Current()) {
+            local = std::move(batch.second);
+            continue;
+        }
+        auto shared = std::make_shared<ContextBatch>(std::move(batch.second));
+        auto replyBatch = [shared, result, d]() {
+            for (auto &ctx : *shared) {
+                (void)ctx.Reply(result, d);
+            }
+        };
+        if (!batch.first->Post(replyBatch)) {
+            replyBatch();
+        }
+    }
+    for (auto &ctx : local) {
+        (void)ctx.Reply(result, d);
+    }
+}
 }  // namespace acc
 }  // namespace shm
\ No newline at end of file
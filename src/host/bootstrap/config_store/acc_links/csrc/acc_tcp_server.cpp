@@ -9,6 +9,7 @@
  */
 #include "acc_common_util.h"
 #include "acc_includes.h"
+#include "acc_tcp_buffer_pool.h"
 #include "acc_tcp_server_default.h"
 
 namespace shm {
@@ -22,5 +23,10 @@ AccTcpServerPtr AccTcpServer::Create()
     }
     return server.Get();
 }
+
+AccBufferPoolStats AccTcpServer::BufferPoolStats()
+{
+    return AccBufferPool::Instance().Stats();
+}
 }  // namespace acc
 }  // namespace shm
\ No newline at end of file
@@ -12,6 +12,7 @@
 #include "sotre_net.h"
 #include "acc_tcp_server.h"
 #include "acc_common_util.h"
+#include "acc_tcp_buffer_pool.h"
 #include "acc_tcp_server_default.h"
 
 #include <net/if.h>
@@ -91,6 +92,7 @@ Result AccTcpServerDefault::Start(const AccTcpServerOptions &opt, const AccTlsOp
         return result;
     }
 
+    AccBufferPool::Instance().ServerStarted();
     rollback.SetSuccess(true);
     return ACC_OK;
 }
@@ -126,6 +128,7 @@ void AccTcpServerDefault::Stop()
     StopAndCleanDelayCleanup();
 
     StopAndCleanSSLHelper();
+    AccBufferPool::Instance().ServerStopped();
 }
 
 void AccTcpServerDefault::StopAfterFork()
@@ -143,6 +146,7 @@ void AccTcpServerDefault::StopAfterFork()
     StopAndCleanDelayCleanup(true);
 
     StopAndCleanSSLHelper();
+    AccBufferPool::Instance().ServerStopped();
 }
 
 Result AccTcpServerDefault::ValidateOptions() const
@@ -169,6 +173,11 @@ Result AccTcpServerDefault::ValidateOptions() const
         return ACC_INVALID_PARAM;
     }
 
+    if (options_.workerPollBatchMax < UNO_16) {
+        LOG_ERROR("Invalid worker poll batch max as it should not be smaller than 16");
+        return ACC_INVALID_PARAM;
+    }
+
     if (options_.linkSendQueueSize < UNO_32) {
         LOG_ERROR("Invalid send queue size of link as it should not be smaller than 32");
         return ACC_INVALID_PARAM;
@@ -194,6 +203,16 @@ Result AccTcpServerDefault::ValidateOptions() const
         return ACC_INVALID_PARAM;
     }
 
+    if (options_.acceptorCount > UNO_16 || options_.acceptorCount == 0) {
+        LOG_ERROR("Invalid acceptor count as it should be between 1 and 16");
+        return ACC_INVALID_PARAM;
+    }
+
+    if (options_.listenBacklog <= 0) {
+        LOG_ERROR("Invalid listen backlog as it should be bigger than 0");
+        return ACC_INVALID_PARAM;
+    }
+
     if (AccCommonUtil::CheckTlsOptions(tlsOption_) != ACC_OK) {
         LOG_ERROR("Invalid tls option");
         return ACC_INVALID_PARAM;
@@ -240,6 +259,8 @@ Result AccTcpServerDefault::StartWorkers()
     workerOptions.threadPriority = options_.workerThreadPriority;
     workerOptions.cpuId = -1;
     workerOptions.pollingTimeoutMs = options_.workerPollTimeoutMs;
+    workerOptions.pollBatchMax = options_.workerPollBatchMax;
+    workerOptions.busyPollUs = options_.workerBusyPollUs;
     for (uint16_t i = 0; i < options_.workerCount; i++) {
         if (options_.workerStartCpuId != -1) {
             workerOptions.cpuId = options_.workerStartCpuId + i;
@@ -258,6 +279,11 @@ Result AccTcpServerDefault::StartWorkers()
         workers_.push_back(tmpWorker);
     }
 
+    {
+        std::unique_lock<std::mutex> lockGuard{ linkCntMutex };
+        workerLinkCnt_.assign(workers_.size(), 0);
+    }
+
     for (auto &item : workers_) {
         auto result = item->Start();
         if (result != ACC_OK) {
@@ -269,6 +295,21 @@ Result AccTcpServerDefault::StartWorkers()
     return ACC_OK;
 }
 
+std::vector<AccWorkerStats> AccTcpServerDefault::WorkerStats()
+{
+    std::vector<AccWorkerStats> stats;
+    stats.reserve(workers_.size());
+    for (auto &item : workers_) {
+        stats.push_back(item->Stats());
+    }
+
+    std::unique_lock<std::mutex> lockGuard{ linkCntMutex };
+    for (uint32_t i = 0; i < stats.size() && i < workerLinkCnt_.size(); i++) {
+        stats[i].links = workerLinkCnt_[i];
+    }
+    return stats;
+}
+
 void AccTcpServerDefault::StopAndCleanWorkers(bool afterFork)
 {
     if (afterFork) {
@@ -288,6 +329,9 @@ void AccTcpServerDefault::StopAndCleanWorkers(bool afterFork)
     }
     workers_.clear();
     connectedLinks_.clear();
+
+    std::unique_lock<std::mutex> lockGuard{ linkCntMutex };
+    workerLinkCnt_.clear();
 }
 
 Result AccTcpServerDefault::StartListener()
@@ -299,7 +343,7 @@ Result AccTcpServerDefault::StartListener()
 
     AccTcpListenerPtr tmpListener = new (std::nothrow)
         AccTcpListener(options_.listenIp, options_.listenPort, options_.reusePort, options_.sockFd,
-                       tlsOption_.enableTls, sslCtx_);
+                       tlsOption_.enableTls, sslCtx_, options_.acceptorCount, options_.listenBacklog);
     ASSERT_RETURN(tmpListener.Get() != nullptr, ACC_NEW_OBJECT_FAIL);
 
     tmpListener->RegisterNewConnectionHandler(
@@ -390,11 +434,13 @@ Result AccTcpServerDefault::HandleNewConnection(const AccConnReq &req, const Acc
     auto result = newLink->Initialize(options_.linkSendQueueSize, workIndex, worker.Get());
     if (UNLIKELY(result != ACC_OK)) {
         LOG_ERROR("Failed to initialize the link from " << newLink->ShortName() << ", result " << result);
+        WorkerLinkCntUpdate(workIndex);
         return ACC_ERROR;
     }
 
     result = newLinkHandle_(req, newLink.Get());
     if (UNLIKELY(result != ACC_OK)) {
+        WorkerLinkCntUpdate(workIndex);
         return result;
     }
 
@@ -404,17 +450,20 @@ Result AccTcpServerDefault::HandleNewConnection(const AccConnReq &req, const Acc
         std::lock_guard<std::mutex> guard(mutex_);
         if (!started_) {
             LOG_WARN("The server is being destroyed or has been destroyed. can't receive new connection.");
+            WorkerLinkCntUpdate(workIndex);
             return ACC_ERROR;
         }
         auto iter = connectedLinks_.find(newLink->Id());
         if (iter != connectedLinks_.end()) {
             LOG_ERROR("Failed to handle new connection as found duplicated link id " << newLink->Id());
+            WorkerLinkCntUpdate(workIndex);
             return ACC_ERROR;
         }
 
         /* added to worker */
         result = worker->AddLink(newLink, EPOLLIN | EPOLLOUT | EPOLLET);
         if (UNLIKELY(result != ACC_OK)) {
+            WorkerLinkCntUpdate(workIndex);
             return result;
         }
 
@@ -427,51 +476,37 @@ Result AccTcpServerDefault::HandleNewConnection(const AccConnReq &req, const Acc
 
 Result AccTcpServerDefault::WorkerSelect()
 {
-    auto workerSize = workers_.size();
-    nextWorkerIndex_.fetch_add(1, std::memory_order_relaxed);
+    std::unique_lock<std::mutex> lockGuard{ linkCntMutex };
+    auto workerSize = static_cast<uint32_t>(workerLinkCnt_.size());
     if (workerSize == 0) {
         return ACC_ERROR;
     }
-    auto workIndex = nextWorkerIndex_ % workerSize;
-    for (uint32_t i = 0; i < workers_.size(); i++) {
-        if (WorkerLinkLimitCheck(workIndex)) {
-            return workIndex;
-        } else {
-            workIndex += 1;
-            workIndex = workIndex % workerSize;
+
+    /* the worker with the fewest links below the limit, ties are taken in turn from a rotating start */
+    auto start = nextWorkerIndex_.fetch_add(1, std::memory_order_relaxed) % workerSize;
+    auto selected = workerSize;
+    for (uint32_t i = 0; i < workerSize; i++) {
+        auto workIndex = (start + i) % workerSize;
+        if (workerLinkCnt_[workIndex] < maxWorkerLinkeCnt_ &&
+            (selected == workerSize || workerLinkCnt_[workIndex] < workerLinkCnt_[selected])) {
+            selected = workIndex;
         }
     }
-    LOG_ERROR("All workers reached the link load maximum.");
-    return ACC_ERROR;
-}
-
-bool AccTcpServerDefault::WorkerLinkLimitCheck(uint32_t workerIdx)
-{
-    std::unique_lock<std::mutex> lockGuard{ linkCntMutex };
-
-    auto it = workerLinkCnt_.find(workerIdx);
-    if (it == workerLinkCnt_.end()) {
-        workerLinkCnt_.emplace(workerIdx, 1);
-        return true;
-    } else if (it->second >= maxWorkerLinkeCnt_) {
-        return false;
-    } else {
-        it->second++;
-        return true;
+    if (selected == workerSize) {
+        LOG_ERROR("All workers reached the link load maximum.");
+        return ACC_ERROR;
     }
+
+    workerLinkCnt_[selected]++;
+    return static_cast<Result>(selected);
 }
 
 void AccTcpServerDefault::WorkerLinkCntUpdate(uint32_t workerIdx)
 {
     std::unique_lock<std::mutex> lockGuard{ linkCntMutex };
-    auto pos = workerLinkCnt_.find(workerIdx);
-    if (pos == workerLinkCnt_.end()) {
-        return;
-    }
-    if (--pos->second == 0) {
-        workerLinkCnt_.erase(pos);
+    if (workerIdx < workerLinkCnt_.size() && workerLinkCnt_[workerIdx] > 0) {
+        workerLinkCnt_[workerIdx]--;
     }
-    return;
 }
 
 static Result CreateSocket(const std::string &peerIp, IpType &type, int &sockfd)
@@ -734,6 +769,7 @@ Result AccTcpServerDefault::Handshake(int &tmpFD, const AccConnReq &connReq, con
     result = tmpLink->Initialize(options_.linkSendQueueSize, workIndex, worker.Get());
     if (UNLIKELY(result != ACC_OK)) {
         LOG_ERROR("Failed to initialize the link from " << tmpLink->ShortName() << ", result " << result);
+        WorkerLinkCntUpdate(workIndex);
         return ACC_ERROR;
     }
 
@@ -744,12 +780,14 @@ Result AccTcpServerDefault::Handshake(int &tmpFD, const AccConnReq &connReq, con
         auto iter = connectedLinks_.find(tmpLink->Id());
         if (iter != connectedLinks_.end()) {
             LOG_ERROR("Failed to handle new connection as found duplicated link id " << tmpLink->Id());
+            WorkerLinkCntUpdate(workIndex);
             return ACC_ERROR;
         }
 
         /* added to worker */
         result = worker->AddLink(tmpLink, EPOLLIN | EPOLLOUT | EPOLLET);
         if (UNLIKELY(result != ACC_OK)) {
+            WorkerLinkCntUpdate(workIndex);
             return result;
         }
 
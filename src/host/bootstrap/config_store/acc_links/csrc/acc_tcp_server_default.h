@@ -44,6 +44,8 @@ public:
 
     void RegisterDecryptHandler(const AccDecryptHandler &h) override;
 
+    std::vector<AccWorkerStats> WorkerStats() override;
+
 private:
     Result ValidateOptions() const;
     Result ValidateHandler() const;
@@ -65,7 +67,6 @@ private:
 
     /* listener callback */
     Result HandleNewConnection(const AccConnReq &req, const AccTcpLinkComplexDefaultPtr &newLink);
-    bool WorkerLinkLimitCheck(uint32_t workerIdx);
     void WorkerLinkCntUpdate(uint32_t workerIdx);
     Result WorkerSelect();
 
@@ -87,7 +88,7 @@ private:
     AccNewLinkHandler newLinkHandle_ = nullptr;
     AccTcpLinkDelayCleanupPtr delayCleanup_{nullptr};
     std::mutex linkCntMutex;
-    std::unordered_map<uint32_t, uint32_t> workerLinkCnt_;
+    std::vector<uint32_t> workerLinkCnt_; /* links of each worker, the load WorkerSelect balances */
     uint32_t maxWorkerLinkeCnt_ = UNO_1024;
 
     std::mutex mutex_;
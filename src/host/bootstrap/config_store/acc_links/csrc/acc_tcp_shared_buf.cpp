@@ -8,11 +8,13 @@
  * See LICENSE in the root of the software repository for the full text of the License.
  */
 #include "acc_common_util.h"
+#include "acc_tcp_buffer_pool.h"
 #include "acc_tcp_shared_buf.h"
 
 namespace shm {
 namespace acc {
-AccDataBuffer::AccDataBuffer(uint32_t memSize) : memSize_{ memSize }, data_{ new (std::nothrow) uint8_t[memSize] } {}
+AccDataBuffer::AccDataBuffer(uint32_t memSize) : memSize_{ 0 }, data_{ AccBufferPool::Instance().Alloc(memSize, memSize_) }
+{}
 
 AccDataBuffer::AccDataBuffer(const void *data, uint32_t size) : AccDataBuffer{ size }
 {
@@ -25,7 +27,7 @@ AccDataBuffer::AccDataBuffer(const void *data, uint32_t size) : AccDataBuffer{ s
 
 AccDataBuffer::~AccDataBuffer()
 {
-    delete[] data_;
+    AccBufferPool::Instance().Free(data_, memSize_);
     data_ = nullptr;
     memSize_ = 0;
     dataSize_ = 0;
@@ -38,23 +40,41 @@ bool AccDataBuffer::AllocIfNeed(uint32_t newSize) noexcept
     }
 
     if (data_ == nullptr) {
-        memSize_ = std::max(memSize_, newSize);
-        data_ = new (std::nothrow) uint8_t[memSize_];
+        data_ = AccBufferPool::Instance().Alloc(std::max(memSize_, newSize), memSize_);
         return data_ != nullptr;
     }
 
     if (newSize > memSize_) {
-        /* free old and malloc new one */
-        delete[] data_;
-
-        memSize_ = std::max(memSize_, newSize);
-        data_ = new (std::nothrow) uint8_t[memSize_];
+        /* free old and take a larger one */
+        AccBufferPool::Instance().Free(data_, memSize_);
+        data_ = AccBufferPool::Instance().Alloc(newSize, memSize_);
         return data_ != nullptr;
     }
 
     return true;
 }
 
+void *AccDataBuffer::operator new(size_t size)
+{
+    uint32_t capacity = 0;
+    auto ptr = AccBufferPool::Instance().Alloc(static_cast<uint32_t>(size), capacity);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *AccDataBuffer::operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    uint32_t capacity = 0;
+    return AccBufferPool::Instance().Alloc(static_cast<uint32_t>(size), capacity);
+}
+
+void AccDataBuffer::operator delete(void *ptr, size_t size) noexcept
+{
+    AccBufferPool::Instance().Free(static_cast<uint8_t *>(ptr), static_cast<uint32_t>(size));
+}
+
 AccDataBufferPtr AccDataBuffer::Create(const void *data, uint32_t size)
 {
     auto buffer = AccMakeRef<AccDataBuffer>(data, size);
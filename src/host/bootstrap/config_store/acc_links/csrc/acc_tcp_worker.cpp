@@ -8,12 +8,24 @@
  * See LICENSE in the root of the software repository for the full text of the License.
  */
 #include <pthread.h>
+#include <sys/eventfd.h>
 #include <sys/resource.h>
+#include <algorithm>
+#include <chrono>
 
 #include "acc_tcp_worker.h"
 
 namespace shm {
 namespace acc {
+namespace {
+thread_local AccTcpWorker *g_currentWorker = nullptr;
+}
+
+AccTcpWorker *AccTcpWorker::Current() noexcept
+{
+    return g_currentWorker;
+}
+
 Result AccTcpWorker::Start()
 {
     bool expected = false;
@@ -33,6 +45,18 @@ Result AccTcpWorker::Start()
         return ACC_EPOLL_ERROR;
     }
 
+    struct epoll_event evTask {};
+    evTask.data.ptr = &eventFD_;
+    evTask.events = EPOLLIN;
+    if ((eventFD_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0 ||
+        epoll_ctl(epollFD_, EPOLL_CTL_ADD, eventFD_, &evTask) != 0) {
+        LOG_ERROR("Failed to create task event in worker " << options_.Name() << ", errno " << errno);
+        SafeCloseFd(eventFD_, false);
+        SafeCloseFd(epollFD_);
+        started_.store(false);
+        return ACC_EPOLL_ERROR;
+    }
+
     threadStarted_.store(false);
 
     try {
@@ -40,11 +64,13 @@ Result AccTcpWorker::Start()
         epollThread_ = std::move(tmpThread);
     } catch (const std::system_error& e) {
         LOG_ERROR("Failed to create worker thread: " << e.what());
+        SafeCloseFd(eventFD_, false);
         SafeCloseFd(epollFD_);
         started_.store(false);
         return ACC_ERROR;
     } catch (...) {
         LOG_ERROR("Unknown error creating worker thread");
+        SafeCloseFd(eventFD_, false);
         SafeCloseFd(epollFD_);
         started_.store(false);
         return ACC_ERROR;
@@ -70,7 +96,8 @@ void AccTcpWorker::Stop(bool afterFork)
 void AccTcpWorker::StopInner(bool afterFork)
 {
     LOG_TRACE("Try to stop worker " << options_.Name());
-    needStop_ = true;
+    needStop_.store(true);
+    WakeUp(); /* don't wait for the epoll timeout */
     if (epollThread_.joinable()) {
         if (afterFork) {
             epollThread_.detach();
@@ -82,6 +109,108 @@ void AccTcpWorker::StopInner(bool afterFork)
     if (epollFD_ != -1) {
         SafeCloseFd(epollFD_, !afterFork);
     }
+    std::lock_guard<std::mutex> guard(taskMutex_);
+    if (eventFD_ != -1) {
+        SafeCloseFd(eventFD_, false);
+    }
+    tasks_.clear();
+    flushLinks_.clear();
+    localFlushLinks_.clear();
+}
+
+void AccTcpWorker::WakeUp() noexcept
+{
+    uint64_t one = 1;
+    if (eventFD_ != -1 && write(eventFD_, &one, sizeof(one)) != sizeof(one)) {
+        LOG_WARN("Failed to wake up worker " << options_.Name() << ", errno:" << errno);
+    }
+}
+
+bool AccTcpWorker::Post(std::function<void()> task) noexcept
+{
+    std::lock_guard<std::mutex> guard(taskMutex_);
+    if (!started_.load() || eventFD_ == -1) {
+        return false;
+    }
+
+    /* one wakeup covers every task and flush posted before the worker drains them */
+    bool wakeup = tasks_.empty() && flushLinks_.empty();
+    tasks_.emplace_back(std::move(task));
+    if (wakeup) {
+        WakeUp();
+    }
+    return true;
+}
+
+bool AccTcpWorker::RequestFlush(const AccTcpLinkComplexDefaultPtr &link) noexcept
+{
+    /* the worker thread flushes its own requests after the events of this round */
+    if (g_currentWorker == this) {
+        localFlushLinks_.emplace_back(link);
+        return true;
+    }
+
+    std::lock_guard<std::mutex> guard(taskMutex_);
+    if (!started_.load() || eventFD_ == -1) {
+        return false;
+    }
+
+    bool wakeup = tasks_.empty() && flushLinks_.empty();
+    flushLinks_.emplace_back(link);
+    if (wakeup) {
+        WakeUp();
+    }
+    return true;
+}
+
+void AccTcpWorker::RunPostedTasks() noexcept
+{
+    uint64_t count = 0;
+    if (read(eventFD_, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+        LOG_WARN("Failed to reset wakeup of worker " << options_.Name() << ", errno:" << errno);
+    }
+
+    std::vector<std::function<void()>> tasks;
+    std::vector<AccTcpLinkComplexDefaultPtr> links;
+    std::unique_lock<std::mutex> guard(taskMutex_);
+    tasks.swap(tasks_);
+    links.swap(flushLinks_);
+    guard.unlock();
+
+    for (auto &task : tasks) {
+        task();
+    }
+    FlushLinks(links);
+}
+
+void AccTcpWorker::FlushLinks(std::vector<AccTcpLinkComplexDefaultPtr> &links) noexcept
+{
+    for (auto &link : links) {
+        if (!link->Established()) {
+            continue;
+        }
+
+        flushes_.fetch_add(1U, std::memory_order_relaxed);
+        auto result = link->HandlePollOut(requestSentHandle_);
+        if (result == ACC_LINK_EAGAIN) { /* socket buffer is full, EPOLLOUT sends the rest */
+            (void)ModifyLink(link, EPOLLIN | EPOLLOUT | EPOLLET);
+        } else if (result == ACC_LINK_ERROR) {
+            (void)ModifyLink(link, EPOLLWRNORM);
+        }
+    }
+    links.clear();
+}
+
+AccWorkerStats AccTcpWorker::Stats() const noexcept
+{
+    AccWorkerStats stats;
+    stats.wakeups = wakeups_.load(std::memory_order_relaxed);
+    stats.events = events_.load(std::memory_order_relaxed);
+    stats.emptyPolls = emptyPolls_.load(std::memory_order_relaxed);
+    stats.busyPolls = busyPolls_.load(std::memory_order_relaxed);
+    stats.flushes = flushes_.load(std::memory_order_relaxed);
+    stats.pollBatch = pollBatch_.load(std::memory_order_relaxed);
+    return stats;
 }
 
 Result AccTcpWorker::AddLink(const AccTcpLinkComplexDefaultPtr &link, uint32_t events) noexcept
@@ -160,26 +289,63 @@ void AccTcpWorker::SetPropertiesForThread()
 void AccTcpWorker::RunInThread(std::atomic<bool> *started)
 {
     SetPropertiesForThread();
+    g_currentWorker = this;
     started->store(true);
     LOG_INFO("Worker [" << options_.ToString() << "] progress thread started");
 
-    const uint16_t pollBatchSize = 16L;
-    const uint32_t timeout = options_.pollingTimeoutMs;
+    /*
+     * the batch doubles while epoll fills it and halves while it is mostly empty, a busy worker drains
+     * thousands of ready links in a few wakeups and an idle one doesn't walk a large array
+     */
+    const uint32_t batchMax = std::max<uint32_t>(options_.pollBatchMax, ACC_POLL_BATCH_MIN);
+    uint32_t batch = ACC_POLL_BATCH_MIN;
+    std::vector<struct epoll_event> ev(batchMax);
 
-    struct epoll_event ev[pollBatchSize];
+    /* with busy poll, epoll doesn't sleep until busyPollUs passed without events */
+    const auto busyPoll = std::chrono::microseconds(options_.busyPollUs);
+    auto lastEventTime = std::chrono::steady_clock::now();
+    std::vector<AccTcpLinkComplexDefaultPtr> flushing;
+
+    while (!needStop_.load(std::memory_order_relaxed)) {
+        int timeout = options_.pollingTimeoutMs;
+        if (busyPoll.count() > 0 && std::chrono::steady_clock::now() - lastEventTime < busyPoll) {
+            timeout = 0;
+        }
 
-    while (!needStop_) {
         /* do epoll wait with timeout */
-        int count = epoll_wait(epollFD_, ev, pollBatchSize, timeout);
+        int count = epoll_wait(epollFD_, ev.data(), static_cast<int>(batch), timeout);
         if (count > 0) {
             /* there are events, handle it */
             LOG_TRACE("Got " << count << " in worker " << mName);
-            for (uint16_t i = 0; i < static_cast<uint16_t>(count); ++i) {
-                struct epoll_event &oneEv = (ev)[i];
-                ProcessEvent(oneEv);
+            for (uint32_t i = 0; i < static_cast<uint32_t>(count); ++i) {
+                ProcessEvent(ev[i]);
+            }
+            /* replies sent by the handlers of this round, flushing may request again */
+            while (!localFlushLinks_.empty()) {
+                flushing.swap(localFlushLinks_);
+                FlushLinks(flushing);
+            }
+
+            wakeups_.fetch_add(1U, std::memory_order_relaxed);
+            events_.fetch_add(static_cast<uint64_t>(count), std::memory_order_relaxed);
+            if (static_cast<uint32_t>(count) == batch && batch < batchMax) {
+                batch = std::min(batch * UNO_2, batchMax);
+                pollBatch_.store(batch, std::memory_order_relaxed);
+            } else if (static_cast<uint32_t>(count) * UNO_16 <= batch && batch > ACC_POLL_BATCH_MIN) {
+                batch = std::max<uint32_t>(batch / UNO_2, ACC_POLL_BATCH_MIN);
+                pollBatch_.store(batch, std::memory_order_relaxed);
+            }
+            if (busyPoll.count() > 0) {
+                lastEventTime = std::chrono::steady_clock::now();
             }
         } else if (count == 0) {
             LOG_TRACE("Got " << count << " in worker " << mName);
+            if (timeout == 0) {
+                busyPolls_.fetch_add(1U, std::memory_order_relaxed);
+                std::this_thread::yield(); /* costs nothing on a dedicated cpu, lets the peer thread run on a shared one */
+            } else {
+                emptyPolls_.fetch_add(1U, std::memory_order_relaxed);
+            }
             continue;
         } else if (errno == EINTR) {
             LOG_TRACE("Got error no EINTR in worker " << options_.Name());
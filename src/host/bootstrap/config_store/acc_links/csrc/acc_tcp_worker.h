@@ -11,6 +11,7 @@
 #define ACC_LINKS_ACC_TCP_WORKER_H
 
 #include <utility>
+#include <vector>
 
 #include "acc_tcp_common.h"
 #include "acc_tcp_link.h"
@@ -20,6 +21,8 @@
 
 namespace shm {
 namespace acc {
+constexpr uint16_t ACC_POLL_BATCH_MIN = UNO_16; /* events of one epoll wait the adaptive batch starts and shrinks to */
+
 using LinkBrokenHandlerInner = std::function<int32_t(const AccTcpLinkComplexDefaultPtr &link)>;
 
 /*
@@ -42,6 +45,20 @@ public:
     Result ModifyLink(const AccTcpLinkComplexDefaultPtr &link, uint32_t events) noexcept;
     Result RemoveLink(const AccTcpLinkComplexDefaultPtr &link) noexcept;
 
+    /* run task in the worker thread, false if the worker is not running */
+    bool Post(std::function<void()> task) noexcept;
+
+    /*
+     * send the queue of link from the worker thread without waiting for EPOLLOUT, several requests
+     * share one wakeup, false if the worker is not running
+     */
+    bool RequestFlush(const AccTcpLinkComplexDefaultPtr &link) noexcept;
+
+    /* the worker running the calling thread, nullptr if it is not a worker thread */
+    static AccTcpWorker *Current() noexcept;
+
+    AccWorkerStats Stats() const noexcept;
+
     void RegisterNewRequestHandler(const AccNewReqHandler &h);
     void RegisterRequestSentHandler(const AccReqSentHandler &h);
     void RegisterLinkBrokenHandler(const LinkBrokenHandlerInner &h);
@@ -52,14 +69,31 @@ private:
     Result ValidateOptions();
     void StopInner(bool afterFork);
     Result ProcessEvent(struct epoll_event &event) noexcept;
+    void RunPostedTasks() noexcept;
+    void FlushLinks(std::vector<AccTcpLinkComplexDefaultPtr> &links) noexcept;
+    void WakeUp() noexcept;
 
 private:
     int epollFD_ = -1; /* epoll fd */
-    bool needStop_ = false; /* if the worker need to be stopped */
+    std::atomic<bool> needStop_{false}; /* if the worker need to be stopped */
     AccNewReqHandler newRequestHandle_ = nullptr;
     AccReqSentHandler requestSentHandle_ = nullptr;
     LinkBrokenHandlerInner linkBrokenHandle_ = nullptr;
 
+    int eventFD_ = -1; /* wakes up epoll for posted tasks, flushes and stop, the address of it tags its events */
+    std::mutex taskMutex_;
+    std::vector<std::function<void()>> tasks_;
+    std::vector<AccTcpLinkComplexDefaultPtr> flushLinks_;      /* flushes requested by other threads */
+    std::vector<AccTcpLinkComplexDefaultPtr> localFlushLinks_; /* flushes requested by the worker thread */
+
+    /* loop counters, see @AccWorkerStats */
+    std::atomic<uint64_t> wakeups_{0};
+    std::atomic<uint64_t> events_{0};
+    std::atomic<uint64_t> emptyPolls_{0};
+    std::atomic<uint64_t> busyPolls_{0};
+    std::atomic<uint64_t> flushes_{0};
+    std::atomic<uint32_t> pollBatch_{ACC_POLL_BATCH_MIN};
+
     /* non-hot variables */
     std::mutex mutex_;
     AccTcpWorkerOptions options_; /* worker options */
@@ -91,6 +125,11 @@ inline Result AccTcpWorker::ModifyLink(const AccTcpLinkComplexDefaultPtr &link,
 
 inline Result AccTcpWorker::ProcessEvent(struct epoll_event &event) noexcept
 {
+    if (event.data.ptr == &eventFD_) {
+        RunPostedTasks();
+        return ACC_OK;
+    }
+
     auto* link = static_cast<AccTcpLinkComplexDefault*>(event.data.ptr);
     if (UNLIKELY(link == nullptr)) {
         LOG_ERROR("Link is null in polled event for worker " << options_.Name());
@@ -98,33 +137,30 @@ inline Result AccTcpWorker::ProcessEvent(struct epoll_event &event) noexcept
     }
 
     if (event.events & EPOLLIN) { /* there is in data */
+        /* ET mode, dispatch every message the link has buffered or the socket has, then add event again */
         auto result = link->HandlePollIn();
-        if (result == ACC_LINK_MSG_READY) { /* ready for message, do upper call */
+        uint32_t dispatched = 0;
+        while (result == ACC_LINK_MSG_READY) { /* ready for message, do upper call */
             AccTcpRequestContext ctx(link->header_, link->data_, link);
             (void)newRequestHandle_(ctx);
-            /* ET mode, each loop only handle one message, need to add event again */
-            (void)ModifyLink(link, EPOLLIN | EPOLLOUT | EPOLLET);
-            return ACC_OK;
-        } else if (result == ACC_LINK_EAGAIN) { /* need to continue read data */
+            /* a burst would fill the send queue with replies before EPOLLOUT is seen, send them in between */
+            if (++dispatched % ACC_SEND_BATCH_SIZE == 0) {
+                (void)link->HandlePollOut(requestSentHandle_);
+            }
+            result = link->HandlePollIn();
+        }
+
+        if (result == ACC_LINK_EAGAIN) { /* drained, wait for more data */
             (void)ModifyLink(link, EPOLLIN | EPOLLOUT | EPOLLET);
-            return ACC_OK; /* not fully received, continue to process next event */
         } else if (result == ACC_LINK_ERROR) { /* link error */
             (void)linkBrokenHandle_(link);
-            return ACC_OK;
         }
 
         return ACC_OK; /* ignore other error */
     } else if (event.events & EPOLLOUT) { /* there is free out buffer */
-        AccMsgHeader outHeader{};
-        AccDataBufferPtr cbCtx;
-        auto result = link->HandlePollOut(outHeader, cbCtx); /* call link to send something */
-        if (result == ACC_LINK_MSG_SENT) { /* if message sent */
-            if (requestSentHandle_ != nullptr) { /* call sent callback if set */
-                (void)requestSentHandle_(MSG_SENT, outHeader, cbCtx);
-            }
-            /* ET mode, each loop only handle one message, need to add event again */
-            (void)ModifyLink(link, EPOLLIN | EPOLLOUT | EPOLLET);
-        } else if (result == ACC_LINK_EAGAIN) { /* if message is partial sent */
+        auto result = link->HandlePollOut(requestSentHandle_); /* call link to send as much as it can */
+        if (result == ACC_LINK_MSG_SENT || result == ACC_LINK_EAGAIN) { /* sent or partial sent */
+            /* ET mode, need to add event again */
             (void)ModifyLink(link, EPOLLIN | EPOLLOUT | EPOLLET);
         } else if (result == ACC_LINK_ERROR) { /* if link error */
             (void)ModifyLink(link, EPOLLWRNORM);
@@ -15,6 +15,7 @@
 #include <string>
 #include <sstream>
 #include <thread>
+#include <vector>
 
 #include "acc_ref.h"
 #include <functional>
@@ -101,6 +102,8 @@ struct AccTcpServerOptions {
     uint16_t workerCount = UNO_2;            /* number of worker threads */
     int16_t workerThreadPriority = 0;        /* priority of worker threads */
     int16_t workerPollTimeoutMs = UNO_500;   /* epoll timeout */
+    uint16_t workerPollBatchMax = UNO_1024;  /* max events taken by one epoll wait, adapts up from 16 */
+    uint32_t workerBusyPollUs = 0;           /* spin without sleeping this long after the last event, 0 is off */
     int16_t workerStartCpuId = -1;           /* start cpu id of workers */
     uint16_t linkSendQueueSize = UNO_1024;   /* send queue size */
     uint16_t keepaliveIdleTime = UNO_32;     /* tcp keepalive idle time */
@@ -108,12 +111,38 @@ struct AccTcpServerOptions {
     uint16_t keepaliveProbeInterval = UNO_2; /* tcp keepalive probe interval */
     bool reusePort = true;                   /* reuse listen port */
     bool enableListener = false;             /* start listener or not */
+    uint16_t acceptorCount = UNO_1;          /* accept threads of listener, on own SO_REUSEPORT sockets if reusePort */
+    int32_t listenBacklog = 4 * UNO_1024;    /* backlog of listen sockets, capped by net.core.somaxconn */
     uint16_t magic = DEFAULT_CONN_MAGIC;        /* magic number for connection isolation */
     int16_t version = 0;                     /* version */
     uint32_t maxWorldSize = UNO_1024;        /* max client number */
     int32_t sockFd = -1;                     /* server sockFd for listen */
 };
 
+/**
+ * @brief Statistics of the pool recycling message buffers, process wide, see @AccTcpServer::BufferPoolStats
+ */
+struct AccBufferPoolStats {
+    uint64_t allocCount = 0;     /* buffers requested in pooled sizes */
+    uint64_t hitCount = 0;       /* requests served by a recycled buffer */
+    uint64_t heapAllocCount = 0; /* buffers taken from the process allocator, pooled sizes or not */
+    uint64_t cachedBytes = 0;    /* memory held by the pool for reuse */
+    uint64_t cachedBuffers = 0;  /* buffers held by the pool for reuse */
+};
+
+/**
+ * @brief Statistics of the event loop of one worker, see @AccTcpServer::WorkerStats
+ */
+struct AccWorkerStats {
+    uint64_t wakeups = 0;     /* epoll waits returning events, events / wakeups is the events per wakeup */
+    uint64_t events = 0;      /* events handled */
+    uint64_t emptyPolls = 0;  /* epoll waits timed out without events */
+    uint64_t busyPolls = 0;   /* non-sleeping epoll waits during busy poll finding nothing */
+    uint64_t flushes = 0;     /* send queues flushed on request instead of by EPOLLOUT */
+    uint32_t pollBatch = 0;   /* current max events of one epoll wait */
+    uint32_t links = 0;       /* links attached, a new link goes to the worker with the fewest */
+};
+
 /**
  * @brief Callback function of private key password decryptor, see @RegisterDecryptHandler
  *
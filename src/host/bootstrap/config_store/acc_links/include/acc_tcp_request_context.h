@@ -10,6 +10,8 @@
 #ifndef ACC_LINKS_ACC_TCP_REQUEST_CONTEXT_H
 #define ACC_LINKS_ACC_TCP_REQUEST_CONTEXT_H
 
+#include <list>
+
 #include "acc_tcp_link.h"
 #include "acc_tcp_shared_buf.h"
 
@@ -36,7 +38,27 @@ public:
 
     AccTcpRequestContext(const AccTcpRequestContext &b): header_(b.header_), link_(b.link_)
     {
-        data_ = AccDataBuffer::Create(b.DataPtr(), b.DataLen());
+        if (b.data_.Get() != nullptr) {
+            data_ = AccDataBuffer::Create(b.DataPtr(), b.DataLen());
+        }
+    }
+
+    AccTcpRequestContext(AccTcpRequestContext &&b) noexcept
+        : header_(b.header_),
+          link_(b.link_),
+          data_(std::move(b.data_))
+    {
+    }
+
+    /**
+     * @brief Same request and link as b but with another body, i.e. nullptr to keep a request
+     * only for replying later without holding a copy of what it carried
+     */
+    AccTcpRequestContext(const AccTcpRequestContext &b, const AccDataBufferPtr &d)
+        : header_(b.header_),
+          link_(b.link_),
+          data_(d)
+    {
     }
 
     /**
@@ -48,6 +70,17 @@ public:
      */
     virtual int32_t Reply(int16_t result, const AccDataBufferPtr &d) const;
 
+    /**
+     * @brief Reply the same data to many requests, i.e. all the waiters of one key. The data is shared rather
+     * than copied, and for a large batch the replies of links owned by other workers are enqueued by those workers
+     * in parallel rather than on the calling thread
+     *
+     * @param contexts     [in] requests to be replied
+     * @param result       [in] response result
+     * @param d            [in] data to be response
+     */
+    static void ReplyAll(const std::list<AccTcpRequestContext> &contexts, int16_t result, const AccDataBufferPtr &d);
+
     /**
      * @brief Get message type
      *
@@ -66,6 +66,13 @@ public:
      */
     static AccTcpServerPtr Create();
 
+    /**
+     * @brief Get statistics of the message buffer pool shared by all servers of the process
+     *
+     * @return hit rate and memory held of the pool
+     */
+    static AccBufferPoolStats BufferPoolStats();
+
 public:
     /**
      * @brief Start Tcp Server with TLS enabled
@@ -163,6 +170,13 @@ public:
      */
     virtual int32_t LoadDynamicLib(const std::string &dynLibPath) = 0;
 
+    /**
+     * @brief Get statistics of the event loops and the link load of the workers
+     *
+     * @return one entry per worker, empty if the server is not started
+     */
+    virtual std::vector<AccWorkerStats> WorkerStats() = 0;
+
     ~AccTcpServer() override = default;
 };
 
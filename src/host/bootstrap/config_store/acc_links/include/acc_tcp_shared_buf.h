@@ -10,6 +10,8 @@
 #ifndef ACC_LINKS_ACC_TCP_SHARED_BUF_H
 #define ACC_LINKS_ACC_TCP_SHARED_BUF_H
 
+#include <new>
+
 #include "acc_def.h"
 
 namespace shm {
@@ -83,6 +85,11 @@ public:
 
     explicit AccDataBuffer(uint32_t memSize);
 
+    /* the object and its memory both come from the buffer pool, recycled when the last reference goes */
+    static void *operator new(size_t size);
+    static void *operator new(size_t size, const std::nothrow_t &) noexcept;
+    static void operator delete(void *ptr, size_t size) noexcept;
+
 private:
     uint32_t dataSize_ = 0;
     uint32_t memSize_;
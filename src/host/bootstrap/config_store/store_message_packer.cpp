@@ -8,6 +8,7 @@
  * See LICENSE in the root of the software repository for the full text of the License.
  */
 #include <algorithm>
+#include <limits>
 
 #include "host/shmem_host_def.h"
 #include "shmemi_logger.h"
@@ -15,41 +16,67 @@
 
 namespace shm {
 namespace store {
+// size + userDef + mt + keyN + vN
+constexpr uint64_t MESSAGE_BASE_SIZE = 4U * sizeof(uint64_t) + sizeof(MessageType);
+
 std::vector<uint8_t> SmemMessagePacker::Pack(const SmemMessage &message) noexcept
 {
-    // size + userDef + mt + keyN + vN
-    constexpr uint64_t baseSize = 4U * sizeof(uint64_t) + sizeof(MessageType);
-    uint64_t totalSize = baseSize;
+    SmemMessageView view{message};
+    std::vector<uint8_t> result(PackedSize(view));
+    PackTo(view, result.data());
+    return result;
+}
+
+uint64_t SmemMessagePacker::PackedSize(const SmemMessageView &message) noexcept
+{
+    uint64_t totalSize = MESSAGE_BASE_SIZE;
     for (auto &key : message.keys) {
         totalSize += (sizeof(uint64_t) + key.size());
     }
     for (auto &value : message.values) {
-        totalSize += (sizeof(uint64_t) + value.size());
+        totalSize += (sizeof(uint64_t) + value.size);
     }
+    return totalSize;
+}
 
-    std::vector<uint8_t> result;
-    result.reserve(totalSize);
-    PackValue(result, totalSize);
-    PackValue(result, message.userDef);
-    PackValue(result, message.mt);
+void SmemMessagePacker::PackTo(const SmemMessageView &message, uint8_t *dest) noexcept
+{
+    WriteValue(dest, PackedSize(message));
+    WriteValue(dest, message.userDef);
+    WriteValue(dest, message.mt);
 
-    PackValue(result, message.keys.size());
+    WriteValue(dest, static_cast<uint64_t>(message.keys.size()));
     for (auto &key : message.keys) {
-        PackString(result, key);
+        WriteBytes(dest, reinterpret_cast<const uint8_t *>(key.data()), key.size());
     }
 
-    PackValue(result, message.values.size());
+    WriteValue(dest, static_cast<uint64_t>(message.values.size()));
     for (auto &value : message.values) {
-        PackBytes(result, value);
+        WriteBytes(dest, value.data, value.size);
     }
+}
 
-    return result;
+shm::acc::AccDataBufferPtr SmemMessagePacker::PackBuffer(const SmemMessageView &message) noexcept
+{
+    auto totalSize = PackedSize(message);
+    if (totalSize > std::numeric_limits<uint32_t>::max()) {
+        SHM_LOG_ERROR("message too large to pack, size: " << totalSize);
+        return nullptr;
+    }
+
+    auto buffer = shm::acc::AccDataBuffer::Create(static_cast<uint32_t>(totalSize));
+    if (buffer == nullptr) {
+        SHM_LOG_ERROR("create buffer for message failed, size: " << totalSize);
+        return nullptr;
+    }
+    PackTo(message, buffer->DataPtr());
+    buffer->SetDataSize(static_cast<uint32_t>(totalSize));
+    return buffer;
 }
 
 bool SmemMessagePacker::Full(const uint8_t* buffer, const uint64_t bufferLen) noexcept
 {
-    constexpr uint64_t baseSize = 4U * sizeof(uint64_t) + sizeof(MessageType);
-    if (bufferLen < baseSize) {
+    if (bufferLen < MESSAGE_BASE_SIZE) {
         return false;
     }
 
@@ -67,6 +94,28 @@ int64_t SmemMessagePacker::MessageSize(const std::vector<uint8_t> &buffer) noexc
 }
 
 int64_t SmemMessagePacker::Unpack(const uint8_t* buffer, const uint64_t bufferLen, SmemMessage &message) noexcept
+{
+    SmemMessageView view;
+    auto totalSize = UnpackView(buffer, bufferLen, view);
+    if (totalSize < 0) {
+        return totalSize;
+    }
+
+    message.mt = view.mt;
+    message.userDef = view.userDef;
+    message.keys.reserve(view.keys.size());
+    for (auto &key : view.keys) {
+        message.keys.emplace_back(key);
+    }
+    message.values.reserve(view.values.size());
+    for (auto &value : view.values) {
+        message.values.emplace_back(value.ToVector());
+    }
+    return totalSize;
+}
+
+int64_t SmemMessagePacker::UnpackView(const uint8_t* buffer, const uint64_t bufferLen,
+                                      SmemMessageView &message) noexcept
 {
     SHM_CHECK_CONDITION_RET(buffer == nullptr, -1);
     SHM_CHECK_CONDITION_RET(!Full(buffer, bufferLen), -1);
@@ -90,6 +139,7 @@ int64_t SmemMessagePacker::Unpack(const uint8_t* buffer, const uint64_t bufferLe
     message.keys.reserve(keyCount);
 
     for (auto i = 0UL; i < keyCount; i++) {
+        SHM_CHECK_CONDITION_RET(length + sizeof(uint64_t) > bufferLen, -1);
         uint64_t keySize = 0;
         std::copy_n(reinterpret_cast<const uint64_t *>(buffer + length), 1, &keySize);
         length += sizeof(uint64_t);
@@ -99,6 +149,7 @@ int64_t SmemMessagePacker::Unpack(const uint8_t* buffer, const uint64_t bufferLe
         length += keySize;
     }
 
+    SHM_CHECK_CONDITION_RET(length + sizeof(uint64_t) > bufferLen, -1);
     uint64_t valueCount = 0;
     std::copy_n(reinterpret_cast<const uint64_t *>(buffer + length), 1, &valueCount);
     SHM_CHECK_CONDITION_RET(valueCount > MAX_VALUE_COUNT, -1);
@@ -107,30 +158,26 @@ int64_t SmemMessagePacker::Unpack(const uint8_t* buffer, const uint64_t bufferLe
     message.values.reserve(valueCount);
 
     for (auto i = 0UL; i < valueCount; i++) {
+        SHM_CHECK_CONDITION_RET(length + sizeof(uint64_t) > bufferLen, -1);
         uint64_t valueSize = 0;
         std::copy_n(reinterpret_cast<const uint64_t *>(buffer + length), 1, &valueSize);
         length += sizeof(uint64_t);
         SHM_CHECK_CONDITION_RET(valueSize > MAX_VALUE_SIZE || length + valueSize > bufferLen, -1);
 
-        message.values.emplace_back(buffer + length, buffer + length + valueSize);
+        message.values.emplace_back(buffer + length, valueSize);
         length += valueSize;
     }
     SHM_CHECK_CONDITION_RET(totalSize != length, -1);
     return static_cast<int64_t>(totalSize);
 }
 
-void SmemMessagePacker::PackString(std::vector<uint8_t> &dest, const std::string &str) noexcept
+void SmemMessagePacker::WriteBytes(uint8_t *&dest, const uint8_t *bytes, uint64_t size) noexcept
 {
-    PackValue(dest, static_cast<uint64_t>(str.size()));
-    if (!str.empty()) {
-        dest.insert(dest.end(), str.data(), str.data() + str.size());
+    WriteValue(dest, size);
+    if (size > 0) {
+        std::copy_n(bytes, size, dest);
+        dest += size;
     }
 }
-
-void SmemMessagePacker::PackBytes(std::vector<uint8_t> &dest, const std::vector<uint8_t> &bytes) noexcept
-{
-    PackValue(dest, static_cast<uint64_t>(bytes.size()));
-    dest.insert(dest.end(), bytes.begin(), bytes.end());
-}
 }  // shm
 }  // store
\ No newline at end of file
@@ -12,17 +12,21 @@
 #ifndef STORE_MESSAGE_PACKER_H
 #define STORE_MESSAGE_PACKER_H
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "acc_tcp_shared_buf.h"
+
 namespace shm {
 namespace store {
 const uint64_t MAX_KEY_COUNT = 10ULL;
 const uint64_t MAX_KEY_SIZE = 2048ULL;
 const uint64_t MAX_VALUE_COUNT = 10ULL;
 const uint64_t MAX_VALUE_SIZE = 64 * 1024 * 1024ULL;
-enum MessageType : int16_t { SET, GET, ADD, REMOVE, APPEND, CAS, INVALID_MSG };
+enum MessageType : int16_t { SET, GET, ADD, REMOVE, APPEND, CAS, GATHER, BARRIER, MULTI, INVALID_MSG };
 
 struct SmemMessage {
     SmemMessage() noexcept : mt{MessageType::INVALID_MSG} {}
@@ -66,16 +70,62 @@ struct SmemMessage {
     std::vector<std::vector<uint8_t>> values;
 };
 
+/* bytes owned by somebody else: a caller's vector or a received buffer */
+struct SmemBytesView {
+    SmemBytesView() noexcept = default;
+
+    SmemBytesView(const uint8_t *d, uint64_t s) noexcept : data{d}, size{s} {}
+
+    SmemBytesView(const std::vector<uint8_t> &v) noexcept : data{v.data()}, size{v.size()} {}
+
+    std::vector<uint8_t> ToVector() const noexcept
+    {
+        return std::vector<uint8_t>{data, data + size};
+    }
+
+    const uint8_t *data{nullptr};
+    uint64_t size{0};
+};
+
+/* same layout as SmemMessage without owning keys and values, only valid as long as what it points to */
+struct SmemMessageView {
+    SmemMessageView() noexcept : mt{MessageType::INVALID_MSG} {}
+
+    explicit SmemMessageView(MessageType type) noexcept : mt{type} {}
+
+    explicit SmemMessageView(const SmemMessage &message) noexcept
+        : mt{message.mt}, userDef{message.userDef}, keys{message.keys.begin(), message.keys.end()},
+          values{message.values.begin(), message.values.end()}
+    {
+    }
+
+    MessageType mt;
+    int64_t userDef{-1L};
+    std::vector<std::string_view> keys;
+    std::vector<SmemBytesView> values;
+};
+
 class SmemMessagePacker {
 public:
     static std::vector<uint8_t> Pack(const SmemMessage &message) noexcept;
 
+    /* packed size of message, PackTo writes exactly this many bytes to dest */
+    static uint64_t PackedSize(const SmemMessageView &message) noexcept;
+
+    static void PackTo(const SmemMessageView &message, uint8_t *dest) noexcept;
+
+    /* pack straight into a buffer that can be sent or replied as is, nullptr if too large or out of memory */
+    static shm::acc::AccDataBufferPtr PackBuffer(const SmemMessageView &message) noexcept;
+
     static bool Full(const uint8_t* buffer, const uint64_t bufferLen) noexcept;
 
     static int64_t MessageSize(const std::vector<uint8_t> &buffer) noexcept;
 
     static int64_t Unpack(const uint8_t* buffer, const uint64_t bufferLen, SmemMessage &message) noexcept;
 
+    /* keys and values of message point into buffer, nothing is copied */
+    static int64_t UnpackView(const uint8_t* buffer, const uint64_t bufferLen, SmemMessageView &message) noexcept;
+
     template <class T>
     static std::vector<uint8_t> PackPod(const T &v) noexcept
     {
@@ -89,17 +139,23 @@ public:
         return *reinterpret_cast<const T *>(vec.data());
     }
 
-private:
     template <class T>
-    static void PackValue(std::vector<uint8_t> &dest, T value) noexcept
+    static T UnpackPod(const SmemBytesView &view) noexcept
     {
-        dest.insert(dest.end(), reinterpret_cast<const uint8_t *>(&value),
-                    reinterpret_cast<const uint8_t *>(&value) + sizeof(T));
+        T value;
+        std::copy_n(view.data, sizeof(T), reinterpret_cast<uint8_t *>(&value));
+        return value;
     }
 
-    static void PackString(std::vector<uint8_t> &dest, const std::string &str) noexcept;
+private:
+    template <class T>
+    static void WriteValue(uint8_t *&dest, T value) noexcept
+    {
+        std::copy_n(reinterpret_cast<const uint8_t *>(&value), sizeof(T), dest);
+        dest += sizeof(T);
+    }
 
-    static void PackBytes(std::vector<uint8_t> &dest, const std::vector<uint8_t> &bytes) noexcept;
+    static void WriteBytes(uint8_t *&dest, const uint8_t *bytes, uint64_t size) noexcept;
 };
 
 }  // shm
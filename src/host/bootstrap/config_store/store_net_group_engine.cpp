@@ -8,10 +8,17 @@
  * See LICENSE in the root of the software repository for the full text of the License.
  */
 
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
 #include <algorithm>
 #include <cerrno>
 #include <cctype>
 #include <climits>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
 #include "shmemi_num_util.h"
 #include "store_factory.h"
 #include "store_net_group_engine.h"
@@ -29,11 +36,20 @@ const std::string SMEM_GROUP_EXIT_KEY = "EXIT";
 const std::string SMEM_GROUP_LISTEN_EVENT_KEY = "EVENT";
 const std::string SMEM_GROUP_DYNAMIC_SIZE_KEY = "DSIZE";
 constexpr uint32_t SMEM_GATHER_PREFIX_SIZE = 4U;
+constexpr uint64_t SMEM_ALL_TO_ALL_OP_OVERHEAD = 256U;  // key and header of one packed MULTI op, with room to spare
 constexpr int32_t SMEM_GROUP_MS_TO_US = 1000;
 constexpr int64_t SMEM_GROUP_LISTER_TIMEOUT = 100LL * 365 * 24 * 60 * 60 * 1000; // 100 years, unit: ms
 constexpr int32_t SMEM_GROUP_SLEEP_TIMEOUT = 100 * SMEM_GROUP_MS_TO_US; // 100ms, unit: us
 constexpr int32_t SMEM_GROUP_SLEEP_5S = 5000 * SMEM_GROUP_MS_TO_US; // 5s
 
+const std::string SMEM_GROUP_RELAY_IP = "127.0.0.1";
+const std::string SMEM_GROUP_RELAY_PREFIX = "R_";
+constexpr uint32_t GROUP_KEY_GROUP_POS = 1U;
+constexpr uint32_t GROUP_KEY_VERSION_POS = 3U;
+constexpr uint32_t GROUP_KEY_SN_POS = 7U;
+constexpr uint32_t GROUP_KEY_PEER_POS = 11U;
+constexpr int32_t SMEM_GROUP_RELAY_CONNECT_RETRY = 1000; // 1ms apart, the relay is up before anyone connects
+
 constexpr int32_t GROUP_DYNAMIC_SIZE_BIT_LEN = 30;
 constexpr uint32_t GROUP_DYNAMIC_SIZE_BIT_MASK = (1 << 30) - 1;
 
@@ -50,6 +66,53 @@ static int64_t MergeSizeAndVersion(int32_t ver, int32_t size)
     return ((1LL * unsignedVer) << GROUP_DYNAMIC_SIZE_BIT_LEN) | unsignedSize;
 }
 
+/* ranks reach the same relay over loopback when they share both the kernel and the network namespace */
+static uint64_t HostIdentity()
+{
+    std::string identity;
+    std::ifstream bootId("/proc/sys/kernel/random/boot_id");
+    (void)std::getline(bootId, identity);
+    char netns[PATH_MAX] = {};
+    auto len = readlink("/proc/self/ns/net", netns, sizeof(netns) - 1);
+    if (len > 0) {
+        identity.append(netns, static_cast<size_t>(len));
+    }
+    if (identity.empty()) {
+        char host[HOST_NAME_MAX + 1] = {};
+        (void)gethostname(host, sizeof(host) - 1);
+        identity = host;
+    }
+
+    uint64_t hash = 14695981039346656037ULL; // FNV-1a 64
+    for (auto c : identity) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+/* a loopback server on a port picked by the kernel, the bound socket is handed to the store */
+static StorePtr CreateRelayServer(uint16_t magic, uint32_t &port)
+{
+    port = 0;
+    int sockFd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    SHM_VALIDATE_RETURN(sockFd >= 0, "create relay socket failed, errno: " << errno, nullptr);
+    struct sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (::bind(sockFd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0 ||
+        ::getsockname(sockFd, reinterpret_cast<struct sockaddr *>(&addr), &len) != 0) {
+        SHM_LOG_ERROR("bind relay socket failed, errno: " << errno);
+        (void)close(sockFd);
+        return nullptr;
+    }
+
+    auto store = StoreFactory::CreateStore(SMEM_GROUP_RELAY_IP, ntohs(addr.sin_port), true, 0, -1, sockFd, magic);
+    SHM_VALIDATE_RETURN(store != nullptr, "create relay store failed", nullptr);
+    port = ntohs(addr.sin_port);
+    return store;
+}
+
 SmemNetGroupEngine::~SmemNetGroupEngine()
 {
     groupStoped_ = true;
@@ -77,59 +140,57 @@ SmemGroupEnginePtr SmemNetGroupEngine::Create(const StorePtr &store, const SmemG
     return group.Get();
 }
 
+/* op(1) | group id(2) | version(4) | sn(4) | peer(4), 15 bytes stay inside the small string buffer */
+std::string SmemNetGroupEngine::GroupKey(GroupKeyOp op, uint32_t sn, uint32_t peer) const
+{
+    char buf[GROUP_KEY_SIZE];
+    auto version = static_cast<uint32_t>(groupVersion_);
+    buf[0] = static_cast<char>(op);
+    (void)memcpy(buf + GROUP_KEY_GROUP_POS, &option_.groupId, sizeof(option_.groupId));
+    (void)memcpy(buf + GROUP_KEY_VERSION_POS, &version, sizeof(version));
+    (void)memcpy(buf + GROUP_KEY_SN_POS, &sn, sizeof(sn));
+    (void)memcpy(buf + GROUP_KEY_PEER_POS, &peer, sizeof(peer));
+    return std::string(buf, sizeof(buf));
+}
+
+/* readable form of a group key for logs: {prefix}{op}{group}.{version}.{sn}.{peer} */
+std::string SmemNetGroupEngine::GroupKeyText(const StorePtr &store, const std::string &key)
+{
+    if (key.size() != GROUP_KEY_SIZE) {
+        return store->GetCompleteKey(key);
+    }
+    uint16_t groupId = 0;
+    uint32_t version = 0;
+    uint32_t sn = 0;
+    uint32_t peer = 0;
+    (void)memcpy(&groupId, key.data() + GROUP_KEY_GROUP_POS, sizeof(groupId));
+    (void)memcpy(&version, key.data() + GROUP_KEY_VERSION_POS, sizeof(version));
+    (void)memcpy(&sn, key.data() + GROUP_KEY_SN_POS, sizeof(sn));
+    (void)memcpy(&peer, key.data() + GROUP_KEY_PEER_POS, sizeof(peer));
+    return store->GetCompleteKey(std::string(1, key[0])) + std::to_string(groupId) + "." + std::to_string(version) +
+        "." + std::to_string(sn) + "." + std::to_string(peer);
+}
+
 Result SmemNetGroupEngine::GroupBarrier()
 {
     SHM_ASSERT_RETURN(store_ != nullptr, SM_INVALID_PARAM);
     uint32_t size = option_.rankSize;
-    std::string idx = std::to_string(groupVersion_) + "_" + std::to_string(++barrierGroupSn_);
-    std::string addKey = idx + "_BA";
-    std::string waitKey = idx + "_BW";
-    int64_t val = 0;
+    std::string barrierKey = GroupKey(GroupKeyOp::BARRIER, ++barrierGroupSn_);
 
+    /* one request per rank, the server counts arrivals and releases everybody when the last one comes in */
     MonoPerfTrace traceBarrier;
-    /* all guys add 1 to barrier key and get it */
-    MonoPerfTrace traceAdd;
-    auto ret = store_->Add(addKey, 1, val);
-    SHM_VALIDATE_RETURN(ret == SM_OK, "store add key: " << store_->GetCompleteKey(addKey)
-                        << " failed, result:" << ConfigStore::ErrStr(ret), SM_ERROR);
-
-    traceAdd.RecordEnd();
-    SHM_LOG_DEBUG("store add key: " << store_->GetCompleteKey(addKey) << " value: " << val);
-
-    /* only the first rank needs to clear the last key, and it's unnecessary to clear map for first time */
-    if (val == 1 && barrierGroupSn_ > REMOVE_INTERVAL) {
-        uint32_t removeBarrierGroupSn_ = barrierGroupSn_ - REMOVE_INTERVAL;
-        std::string removeAddIdx = std::to_string(groupVersion_) + "_" + std::to_string(removeBarrierGroupSn_) + "_BA";
-        std::string removeWaitIdx = std::to_string(groupVersion_) + "_" + std::to_string(removeBarrierGroupSn_) + "_BW";
-        /* There is no need to return ERROR, when the removed key is already not exist.
-        The WARNING LOG is contained in the remove func itself, no need to print more log. */
-        (void)store_->Remove(removeAddIdx);
-        (void)store_->Remove(removeWaitIdx);
-    }
-
-    /* the last guy set the status to ok, and other guys just wait for the last guy set the value */
-    if (val == size) {
-        ret = store_->Set(waitKey, SMEM_GROUP_SET_STR);
-        SHM_VALIDATE_RETURN(ret == SM_OK, "store set key: " << store_->GetCompleteKey(waitKey)
-                     << " failed, result:" << ConfigStore::ErrStr(ret), SM_ERROR);
-        SHM_LOG_DEBUG("store set key: " << store_->GetCompleteKey(waitKey));
+    Result ret;
+    if (relay_.nodeCount != 0U) {
+        ret = RelayBarrier(barrierKey, barrierGroupSn_);
+    } else {
+        ret = store_->Barrier(barrierKey, size, option_.timeoutMs);
     }
-
-    /* all guys wait for waitKey status with timeout, timeout happens if the ok status not set by the last guy */
-    MonoPerfTrace traceGetStatus;
-    std::string getVal;
-    ret = store_->Get(waitKey, getVal, option_.timeoutMs);
-    SHM_VALIDATE_RETURN(ret == SM_OK, "store get key: " << store_->GetCompleteKey(waitKey)
-                     << " failed, result:" << ConfigStore::ErrStr(ret), SM_ERROR);
-    traceGetStatus.RecordEnd();
-
-    SHM_VALIDATE_RETURN(getVal == SMEM_GROUP_SET_STR, "store get key: " << store_->GetCompleteKey(waitKey) <<
-                     " val is not equal, val: " << getVal << " expect: " << SMEM_GROUP_SET_STR, SM_ERROR);
+    SHM_VALIDATE_RETURN(ret == SM_OK, "store barrier key: " << GroupKeyText(store_, barrierKey)
+                        << " failed, result:" << ConfigStore::ErrStr(ret), SM_ERROR);
     traceBarrier.RecordEnd();
 
-    SHM_LOG_INFO("groupBarrier successfully, key: " << store_->GetCompleteKey(waitKey) << ", size: " <<
-        size << ", timeCostUs: total(" << traceBarrier.PeriodUs() << ") add(" << traceAdd.PeriodUs() <<
-        ") getStatus(" << traceGetStatus.PeriodUs() << ")");
+    SHM_LOG_INFO("groupBarrier successfully, sn: " << groupVersion_ << "." << barrierGroupSn_ << ", size: " <<
+        size << ", timeCostUs: total(" << traceBarrier.PeriodUs() << ")");
     return SM_OK;
 }
 
@@ -139,23 +200,6 @@ static inline void GatherFillRank(std::vector<uint8_t> &vec, uint32_t rank)
     *st = rank;
 }
 
-static void SortGatherRecv(std::vector<uint8_t> &vec, uint32_t preSize, uint32_t rankSize, char *recvBuf)
-{
-    std::vector<std::pair<uint32_t, uint32_t>> offset(rankSize);
-    uint32_t unitSize = preSize + SMEM_GATHER_PREFIX_SIZE;
-    uint8_t *ptr = vec.data();
-    for (uint32_t i = 0; i < rankSize; i++) {
-        uint32_t idx = i * unitSize;
-        std::copy_n(reinterpret_cast<uint32_t *>(ptr + idx), 1, &offset[i].first);
-        offset[i].second = idx + SMEM_GATHER_PREFIX_SIZE;
-    }
-
-    std::sort(offset.begin(), offset.end());
-    for (uint32_t i = 0; i < rankSize; i++) {
-        (void)std::copy_n(ptr + offset[i].second, preSize, recvBuf + preSize * i);
-    }
-}
-
 Result SmemNetGroupEngine::GroupBroadcastExit(int status)
 {
     SHM_ASSERT_RETURN(store_ != nullptr, SM_INVALID_PARAM);
@@ -210,75 +254,374 @@ Result SmemNetGroupEngine::GroupAllGather(const char *sendBuf, uint32_t sendSize
     uint32_t size = option_.rankSize;
     SHM_ASSERT_RETURN(sendSize * size == recvSize, SM_INVALID_PARAM);
 
-    std::string idx = std::to_string(groupVersion_) + "_" + std::to_string(++allGatherGroupSn_);
-    std::string addKey = idx + "_GA";
-    std::string waitKey = idx + "_GW";
-
-    std::vector<uint8_t> input(sendSize + SMEM_GATHER_PREFIX_SIZE);
-    GatherFillRank(input, option_.rank);
-    (void)std::copy_n(sendBuf, sendSize, input.data() + SMEM_GATHER_PREFIX_SIZE);
+    std::string gatherKey = GroupKey(GroupKeyOp::GATHER, ++allGatherGroupSn_);
 
+    /* the server places every block at its rank offset and replies once all ranks arrived */
     MonoPerfTrace traceAllGather;
-    /* append things and get the length of value */
+    if (relay_.nodeCount != 0U) {
+        auto ret = RelayAllGather(gatherKey, allGatherGroupSn_, sendBuf, sendSize, recvBuf);
+        SHM_VALIDATE_RETURN(ret == SM_OK, "relay gather key: " << GroupKeyText(store_, gatherKey)
+                            << " failed, result:" << ConfigStore::ErrStr(ret), SM_ERROR);
+        traceAllGather.RecordEnd();
+        SHM_LOG_INFO("allGather through relay successfully, sn: " << groupVersion_ << "." << allGatherGroupSn_ <<
+            ", rank: " << option_.rank << ", size: " << size << ", timeCostUs: total(" <<
+            traceAllGather.PeriodUs() << ")");
+        return SM_OK;
+    }
+    std::vector<uint8_t> input(sendBuf, sendBuf + sendSize);
+    std::vector<uint8_t> output;
+    auto ret = store_->Gather(gatherKey, option_.rank, size, input, output, option_.timeoutMs);
+    if (ret != SM_OK || output.size() != recvSize) {
+        SHM_LOG_ERROR("store gather key: " << GroupKeyText(store_, gatherKey)
+                      << " failed, result:" << ConfigStore::ErrStr(ret)
+                      << " recv_size: " << output.size() << " expect_size:" << recvSize);
+        return SM_ERROR;
+    }
+    (void)std::copy_n(output.data(), recvSize, recvBuf);
+    traceAllGather.RecordEnd();
+
+    SHM_LOG_INFO("allGather successfully, sn: " << groupVersion_ << "." << allGatherGroupSn_ << ", rank: " <<
+        option_.rank << ", size: " << size << ", timeCostUs: total(" << traceAllGather.PeriodUs() << ")");
+
+    return SM_OK;
+}
+
+Result SmemNetGroupEngine::StartNodeRelay(uint16_t magic)
+{
+    SHM_ASSERT_RETURN(store_ != nullptr && !option_.dynamic, SM_INVALID_PARAM);
+    uint32_t size = option_.rankSize;
+    uint64_t identity = HostIdentity();
+    std::vector<uint64_t> identities(size);
+    auto ret = GroupAllGather(reinterpret_cast<const char *>(&identity), sizeof(identity),
+                              reinterpret_cast<char *>(identities.data()), sizeof(identity) * size);
+    SHM_VALIDATE_RETURN(ret == SM_OK, "gather host identity failed, result:" << ret, ret);
+
+    /* nodes are numbered in the order of their lowest rank */
+    std::unordered_map<uint64_t, uint32_t> nodes;
+    std::vector<uint32_t> nodeOfRank(size);
+    for (uint32_t rank = 0; rank < size; rank++) {
+        auto node = static_cast<uint32_t>(nodes.size());
+        nodeOfRank[rank] = nodes.emplace(identities[rank], node).first->second;
+    }
+    return StartNodeRelay(nodeOfRank, magic);
+}
+
+Result SmemNetGroupEngine::StartNodeRelay(const std::vector<uint32_t> &nodeOfRank, uint16_t magic)
+{
+    SHM_ASSERT_RETURN(store_ != nullptr && !option_.dynamic, SM_INVALID_PARAM);
+    uint32_t size = option_.rankSize;
+    SHM_ASSERT_RETURN(nodeOfRank.size() == size && option_.rank < size, SM_INVALID_PARAM);
+
+    NodeRelay relay;
+    relay.nodeCount = *std::max_element(nodeOfRank.begin(), nodeOfRank.end()) + 1U;
+    SHM_ASSERT_RETURN(relay.nodeCount <= size, SM_INVALID_PARAM);
+    std::vector<uint32_t> localSizes(relay.nodeCount, 0);
+    relay.slotOf.resize(size);
+    for (uint32_t rank = 0; rank < size; rank++) {
+        relay.slotOf[rank] = localSizes[nodeOfRank[rank]]++;
+    }
+    relay.maxLocalSize = *std::max_element(localSizes.begin(), localSizes.end());
+    SHM_VALIDATE_RETURN(std::count(localSizes.begin(), localSizes.end(), 0U) == 0, "node ids are not dense",
+                        SM_INVALID_PARAM);
+    for (uint32_t rank = 0; rank < size; rank++) {
+        relay.slotOf[rank] += nodeOfRank[rank] * relay.maxLocalSize;
+    }
+    relay.nodeIndex = nodeOfRank[option_.rank];
+    relay.localRank = relay.slotOf[option_.rank] - relay.nodeIndex * relay.maxLocalSize;
+    relay.localSize = localSizes[relay.nodeIndex];
+    if (relay.nodeCount == 1U || relay.maxLocalSize == 1U) {
+        SHM_LOG_INFO("group of " << size << " ranks on " << relay.nodeCount << " nodes, relay is not needed");
+        return SM_OK;
+    }
+
+    /*
+     * the relay of every node with more than one rank serves it, then the ports and the connect results are
+     * shared so that all ranks agree. a node of one rank has nothing to relay and talks to the group store only
+     */
+    uint32_t port = 0;
+    StorePtr nodeStore = nullptr;
+    if (relay.localRank == 0 && relay.localSize > 1U) {
+        nodeStore = CreateRelayServer(magic, port);
+    }
+    std::vector<uint32_t> ports(size);
+    auto ret = GroupAllGather(reinterpret_cast<const char *>(&port), sizeof(port),
+                              reinterpret_cast<char *>(ports.data()), sizeof(port) * size);
+    SHM_VALIDATE_RETURN(ret == SM_OK, "gather relay port failed, result:" << ret, ret);
+    std::vector<uint32_t> relayPorts(relay.nodeCount, 0);
+    for (uint32_t rank = 0; rank < size; rank++) {
+        relayPorts[nodeOfRank[rank]] = std::max(relayPorts[nodeOfRank[rank]], ports[rank]);
+    }
+    bool relayUp = true;
+    for (uint32_t node = 0; node < relay.nodeCount; node++) {
+        relayUp = relayUp && (localSizes[node] == 1U || relayPorts[node] != 0U);
+    }
+    if (relayUp && relay.localRank != 0) {
+        nodeStore = StoreFactory::CreateStore(SMEM_GROUP_RELAY_IP, static_cast<uint16_t>(relayPorts[relay.nodeIndex]),
+                                              false, relay.localRank, SMEM_GROUP_RELAY_CONNECT_RETRY, -1, magic);
+    }
+    uint32_t connected = (relayUp && (relay.localSize == 1U || nodeStore != nullptr)) ? 1U : 0U;
+    std::vector<uint32_t> connects(size);
+    ret = GroupAllGather(reinterpret_cast<const char *>(&connected), sizeof(connected),
+                         reinterpret_cast<char *>(connects.data()), sizeof(connected) * size);
+    SHM_VALIDATE_RETURN(ret == SM_OK, "gather relay connection failed, result:" << ret, ret);
+    if (std::count(connects.begin(), connects.end(), 0U) != 0) {
+        SHM_LOG_WARN("some relay is not reachable, group of " << size << " ranks stays flat");
+        return SM_OK;
+    }
+
+    if (relay.localSize > 1U) {
+        relay.store = StoreFactory::PrefixStore(nodeStore, SMEM_GROUP_RELAY_PREFIX);
+        SHM_ASSERT_RETURN(relay.store != nullptr, SM_ERROR);
+    }
+    relay_ = std::move(relay);
+    SHM_LOG_INFO("group relay started, rank: " << option_.rank << ", node: " << relay_.nodeIndex << "/" <<
+        relay_.nodeCount << ", local rank: " << relay_.localRank << "/" << relay_.localSize);
+    return SM_OK;
+}
+
+/* the node meets on its relay, the relays meet on the group store, then every relay releases its node */
+Result SmemNetGroupEngine::RelayBarrier(const std::string &barrierKey, uint32_t sn)
+{
+    Result ret;
+    if (relay_.localSize > 1U) {
+        ret = relay_.store->Barrier(barrierKey, relay_.localSize, option_.timeoutMs);
+        SHM_VALIDATE_RETURN(ret == SM_OK, "node barrier key: " << GroupKeyText(relay_.store, barrierKey)
+                            << " failed, result:" << ConfigStore::ErrStr(ret), ret);
+    }
+
+    std::string releaseKey = GroupKey(GroupKeyOp::BARRIER_RELEASE, sn);
+    if (relay_.localRank != 0) {
+        std::string getVal;
+        ret = relay_.store->Get(releaseKey, getVal, option_.timeoutMs);
+        SHM_VALIDATE_RETURN(ret == SM_OK && getVal == SMEM_GROUP_SET_STR, "node release key: "
+                            << GroupKeyText(relay_.store, releaseKey) << " failed, result:"
+                            << ConfigStore::ErrStr(ret), SM_ERROR);
+        return SM_OK;
+    }
+
+    ret = store_->Barrier(barrierKey, relay_.nodeCount, option_.timeoutMs);
+    SHM_VALIDATE_RETURN(ret == SM_OK, "relay barrier key: " << GroupKeyText(store_, barrierKey)
+                        << " failed, result:" << ConfigStore::ErrStr(ret), ret);
+    if (relay_.localSize == 1U) {
+        return SM_OK;
+    }
+    return RelayRelease(releaseKey, std::vector<uint8_t>(SMEM_GROUP_SET_STR.begin(), SMEM_GROUP_SET_STR.end()),
+                        GroupKey(GroupKeyOp::BARRIER_RELEASE, sn - 1U));
+}
+
+/*
+ * the node gathers its blocks on the relay, the relays gather one padded node block each on the group store,
+ * every rank then picks the blocks out of the group result in rank order
+ */
+Result SmemNetGroupEngine::RelayAllGather(const std::string &gatherKey, uint32_t sn, const char *sendBuf,
+                                          uint32_t sendSize, char *recvBuf)
+{
+    std::vector<uint8_t> input(sendBuf, sendBuf + sendSize);
+    std::vector<uint8_t> nodeBlocks;
+    Result ret;
+    if (relay_.localSize > 1U) {
+        ret = relay_.store->Gather(gatherKey, relay_.localRank, relay_.localSize, input, nodeBlocks,
+                                   option_.timeoutMs);
+        SHM_VALIDATE_RETURN(ret == SM_OK, "node gather key: " << GroupKeyText(relay_.store, gatherKey)
+                            << " failed, result:" << ConfigStore::ErrStr(ret), ret);
+    } else {
+        nodeBlocks.swap(input);
+    }
+
+    std::vector<uint8_t> output;
+    std::string releaseKey = GroupKey(GroupKeyOp::GATHER_RELEASE, sn);
+    if (relay_.localRank != 0) {
+        ret = relay_.store->Get(releaseKey, output, option_.timeoutMs);
+        SHM_VALIDATE_RETURN(ret == SM_OK, "node release key: " << GroupKeyText(relay_.store, releaseKey)
+                            << " failed, result:" << ConfigStore::ErrStr(ret), ret);
+    } else {
+        nodeBlocks.resize(static_cast<uint64_t>(relay_.maxLocalSize) * sendSize);
+        ret = store_->Gather(gatherKey, relay_.nodeIndex, relay_.nodeCount, nodeBlocks, output, option_.timeoutMs);
+        SHM_VALIDATE_RETURN(ret == SM_OK, "relay gather key: " << GroupKeyText(store_, gatherKey)
+                            << " failed, result:" << ConfigStore::ErrStr(ret), ret);
+        if (relay_.localSize > 1U) {
+            ret = RelayRelease(releaseKey, output, GroupKey(GroupKeyOp::GATHER_RELEASE, sn - 1U));
+            SHM_VALIDATE_RETURN(ret == SM_OK, "relay release failed, result:" << ret, ret);
+        }
+    }
+
+    uint64_t expectSize = static_cast<uint64_t>(relay_.nodeCount) * relay_.maxLocalSize * sendSize;
+    SHM_VALIDATE_RETURN(output.size() == expectSize, "relay gather recv_size: " << output.size()
+                        << " expect_size: " << expectSize, SM_ERROR);
+    for (uint32_t rank = 0; rank < option_.rankSize; rank++) {
+        (void)std::copy_n(output.data() + static_cast<uint64_t>(relay_.slotOf[rank]) * sendSize, sendSize,
+                          recvBuf + static_cast<uint64_t>(rank) * sendSize);
+    }
+    return SM_OK;
+}
+
+/* publish the result to the node and drop the previous one, every local rank has read it before arriving here */
+Result SmemNetGroupEngine::RelayRelease(const std::string &releaseKey, const std::vector<uint8_t> &value,
+                                        const std::string &prevKey)
+{
+    std::vector<StoreMultiOp> ops{{MessageType::SET, releaseKey, value}, {MessageType::REMOVE, prevKey}};
+    auto ret = relay_.store->Multi(ops);
+    SHM_VALIDATE_RETURN(ret == SM_OK && ops[0].result == SM_OK, "node release key: "
+                        << GroupKeyText(relay_.store, releaseKey) << " failed, result:"
+                        << ConfigStore::ErrStr(ret == SM_OK ? ops[0].result : ret), SM_ERROR);
+    return SM_OK;
+}
+
+/* one MULTI with the queued appends; the last value a sender sees for a receiver is its appended length or count */
+Result SmemNetGroupEngine::AllToAllSend(std::vector<StoreMultiOp> &ops, std::vector<uint32_t> &dsts, uint32_t sn,
+                                        uint64_t complete)
+{
+    auto ret = store_->Multi(ops);
+    SHM_VALIDATE_RETURN(ret == SM_OK, "store multi append to " << dsts.size() << " ranks failed, result:"
+                        << ConfigStore::ErrStr(ret), SM_ERROR);
+
+    size_t stride = ops.size() / dsts.size();
+    std::vector<StoreMultiOp> waits;
+    for (size_t i = 0; i < dsts.size(); i++) {
+        auto &append = ops[i * stride];
+        auto &last = ops[i * stride + stride - 1U];
+        SHM_VALIDATE_RETURN(append.result == SM_OK && last.result == SM_OK, "store append key: "
+                            << GroupKeyText(store_, append.key) << " failed, result:"
+                            << ConfigStore::ErrStr(append.result == SM_OK ? last.result : append.result), SM_ERROR);
+        long value = 0;
+        SHM_VALIDATE_RETURN(StrToLong(std::string(last.value.begin(), last.value.end()), value),
+                            "store append key: " << GroupKeyText(store_, append.key) << " got invalid result", SM_ERROR);
+        if (static_cast<uint64_t>(value) == complete) {
+            std::string waitKey = GroupKey(GroupKeyOp::ALL_TO_ALL_WAIT, sn, dsts[i]);
+            waits.push_back({MessageType::SET, waitKey, {SMEM_GROUP_SET_STR.begin(), SMEM_GROUP_SET_STR.end()}});
+        }
+    }
+    ops.clear();
+    dsts.clear();
+    if (waits.empty()) {
+        return SM_OK;
+    }
+
+    ret = store_->Multi(waits);
+    for (auto &wait : waits) {
+        SHM_VALIDATE_RETURN(ret == SM_OK && wait.result == SM_OK, "store set key: " << GroupKeyText(store_, wait.key)
+                            << " failed, result:" << ConfigStore::ErrStr(ret == SM_OK ? wait.result : ret), SM_ERROR);
+    }
+    return SM_OK;
+}
+
+/*
+ * every sender appends [rank | block] to the receiver's own key, so each rank only reads the bytes addressed to it.
+ * all of a rank's appends go to the server in one MULTI request, split only where it would pass the message size
+ * limit. with uniform sizes the sender that makes the key complete sees it from the appended length,
+ * otherwise the senders count themselves on a separate key, in the same MULTI right after their append.
+ */
+Result SmemNetGroupEngine::AllToAllImpl(const char *sendBuf, const uint32_t *sendSizes, char *recvBuf,
+                                        const uint32_t *recvSizes, bool uniform)
+{
+    SHM_ASSERT_RETURN(store_ != nullptr, SM_INVALID_PARAM);
+    uint32_t size = option_.rankSize;
+    uint32_t rank = option_.rank;
+    SHM_ASSERT_RETURN(rank < size, SM_INVALID_PARAM);
+    SHM_ASSERT_RETURN(sendSizes[rank] == recvSizes[rank], SM_INVALID_PARAM);
+
+    std::vector<uint64_t> sendOffset(size + 1, 0);
+    std::vector<uint64_t> recvOffset(size + 1, 0);
+    for (uint32_t i = 0; i < size; i++) {
+        sendOffset[i + 1] = sendOffset[i] + sendSizes[i];
+        recvOffset[i + 1] = recvOffset[i] + recvSizes[i];
+    }
+    (void)std::copy_n(sendBuf + sendOffset[rank], sendSizes[rank], recvBuf + recvOffset[rank]);
+    if (size == 1) {
+        return SM_OK;
+    }
+
+    uint32_t sn = ++allToAllGroupSn_;
+    MonoPerfTrace traceAllToAll;
+    /* send: append to the receivers' keys, the one who completes a key sets that receiver's ok status */
     MonoPerfTrace traceAppend;
-    uint64_t val = 0;
-    auto ret = store_->Append(addKey, input, val);
-    SHM_VALIDATE_RETURN(ret == SM_OK, "store add key: " << store_->GetCompleteKey(addKey)
-                       << " failed, result:" << ConfigStore::ErrStr(ret), SM_ERROR);
+    uint64_t complete = uniform ? (static_cast<uint64_t>(sendSizes[rank]) + SMEM_GATHER_PREFIX_SIZE) * (size - 1) :
+                                  size - 1;
+    std::vector<StoreMultiOp> ops;
+    std::vector<uint32_t> dsts;
+    uint64_t batchSize = 0;
+    for (uint32_t k = 1; k < size; k++) {
+        uint32_t dst = (rank + k) % size;
+        std::vector<uint8_t> input(sendSizes[dst] + SMEM_GATHER_PREFIX_SIZE);
+        GatherFillRank(input, rank);
+        (void)std::copy_n(sendBuf + sendOffset[dst], sendSizes[dst], input.data() + SMEM_GATHER_PREFIX_SIZE);
+        uint64_t opSize = input.size() + SMEM_ALL_TO_ALL_OP_OVERHEAD;
+        if (!dsts.empty() && batchSize + opSize > MAX_VALUE_SIZE) {
+            auto ret = AllToAllSend(ops, dsts, sn, complete);
+            SHM_VALIDATE_RETURN(ret == SM_OK, "allToAll send failed, result:" << ret, ret);
+            batchSize = 0;
+        }
+        ops.push_back({MessageType::APPEND, GroupKey(GroupKeyOp::ALL_TO_ALL_DATA, sn, dst), std::move(input)});
+        if (!uniform) {
+            ops.push_back({MessageType::ADD, GroupKey(GroupKeyOp::ALL_TO_ALL_COUNT, sn, dst), {'1'}});
+        }
+        dsts.push_back(dst);
+        batchSize += opSize;
+    }
+    auto ret = AllToAllSend(ops, dsts, sn, complete);
+    SHM_VALIDATE_RETURN(ret == SM_OK, "allToAll send failed, result:" << ret, ret);
     traceAppend.RecordEnd();
 
-    /* only the first rank needs to clear the last key, and it's unnecessary to clear map for first time */
-    if (val == input.size() && allGatherGroupSn_ > REMOVE_INTERVAL) {
-        uint32_t rmAllGatherGroupSn_ = allGatherGroupSn_- REMOVE_INTERVAL;
-        std::string removeAddIdx = std::to_string(groupVersion_) + "_" + std::to_string(rmAllGatherGroupSn_) + "_GA";
-        std::string removeWaitIdx = std::to_string(groupVersion_) + "_" + std::to_string(rmAllGatherGroupSn_) + "_GW";
-        /* There is no need to return ERROR, when the removed key is already not exist.
-        The WARNING LOG is contained in the remove func itself, no need to print more log. */
-        (void)store_->Remove(removeAddIdx);
-        (void)store_->Remove(removeWaitIdx);
-    }
-    /* the last guy set ok status */
-    if (val == input.size() * size) {
-        ret = store_->Set(waitKey, SMEM_GROUP_SET_STR);
-        SHM_VALIDATE_RETURN(ret == SM_OK, "store set key: " << store_->GetCompleteKey(waitKey)
-                         << " failed, result:" << ConfigStore::ErrStr(ret), SM_ERROR);
-    }
-
-    /* all guys wait for ok status with timeout */
-    MonoPerfTrace traceGetStatus;
+    /* receive: wait for own ok status, then read only the blocks addressed to this rank */
+    MonoPerfTrace traceGetData;
+    std::string dataKey = GroupKey(GroupKeyOp::ALL_TO_ALL_DATA, sn, rank);
+    std::string waitKey = GroupKey(GroupKeyOp::ALL_TO_ALL_WAIT, sn, rank);
     std::string getVal;
     ret = store_->Get(waitKey, getVal, option_.timeoutMs);
-    SHM_VALIDATE_RETURN(ret == SM_OK, "store get key: " << store_->GetCompleteKey(waitKey)
-                << " failed, result:" << ConfigStore::ErrStr(ret), SM_ERROR);
-    traceGetStatus.RecordEnd();
-
-    SHM_VALIDATE_RETURN(getVal == SMEM_GROUP_SET_STR, "store get key: " << store_->GetCompleteKey(waitKey)
-                     << " val is not equal, val: " << getVal << " expect: " << SMEM_GROUP_SET_STR, SM_ERROR);
-
-    /* get the whole value */
-    MonoPerfTrace traceGetData;
+    SHM_VALIDATE_RETURN(ret == SM_OK && getVal == SMEM_GROUP_SET_STR, "store get key: "
+                        << GroupKeyText(store_, waitKey) << " failed, result:" << ConfigStore::ErrStr(ret), SM_ERROR);
     std::vector<uint8_t> output;
-    ret = store_->Get(addKey, output, option_.timeoutMs);
-    if (ret != SM_OK || output.size() != input.size() * size) {
-        SHM_LOG_ERROR("after wait, store get key: " << store_->GetCompleteKey(addKey)
-                      << " failed, result:" << ConfigStore::ErrStr(ret)
-                      << " recv_size: " << output.size() << " input_size:" << input.size()
-                      << " group_size:" << size);
+    ret = store_->Get(dataKey, output, option_.timeoutMs);
+    uint64_t expectSize = recvOffset[size] - recvSizes[rank] + static_cast<uint64_t>(SMEM_GATHER_PREFIX_SIZE) * (size - 1);
+    if (ret != SM_OK || output.size() != expectSize) {
+        SHM_LOG_ERROR("after wait, store get key: " << GroupKeyText(store_, dataKey) << " failed, result:"
+                      << ConfigStore::ErrStr(ret) << " recv_size: " << output.size() << " expect_size: " << expectSize);
         return SM_ERROR;
     }
-    traceGetData.RecordEnd();
-    traceAllGather.RecordEnd();
 
-    SortGatherRecv(output, sendSize, size, recvBuf);
+    uint64_t pos = 0;
+    for (uint32_t k = 1; k < size; k++) {
+        uint32_t src = 0;
+        std::copy_n(reinterpret_cast<uint32_t *>(output.data() + pos), 1, &src);
+        pos += SMEM_GATHER_PREFIX_SIZE;
+        if (src >= size || src == rank || pos + recvSizes[src] > output.size()) {
+            SHM_LOG_ERROR("allToAll key: " << GroupKeyText(store_, dataKey) << " has invalid block from rank " << src);
+            return SM_ERROR;
+        }
+        (void)std::copy_n(output.data() + pos, recvSizes[src], recvBuf + recvOffset[src]);
+        pos += recvSizes[src];
+    }
+    traceGetData.RecordEnd();
 
-    SHM_LOG_INFO("allGather successfully, key: " << store_->GetCompleteKey(addKey) << ", rank: " << option_.rank <<
-        ", size: " << size << ", timeCostUs: total(" << traceAllGather.PeriodUs() << ") append(" <<
-        traceAppend.PeriodUs() << ") getStatus(" << traceGetStatus.PeriodUs() << ") getData(" <<
-        traceGetData.PeriodUs() << ")");
+    /* nobody else touches this rank's keys any more */
+    std::vector<StoreMultiOp> removes{{MessageType::REMOVE, dataKey}, {MessageType::REMOVE, waitKey}};
+    if (!uniform) {
+        removes.push_back({MessageType::REMOVE, GroupKey(GroupKeyOp::ALL_TO_ALL_COUNT, sn, rank)});
+    }
+    (void)store_->Multi(removes);
+    traceAllToAll.RecordEnd();
 
+    SHM_LOG_INFO("allToAll successfully, sn: " << groupVersion_ << "." << sn << ", size: " << size <<
+        ", timeCostUs: total(" << traceAllToAll.PeriodUs() << ") append(" << traceAppend.PeriodUs() <<
+        ") getData(" << traceGetData.PeriodUs() << ")");
     return SM_OK;
 }
 
+Result SmemNetGroupEngine::GroupAllToAllV(const char *sendBuf, const uint32_t *sendSizes, char *recvBuf,
+                                          const uint32_t *recvSizes)
+{
+    SHM_ASSERT_RETURN(sendBuf != nullptr && sendSizes != nullptr, SM_INVALID_PARAM);
+    SHM_ASSERT_RETURN(recvBuf != nullptr && recvSizes != nullptr, SM_INVALID_PARAM);
+    return AllToAllImpl(sendBuf, sendSizes, recvBuf, recvSizes, false);
+}
+
+Result SmemNetGroupEngine::GroupAllToAll(const char *sendBuf, uint32_t blockSize, char *recvBuf)
+{
+    SHM_ASSERT_RETURN(sendBuf != nullptr && recvBuf != nullptr, SM_INVALID_PARAM);
+    std::vector<uint32_t> sizes(option_.rankSize, blockSize);
+    return AllToAllImpl(sendBuf, sizes.data(), recvBuf, sizes.data(), true);
+}
+
 bool SmemNetGroupEngine::DealWithListenEvent(std::string& getVal, std::string& prevEvent)
 {
     if (getVal.empty()) {
@@ -522,19 +865,20 @@ void SmemNetGroupEngine::UpdateGroupVersion(int32_t ver)
     groupVersion_ = ver;
     allGatherGroupSn_ = 0;
     barrierGroupSn_ = 0;
+    allToAllGroupSn_ = 0;
 }
 
 void SmemNetGroupEngine::GroupSnClean()
 {
+    /* a completed gather or barrier is already dropped by the server, only a failed one is left behind.
+       All removals go in one MULTI request, missing keys are expected and not reported. */
+    std::vector<StoreMultiOp> removes;
     for (uint32_t i = 0; i < REMOVE_INTERVAL; i++) {
         if (allGatherGroupSn_ < i) {
             break;
         }
         uint32_t rmAllGatherGroupSn_ = allGatherGroupSn_ - i;
-        std::string removeAddIdx = std::to_string(groupVersion_) + "_" + std::to_string(rmAllGatherGroupSn_) + "_GA";
-        std::string removeWaitIdx = std::to_string(groupVersion_) + "_" + std::to_string(rmAllGatherGroupSn_) + "_GW";
-        (void)store_->Remove(removeAddIdx);
-        (void)store_->Remove(removeWaitIdx);
+        removes.push_back({MessageType::REMOVE, GroupKey(GroupKeyOp::GATHER, rmAllGatherGroupSn_)});
     }
 
     for (uint32_t i = 0; i < REMOVE_INTERVAL; i++) {
@@ -542,11 +886,9 @@ void SmemNetGroupEngine::GroupSnClean()
             break;
         }
         uint32_t removeBarrierGroupSn_ = barrierGroupSn_ - i;
-        std::string removeAddIdx = std::to_string(groupVersion_) + "_" + std::to_string(removeBarrierGroupSn_) + "_BA";
-        std::string removeWaitIdx = std::to_string(groupVersion_) + "_" + std::to_string(removeBarrierGroupSn_) + "_BW";
-        (void)store_->Remove(removeAddIdx);
-        (void)store_->Remove(removeWaitIdx);
+        removes.push_back({MessageType::REMOVE, GroupKey(GroupKeyOp::BARRIER, removeBarrierGroupSn_)});
     }
+    (void)store_->Multi(removes);
 }
 
 }  // namespace store
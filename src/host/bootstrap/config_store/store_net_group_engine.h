@@ -12,6 +12,7 @@
 #define STORE_NET_GROUP_ENGINE_H
 
 #include <functional>
+#include <vector>
 #include "store_op.h"
 #include "store_timedwait.h"
 
@@ -31,6 +32,7 @@ const uint32_t REMOVE_INTERVAL = 2;
  * @param dynamic           [in] rankSize is dynamic (can join or leave some rank)
  * @param joinCb            [in] the callback which is called when some rank join
  * @param leaveCb           [in] the callback which is called when some rank leave
+ * @param groupId           [in] id packed into every collective key, groups sharing one store use different ids
  */
 struct SmemGroupOption {
     uint32_t rankSize;
@@ -40,6 +42,7 @@ struct SmemGroupOption {
     bool dynamic;
     SmemGroupChangeCallback joinCb;
     SmemGroupChangeCallback leaveCb;
+    uint16_t groupId = 0;
 };
 
 struct GroupListenContext {
@@ -66,8 +69,34 @@ public:
 
     Result GroupAllGather(const char *sendBuf, uint32_t sendSize, char *recvBuf, uint32_t recvSize);
 
+    /**
+     * @brief exchange one block with every rank, blocks are packed by rank in sendBuf/recvBuf
+     *        sendSizes[i] bytes go to rank i and recvSizes[i] bytes come from rank i
+     */
+    Result GroupAllToAllV(const char *sendBuf, const uint32_t *sendSizes, char *recvBuf, const uint32_t *recvSizes);
+
+    Result GroupAllToAll(const char *sendBuf, uint32_t blockSize, char *recvBuf);
+
     Result GroupBroadcastExit(int status);
 
+    /**
+     * @brief switch barrier and allgather of a static group to two levels, collective over the group.
+     *        Ranks sharing a host find each other by host identity, the lowest rank of each host serves a relay
+     *        store on loopback that its host meets on, and only the relays talk to the group store.
+     *        Only barrier and allgather go through the relays, every rank keeps its group store connection
+     *        for alltoall(v) and the exit broadcast, so the root still holds one link per rank.
+     *        The group stays flat if no host has more than one rank or any relay fails to come up
+     * @param magic             [in] session magic of the relay connections
+     */
+    Result StartNodeRelay(uint16_t magic);
+
+    /**
+     * @brief same as above with the host of every rank given
+     * @param nodeOfRank        [in] node id of each rank, ids are dense from 0
+     * @param magic             [in] session magic of the relay connections
+     */
+    Result StartNodeRelay(const std::vector<uint32_t> &nodeOfRank, uint16_t magic);
+
     Result RegisterExit(const std::function<void(int)> &exit);
 
     Result StartListenEvent();
@@ -83,18 +112,40 @@ public:
     void GroupSnClean();
 
 private:
+    /* kind of a collective key, printable so a raw key still tells what it is */
+    enum class GroupKeyOp : char {
+        BARRIER = 'B',
+        GATHER = 'G',
+        BARRIER_RELEASE = 'b',
+        GATHER_RELEASE = 'g',
+        ALL_TO_ALL_DATA = 'A',
+        ALL_TO_ALL_COUNT = 'C',
+        ALL_TO_ALL_WAIT = 'W',
+    };
+    static constexpr uint32_t GROUP_KEY_SIZE = 15U;
+
+    std::string GroupKey(GroupKeyOp op, uint32_t sn, uint32_t peer = 0) const;
+    static std::string GroupKeyText(const StorePtr &store, const std::string &key);
     void GroupListenEvent();
     Result TryCasEventKey(std::string &val);
     void UpdateGroupVersion(int32_t ver);
     void GroupWatchCb(int result, const std::string &key, const std::string &value);
     bool DealWithListenEvent(std::string& getVal, std::string& prevEvent);
     void RankExit(int result, const std::string &key, const std::string &value);
+    Result RelayBarrier(const std::string &barrierKey, uint32_t sn);
+    Result RelayAllGather(const std::string &gatherKey, uint32_t sn, const char *sendBuf, uint32_t sendSize,
+                          char *recvBuf);
+    Result RelayRelease(const std::string &releaseKey, const std::vector<uint8_t> &value, const std::string &prevKey);
+    Result AllToAllSend(std::vector<StoreMultiOp> &ops, std::vector<uint32_t> &dsts, uint32_t sn, uint64_t complete);
+    Result AllToAllImpl(const char *sendBuf, const uint32_t *sendSizes, char *recvBuf, const uint32_t *recvSizes,
+                        bool uniform);
 
     StorePtr store_ = nullptr;
     SmemGroupOption option_;
     int32_t groupVersion_ = 0;
     uint32_t allGatherGroupSn_ = 0;
     uint32_t barrierGroupSn_ = 0;
+    uint32_t allToAllGroupSn_ = 0;
 
     std::thread listenThread_;
     SmemTimedwait listenSignal_;
@@ -103,6 +154,18 @@ private:
     bool listenThreadStarted_ = false;
     bool groupStoped_ = false;
     std::function<void(int)> globalExitHandler_;
+
+    /* two level barrier and allgather, the relay of a node is its local rank 0 */
+    struct NodeRelay {
+        StorePtr store = nullptr;        // store served by the relay of this node, none on a node of one rank
+        uint32_t localRank = 0;
+        uint32_t localSize = 0;
+        uint32_t nodeIndex = 0;
+        uint32_t nodeCount = 0;          // 0 while the group is flat
+        uint32_t maxLocalSize = 0;       // every node contributes this many blocks to the group gather
+        std::vector<uint32_t> slotOf;    // block of each rank in the group gather, node * maxLocalSize + local rank
+    };
+    NodeRelay relay_;
 };
 
 inline uint32_t SmemNetGroupEngine::GetLocalRank() const
@@ -17,9 +17,11 @@
 #include <string>
 //#undef inline
 #include <functional>
+#include <future>
 
 #include "acc_def.h"
 #include "acc_tcp_server.h"
+#include "store_message_packer.h"
 #include "store_obj_ref.h"
 
 struct AcclinkTlsOption {
@@ -48,6 +50,15 @@ enum StoreErrorCode : int16_t {
     IO_ERROR = -602
 };
 
+/* one operation of ConfigStore::Multi */
+struct StoreMultiOp {
+    MessageType type;            /* SET, GET, ADD, REMOVE or APPEND */
+    std::string key;
+    std::vector<uint8_t> value;  /* in: SET/APPEND value or ADD increment as decimal string;
+                                    out: GET value, ADD sum or APPEND new size as decimal string */
+    int32_t result{StoreErrorCode::ERROR};
+};
+
 class ConfigStore : public SmReferable {
 public:
     ~ConfigStore() override = default;
@@ -165,6 +176,65 @@ public:
     virtual int32_t Cas(const std::string &key, const std::vector<uint8_t> &expect, const std::vector<uint8_t> &value,
                        std::vector<uint8_t> &exists) noexcept = 0;
 
+    /**
+     * @brief Gather one block per rank into <i>key</i> on the server. Returns once all <i>rankSize</i> ranks have
+     *        contributed, with the blocks laid out in rank order. All ranks must pass blocks of the same size.
+     * @param key          [in] key of this gather, must not be reused before all ranks returned
+     * @param rank         [in] rank of the caller, in [0, rankSize)
+     * @param rankSize     [in] number of ranks taking part
+     * @param value        [in] block of the caller
+     * @param output       [out] blocks of all ranks, rankSize * value.size() bytes
+     * @param timeoutMs    [in] timeout
+     * @return 0 if successfully done
+     */
+    virtual int32_t Gather(const std::string &key, uint32_t rank, uint32_t rankSize, const std::vector<uint8_t> &value,
+                           std::vector<uint8_t> &output, int64_t timeoutMs) noexcept = 0;
+
+    /**
+     * @brief Send a SET without waiting for the response
+     * @param key          [in] key to be set
+     * @param value        [in] value to be set
+     * @return future of the result, 0 if successfully done
+     */
+    virtual std::future<int32_t> SetAsync(const std::string &key, const std::vector<uint8_t> &value) noexcept = 0;
+
+    /**
+     * @brief Send a GET without waiting for the response
+     * @param key          [in] key to be got
+     * @param value        [out] value to be got, must stay valid until the future is ready
+     * @param timeoutMs    [in] timeout
+     * @return future of the result, 0 if successfully done
+     */
+    virtual std::future<int32_t> GetAsync(const std::string &key, std::vector<uint8_t> &value,
+                                          int64_t timeoutMs) noexcept = 0;
+
+    /**
+     * @brief Send an ADD without waiting for the response
+     * @param key          [in] key to be increased
+     * @param increment    [in] value to be increased
+     * @param value        [out] value after increased, must stay valid until the future is ready
+     * @return future of the result, 0 if successfully done
+     */
+    virtual std::future<int32_t> AddAsync(const std::string &key, int64_t increment, int64_t &value) noexcept = 0;
+
+    /**
+     * @brief Apply several SET/GET/ADD/REMOVE/APPEND operations in order with one request. GET does not wait for a
+     *        missing key. Each operation reports its own result in <i>ops</i>.
+     * @param ops          [in/out] operations to be applied
+     * @return 0 if the batch was applied, even if some operations failed
+     */
+    virtual int32_t Multi(std::vector<StoreMultiOp> &ops) noexcept = 0;
+
+    /**
+     * @brief Wait until <i>rankSize</i> callers arrived at the barrier <i>key</i>. The server drops the barrier once
+     *        it is released, so the key can be reused afterwards.
+     * @param key          [in] key of this barrier
+     * @param rankSize     [in] number of callers taking part
+     * @param timeoutMs    [in] timeout
+     * @return 0 if successfully done
+     */
+    virtual int32_t Barrier(const std::string &key, uint32_t rankSize, int64_t timeoutMs) noexcept = 0;
+
     /**
      * @brief Watch the specified non-existent key. When the key is created, the specified notify function is invoked.
      * @param key          [in] key to be watched
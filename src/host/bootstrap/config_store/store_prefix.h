@@ -29,28 +29,67 @@ public:
 
     Result Set(const std::string &key, const std::vector<uint8_t> &value) noexcept override
     {
-        return baseStore_->Set(std::string(keyPrefix_).append(key), value);
+        return baseStore_->Set(CompleteKey(key), value);
     }
 
     Result Add(const std::string &key, int64_t increment, int64_t &value) noexcept override
     {
-        return baseStore_->Add(std::string(keyPrefix_).append(key), increment, value);
+        return baseStore_->Add(CompleteKey(key), increment, value);
     }
 
     Result Remove(const std::string &key, bool printKeyNotExist) noexcept override
     {
-        return baseStore_->Remove(std::string(keyPrefix_).append(key), printKeyNotExist);
+        return baseStore_->Remove(CompleteKey(key), printKeyNotExist);
     }
 
     Result Append(const std::string &key, const std::vector<uint8_t> &value, uint64_t &newSize) noexcept override
     {
-        return baseStore_->Append(std::string(keyPrefix_).append(key), value, newSize);
+        return baseStore_->Append(CompleteKey(key), value, newSize);
     }
 
     Result Cas(const std::string &key, const std::vector<uint8_t> &expect, const std::vector<uint8_t> &value,
                std::vector<uint8_t> &exists) noexcept override
     {
-        return baseStore_->Cas(std::string(keyPrefix_).append(key), expect, value, exists);
+        return baseStore_->Cas(CompleteKey(key), expect, value, exists);
+    }
+
+    Result Gather(const std::string &key, uint32_t rank, uint32_t rankSize, const std::vector<uint8_t> &value,
+                  std::vector<uint8_t> &output, int64_t timeoutMs) noexcept override
+    {
+        return baseStore_->Gather(CompleteKey(key), rank, rankSize, value, output, timeoutMs);
+    }
+
+    std::future<Result> SetAsync(const std::string &key, const std::vector<uint8_t> &value) noexcept override
+    {
+        return baseStore_->SetAsync(CompleteKey(key), value);
+    }
+
+    std::future<Result> GetAsync(const std::string &key, std::vector<uint8_t> &value,
+                                 int64_t timeoutMs) noexcept override
+    {
+        return baseStore_->GetAsync(CompleteKey(key), value, timeoutMs);
+    }
+
+    std::future<Result> AddAsync(const std::string &key, int64_t increment, int64_t &value) noexcept override
+    {
+        return baseStore_->AddAsync(CompleteKey(key), increment, value);
+    }
+
+    Result Multi(std::vector<StoreMultiOp> &ops) noexcept override
+    {
+        for (auto &op : ops) {
+            op.key.insert(0, keyPrefix_);
+        }
+        auto ret = baseStore_->Multi(ops);
+        for (auto &op : ops) {
+            op.key.erase(0, keyPrefix_.size());
+        }
+        return ret;
+    }
+
+    Result Barrier(const std::string &key, uint32_t rankSize, int64_t timeoutMs) noexcept override
+    {
+        return baseStore_->Barrier(CompleteKey(key), rankSize, timeoutMs);
     }
 
     Result Watch(const std::string &key,
@@ -58,7 +97,7 @@ public:
                  uint32_t &wid) noexcept override
     {
         return baseStore_->Watch(
-            std::string(keyPrefix_).append(key),
+            CompleteKey(key),
             [key, notify](int result, const std::string &, const std::vector<uint8_t> &value) {
                 notify(result, key, value);
             },
@@ -72,7 +111,7 @@ public:
 
     std::string GetCompleteKey(const std::string &key) noexcept override
     {
-        return std::string(keyPrefix_).append(key);
+        return CompleteKey(key);
     }
 
     std::string GetCommonPrefix() noexcept override
@@ -88,10 +127,18 @@ public:
 protected:
     Result GetReal(const std::string &key, std::vector<uint8_t> &value, int64_t timeoutMs) noexcept override
     {
-        return baseStore_->Get(std::string(keyPrefix_).append(key), value, timeoutMs);
+        return baseStore_->Get(CompleteKey(key), value, timeoutMs);
     }
 
 private:
+    /* the base store reads the key before returning, a per thread buffer keeping its capacity serves every call */
+    const std::string &CompleteKey(const std::string &key) const noexcept
+    {
+        thread_local std::string completeKey;
+        completeKey.assign(keyPrefix_).append(key);
+        return completeKey;
+    }
+
     const StorePtr baseStore_;
     const std::string keyPrefix_;
 };
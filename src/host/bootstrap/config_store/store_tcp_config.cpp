@@ -94,8 +94,8 @@ public:
     {
         auto data = reinterpret_cast<const uint8_t *>(response.DataPtr());
 
-        SmemMessage responseBody;
-        auto ret = SmemMessagePacker::Unpack(data, response.DataLen(), responseBody);
+        SmemMessageView responseBody;
+        auto ret = SmemMessagePacker::UnpackView(data, response.DataLen(), responseBody);
         if (ret < 0) {
             SHM_LOG_ERROR("unpack response body failed, result: " << ret);
             notify_(IO_ERROR, std::vector<uint8_t>{});
@@ -109,7 +109,7 @@ public:
         }
 
         SHM_LOG_DEBUG("watch end, id: " << response.SeqNo());
-        notify_(SUCCESS, responseBody.values[0]);
+        notify_(SUCCESS, responseBody.values[0].ToVector());
     }
 
     void SetFailedFinish() noexcept override
@@ -126,6 +126,63 @@ private:
     std::function<void(int result, const std::vector<uint8_t> &)> notify_;
 };
 
+class ClientAsyncContext : public ClientCommonContext {
+public:
+    explicit ClientAsyncContext(std::function<Result(const shm::acc::AccTcpRequestContext &)> decode) noexcept
+        : decode_{std::move(decode)}
+    {
+    }
+
+    std::future<Result> GetFuture() noexcept
+    {
+        return promise_.get_future();
+    }
+
+    std::shared_ptr<shm::acc::AccTcpRequestContext> WaitFinished() noexcept override
+    {
+        return nullptr;
+    }
+
+    void SetFinished(const shm::acc::AccTcpRequestContext &response) noexcept override
+    {
+        promise_.set_value(decode_(response));
+    }
+
+    void SetFailedFinish() noexcept override
+    {
+        promise_.set_value(IO_ERROR);
+    }
+
+    // not a watch, Unwatch must not drop it
+    bool Blocking() const noexcept override
+    {
+        return true;
+    }
+
+private:
+    std::function<Result(const shm::acc::AccTcpRequestContext &)> decode_;
+    std::promise<Result> promise_;
+};
+
+static Result UnpackFirstValue(const shm::acc::AccTcpRequestContext &response, std::vector<uint8_t> &value) noexcept
+{
+    auto data = reinterpret_cast<const uint8_t *>(response.DataPtr());
+    SmemMessageView responseBody;
+    auto ret = SmemMessagePacker::UnpackView(data, response.DataLen(), responseBody);
+    if (ret < 0) {
+        SHM_LOG_ERROR("unpack response body failed, result: " << ret);
+        return -1;
+    }
+
+    if (responseBody.values.empty()) {
+        SHM_LOG_ERROR("response body has no value");
+        return -1;
+    }
+
+    value = responseBody.values[0].ToVector();
+    return 0;
+}
+
 std::atomic<uint32_t> TcpConfigStore::reqSeqGen_{0};
 TcpConfigStore::TcpConfigStore(std::string ip, uint16_t port, bool isServer, int32_t rankId, int32_t sockFd,
                                uint16_t magic) noexcept
@@ -146,7 +203,8 @@ TcpConfigStore::~TcpConfigStore() noexcept
 Result TcpConfigStore::AccClientStart(const AcclinkTlsOption &tlsOption) noexcept
 {
     shm::acc::AccTcpServerOptions options;
-    options.linkSendQueueSize = shm::acc::UNO_48;
+    options.linkSendQueueSize = AccStoreServer::LINK_SEND_QUEUE_SIZE;
+    options.workerBusyPollUs = AccStoreServer::WorkerBusyPollUs();
 
     shm::acc::AccTlsOption tlsOpt = ConvertTlsOption(tlsOption);
     Result result;
@@ -205,6 +263,10 @@ Result TcpConfigStore::Startup(const AcclinkTlsOption &tlsOption, int reconnectR
         0, [this](const shm::acc::AccTcpRequestContext &context) { return ReceiveResponseHandler(context); });
     accClient_->RegisterLinkBrokenHandler(
         [this](const shm::acc::AccTcpLinkComplexPtr &link) { return LinkBrokenHandler(link); });
+    accClient_->RegisterRequestSentHandler(
+        0, [this](shm::acc::AccMsgSentResult, const shm::acc::AccMsgHeader &, const shm::acc::AccDataBufferPtr &) {
+            return RequestSentHandler();
+        });
 
     if ((result = AccClientStart(tlsOption)) != SM_OK) {
         SHM_LOG_ERROR("start acc client failed, result: " << result);
@@ -254,12 +316,11 @@ Result TcpConfigStore::Set(const std::string &key, const std::vector<uint8_t> &v
         return StoreErrorCode::INVALID_KEY;
     }
 
-    SmemMessage request{MessageType::SET};
-    request.keys.push_back(key);
-    request.values.push_back(value);
+    SmemMessageView request{MessageType::SET};
+    request.keys.emplace_back(key);
+    request.values.emplace_back(value);
 
-    auto packedRequest = SmemMessagePacker::Pack(request);
-    auto response = SendMessageBlocked(packedRequest);
+    auto response = SendMessageBlocked(request);
     if (response == nullptr) {
         SHM_LOG_ERROR("send set for key: " << key << ", get null response");
         return IO_ERROR;
@@ -280,12 +341,11 @@ Result TcpConfigStore::GetReal(const std::string &key, std::vector<uint8_t> &val
         return StoreErrorCode::INVALID_KEY;
     }
 
-    SmemMessage request{MessageType::GET};
-    request.keys.push_back(key);
+    SmemMessageView request{MessageType::GET};
+    request.keys.emplace_back(key);
     request.userDef = timeoutMs;
 
-    auto packedRequest = SmemMessagePacker::Pack(request);
-    auto response = SendMessageBlocked(packedRequest, timeoutMs);
+    auto response = SendMessageBlocked(request, timeoutMs);
     if (response == nullptr) {
         SHM_LOG_ERROR("send get for key: " << key << ", get null response");
         return IO_ERROR;
@@ -299,21 +359,7 @@ Result TcpConfigStore::GetReal(const std::string &key, std::vector<uint8_t> &val
         return responseCode;
     }
 
-    auto data = reinterpret_cast<const uint8_t *>(response->DataPtr());
-    SmemMessage responseBody;
-    auto ret = SmemMessagePacker::Unpack(data, response->DataLen(), responseBody);
-    if (ret < 0) {
-        SHM_LOG_ERROR("unpack response body failed, result: " << ret);
-        return -1;
-    }
-
-    if (responseBody.values.empty()) {
-        SHM_LOG_ERROR("response body has no value");
-        return -1;
-    }
-
-    value = std::move(responseBody.values[0]);
-    return 0;
+    return UnpackFirstValue(*response, value);
 }
 
 Result TcpConfigStore::Add(const std::string &key, int64_t increment, int64_t &value) noexcept
@@ -323,13 +369,12 @@ Result TcpConfigStore::Add(const std::string &key, int64_t increment, int64_t &v
         return StoreErrorCode::INVALID_KEY;
     }
 
-    SmemMessage request{MessageType::ADD};
-    request.keys.push_back(key);
+    SmemMessageView request{MessageType::ADD};
+    request.keys.emplace_back(key);
     std::string inc = std::to_string(increment);
-    request.values.push_back(std::vector<uint8_t>(inc.begin(), inc.end()));
+    request.values.emplace_back(reinterpret_cast<const uint8_t *>(inc.data()), inc.size());
 
-    auto packedRequest = SmemMessagePacker::Pack(request);
-    auto response = SendMessageBlocked(packedRequest);
+    auto response = SendMessageBlocked(request);
     if (response == nullptr) {
         SHM_LOG_ERROR("send add for key: " << key << ", get null response");
         return StoreErrorCode::IO_ERROR;
@@ -353,11 +398,10 @@ Result TcpConfigStore::Remove(const std::string &key, bool printKeyNotExist) noe
         return StoreErrorCode::INVALID_KEY;
     }
 
-    SmemMessage request{MessageType::REMOVE};
-    request.keys.push_back(key);
+    SmemMessageView request{MessageType::REMOVE};
+    request.keys.emplace_back(key);
 
-    auto packedRequest = SmemMessagePacker::Pack(request);
-    auto response = SendMessageBlocked(packedRequest);
+    auto response = SendMessageBlocked(request);
     if (response == nullptr) {
         SHM_LOG_ERROR("send remove for key: " << key << ", get null response");
         return StoreErrorCode::IO_ERROR;
@@ -383,12 +427,11 @@ Result TcpConfigStore::Append(const std::string &key, const std::vector<uint8_t>
         return StoreErrorCode::INVALID_KEY;
     }
 
-    SmemMessage request{MessageType::APPEND};
-    request.keys.push_back(key);
-    request.values.push_back(value);
+    SmemMessageView request{MessageType::APPEND};
+    request.keys.emplace_back(key);
+    request.values.emplace_back(value);
 
-    auto packedRequest = SmemMessagePacker::Pack(request);
-    auto response = SendMessageBlocked(packedRequest);
+    auto response = SendMessageBlocked(request);
     if (response == nullptr) {
         SHM_LOG_ERROR("send append for key: " << key << ", get null response");
         return StoreErrorCode::IO_ERROR;
@@ -417,13 +460,12 @@ Result TcpConfigStore::Cas(const std::string &key, const std::vector<uint8_t> &e
         return StoreErrorCode::INVALID_KEY;
     }
 
-    SmemMessage request{MessageType::CAS};
-    request.keys.push_back(key);
-    request.values.push_back(expect);
-    request.values.push_back(value);
+    SmemMessageView request{MessageType::CAS};
+    request.keys.emplace_back(key);
+    request.values.emplace_back(expect);
+    request.values.emplace_back(value);
 
-    auto packedRequest = SmemMessagePacker::Pack(request);
-    auto response = SendMessageBlocked(packedRequest);
+    auto response = SendMessageBlocked(request);
     if (response == nullptr) {
         SHM_LOG_ERROR("send CAS for key: " << key << ", get null response");
         return StoreErrorCode::IO_ERROR;
@@ -435,21 +477,213 @@ Result TcpConfigStore::Cas(const std::string &key, const std::vector<uint8_t> &e
         return responseCode;
     }
 
+    return UnpackFirstValue(*response, exists);
+}
+
+Result TcpConfigStore::Gather(const std::string &key, uint32_t rank, uint32_t rankSize,
+                              const std::vector<uint8_t> &value, std::vector<uint8_t> &output,
+                              int64_t timeoutMs) noexcept
+{
+    if (key.empty() || key.length() > MAX_KEY_LEN_CLIENT) {
+        SHM_LOG_ERROR("key length is invalid");
+        return StoreErrorCode::INVALID_KEY;
+    }
+    if (rank >= rankSize) {
+        SHM_LOG_ERROR("gather for key: " << key << ", invalid rank: " << rank << ", rankSize: " << rankSize);
+        return StoreErrorCode::INVALID_MESSAGE;
+    }
+
+    SmemMessageView request{MessageType::GATHER};
+    request.keys.emplace_back(key);
+    request.values.emplace_back(value);
+    uint32_t position[] = {rank, rankSize};
+    request.values.emplace_back(reinterpret_cast<const uint8_t *>(position), sizeof(position));
+    request.userDef = timeoutMs;
+
+    auto response = SendMessageBlocked(request, timeoutMs);
+    if (response == nullptr) {
+        SHM_LOG_ERROR("send gather for key: " << key << ", get null response");
+        return StoreErrorCode::IO_ERROR;
+    }
+
+    auto responseCode = response->Header().result;
+    if (responseCode != 0) {
+        SHM_LOG_ERROR("send gather for key: " << key << ", resp code: " << responseCode << " timeout:" << timeoutMs);
+        return responseCode;
+    }
+
+    // the response body is the gathered blocks themselves, not a packed message
+    if (response->DataLen() != static_cast<uint64_t>(value.size()) * rankSize) {
+        SHM_LOG_ERROR("gather for key: " << key << ", response size: " << response->DataLen() << " mismatch");
+        return StoreErrorCode::ERROR;
+    }
     auto data = reinterpret_cast<const uint8_t *>(response->DataPtr());
-    SmemMessage responseBody;
-    auto ret = SmemMessagePacker::Unpack(data, response->DataLen(), responseBody);
-    if (ret < 0) {
-        SHM_LOG_ERROR("unpack response body failed, result: " << ret);
-        return -1;
+    output.assign(data, data + response->DataLen());
+    return StoreErrorCode::SUCCESS;
+}
+
+Result TcpConfigStore::Barrier(const std::string &key, uint32_t rankSize, int64_t timeoutMs) noexcept
+{
+    if (key.empty() || key.length() > MAX_KEY_LEN_CLIENT) {
+        SHM_LOG_ERROR("key length is invalid");
+        return StoreErrorCode::INVALID_KEY;
     }
 
-    if (responseBody.values.empty()) {
-        SHM_LOG_ERROR("response body has no value");
-        return -1;
+    SmemMessageView request{MessageType::BARRIER};
+    request.keys.emplace_back(key);
+    request.values.emplace_back(reinterpret_cast<const uint8_t *>(&rankSize), sizeof(rankSize));
+    request.userDef = timeoutMs;
+
+    auto response = SendMessageBlocked(request, timeoutMs);
+    if (response == nullptr) {
+        SHM_LOG_ERROR("send barrier for key: " << key << ", get null response");
+        return StoreErrorCode::IO_ERROR;
     }
 
-    exists = std::move(responseBody.values[0]);
-    return 0;
+    auto responseCode = response->Header().result;
+    if (responseCode != 0) {
+        SHM_LOG_ERROR("send barrier for key: " << key << ", resp code: " << responseCode << " timeout:" << timeoutMs);
+    }
+    return responseCode;
+}
+
+std::future<Result> TcpConfigStore::SetAsync(const std::string &key, const std::vector<uint8_t> &value) noexcept
+{
+    if (key.empty() || key.length() > MAX_KEY_LEN_CLIENT) {
+        SHM_LOG_ERROR("key length is invalid");
+        std::promise<Result> invalid;
+        invalid.set_value(StoreErrorCode::INVALID_KEY);
+        return invalid.get_future();
+    }
+
+    SmemMessageView request{MessageType::SET};
+    request.keys.emplace_back(key);
+    request.values.emplace_back(value);
+    return SendMessageAsync(request, [key](const shm::acc::AccTcpRequestContext &response) -> Result {
+        auto responseCode = response.Header().result;
+        if (responseCode != 0) {
+            SHM_LOG_ERROR("send set for key: " << key << ", get response code: " << responseCode);
+        }
+        return responseCode;
+    });
+}
+
+std::future<Result> TcpConfigStore::GetAsync(const std::string &key, std::vector<uint8_t> &value,
+                                             int64_t timeoutMs) noexcept
+{
+    if (key.empty() || key.length() > MAX_KEY_LEN_CLIENT) {
+        SHM_LOG_ERROR("key length is invalid");
+        std::promise<Result> invalid;
+        invalid.set_value(StoreErrorCode::INVALID_KEY);
+        return invalid.get_future();
+    }
+
+    SmemMessageView request{MessageType::GET};
+    request.keys.emplace_back(key);
+    request.userDef = timeoutMs;
+    return SendMessageAsync(request, [key, &value](const shm::acc::AccTcpRequestContext &response) -> Result {
+        auto responseCode = response.Header().result;
+        if (responseCode != 0) {
+            if (responseCode != NOT_EXIST) {
+                SHM_LOG_ERROR("send get for key: " << key << ", resp code: " << responseCode);
+            }
+            return responseCode;
+        }
+        return UnpackFirstValue(response, value);
+    });
+}
+
+std::future<Result> TcpConfigStore::AddAsync(const std::string &key, int64_t increment, int64_t &value) noexcept
+{
+    if (key.empty() || key.length() > MAX_KEY_LEN_CLIENT) {
+        SHM_LOG_ERROR("key length is invalid");
+        std::promise<Result> invalid;
+        invalid.set_value(StoreErrorCode::INVALID_KEY);
+        return invalid.get_future();
+    }
+
+    std::string inc = std::to_string(increment);
+    SmemMessageView request{MessageType::ADD};
+    request.keys.emplace_back(key);
+    request.values.emplace_back(reinterpret_cast<const uint8_t *>(inc.data()), inc.size());
+    return SendMessageAsync(request, [key, &value](const shm::acc::AccTcpRequestContext &response) -> Result {
+        auto responseCode = response.Header().result;
+        if (responseCode != 0) {
+            SHM_LOG_ERROR("send add for key: " << key << ", get response code: " << responseCode);
+            return responseCode;
+        }
+        std::string data(reinterpret_cast<char *>(response.DataPtr()), response.DataLen());
+        SHM_VALIDATE_RETURN(StrToLong(data, value), "convert string to long failed.", StoreErrorCode::ERROR);
+        return StoreErrorCode::SUCCESS;
+    });
+}
+
+Result TcpConfigStore::Multi(std::vector<StoreMultiOp> &ops) noexcept
+{
+    std::vector<uint8_t> packedOps;
+    for (auto &op : ops) {
+        if (op.key.empty() || op.key.length() > MAX_KEY_LEN_CLIENT) {
+            SHM_LOG_ERROR("key length is invalid");
+            return StoreErrorCode::INVALID_KEY;
+        }
+        SmemMessageView request{op.type};
+        request.keys.emplace_back(op.key);
+        if (op.type == MessageType::SET || op.type == MessageType::ADD || op.type == MessageType::APPEND) {
+            request.values.emplace_back(op.value);
+        } else if (op.type != MessageType::GET && op.type != MessageType::REMOVE) {
+            SHM_LOG_ERROR("multi for key: " << op.key << ", unsupported type: " << op.type);
+            return StoreErrorCode::INVALID_MESSAGE;
+        }
+        auto offset = packedOps.size();
+        packedOps.resize(offset + SmemMessagePacker::PackedSize(request));
+        SmemMessagePacker::PackTo(request, packedOps.data() + offset);
+    }
+    if (ops.empty()) {
+        return StoreErrorCode::SUCCESS;
+    }
+    if (packedOps.size() > MAX_VALUE_SIZE) {
+        SHM_LOG_ERROR("multi with " << ops.size() << " ops is too large: " << packedOps.size());
+        return StoreErrorCode::INVALID_MESSAGE;
+    }
+
+    SmemMessageView request{MessageType::MULTI};
+    request.values.emplace_back(packedOps);
+    auto response = SendMessageBlocked(request);
+    if (response == nullptr) {
+        SHM_LOG_ERROR("send multi with " << ops.size() << " ops, get null response");
+        return StoreErrorCode::IO_ERROR;
+    }
+
+    auto responseCode = response->Header().result;
+    if (responseCode != 0) {
+        SHM_LOG_ERROR("send multi with " << ops.size() << " ops, get response code: " << responseCode);
+        return responseCode;
+    }
+
+    // outcomes are read in place from the response body
+    SmemMessageView responseBody;
+    auto ret = SmemMessagePacker::UnpackView(reinterpret_cast<const uint8_t *>(response->DataPtr()),
+                                             response->DataLen(), responseBody);
+    if (ret < 0 || responseBody.values.size() != 1) {
+        SHM_LOG_ERROR("unpack multi response body failed, result: " << ret);
+        return StoreErrorCode::ERROR;
+    }
+    auto &results = responseBody.values[0];
+    uint64_t offset = 0;
+    for (auto &op : ops) {
+        SmemMessageView result;
+        auto length = SmemMessagePacker::UnpackView(results.data + offset, results.size - offset, result);
+        if (length <= 0 || result.values.size() != 1) {
+            SHM_LOG_ERROR("unpack multi result for key: " << op.key << " failed");
+            return StoreErrorCode::ERROR;
+        }
+        offset += static_cast<uint64_t>(length);
+        op.result = static_cast<int32_t>(result.userDef);
+        if (op.result == 0 && op.type != MessageType::SET && op.type != MessageType::REMOVE) {
+            op.value = result.values[0].ToVector();
+        }
+    }
+    return StoreErrorCode::SUCCESS;
 }
 
 Result TcpConfigStore::Watch(
@@ -462,12 +696,11 @@ Result TcpConfigStore::Watch(
         return StoreErrorCode::INVALID_KEY;
     }
 
-    SmemMessage request{MessageType::GET};
-    request.keys.push_back(key);
+    SmemMessageView request{MessageType::GET};
+    request.keys.emplace_back(key);
 
-    auto packedRequest = SmemMessagePacker::Pack(request);
     auto ret = SendWatchRequest(
-        packedRequest, [key, notify](int res, const std::vector<uint8_t> &value) { notify(res, key, value); }, wid);
+        request, [key, notify](int res, const std::vector<uint8_t> &value) { notify(res, key, value); }, wid);
     if (ret != SM_OK) {
         SHM_LOG_ERROR("send get for key: " << key << ", get null response");
         return ret;
@@ -499,7 +732,7 @@ Result TcpConfigStore::Unwatch(uint32_t wid) noexcept
 }
 
 std::shared_ptr<shm::acc::AccTcpRequestContext> TcpConfigStore::SendMessageBlocked(
-    const std::vector<uint8_t> &reqBody,
+    const SmemMessageView &request,
     int64_t timeoutMs) noexcept
 {
     if (accClientLink_ == nullptr) {
@@ -507,6 +740,12 @@ std::shared_ptr<shm::acc::AccTcpRequestContext> TcpConfigStore::SendMessageBlock
         return nullptr;
     }
 
+    auto dataBuf = SmemMessagePacker::PackBuffer(request);
+    if (dataBuf == nullptr) {
+        SHM_LOG_ERROR("pack request failed");
+        return nullptr;
+    }
+
     auto seqNo = reqSeqGen_.fetch_add(1U);
 
     auto waitContext = std::make_shared<ClientWaitContext>(timeoutMs);
@@ -515,7 +754,6 @@ std::shared_ptr<shm::acc::AccTcpRequestContext> TcpConfigStore::SendMessageBlock
     msgClientContext_.emplace(seqNo, waitContext);
     msgCtxLocker.unlock();
 
-    auto dataBuf = shm::acc::AccDataBuffer::Create(reqBody.data(), reqBody.size());
     auto ret = accClientLink_->NonBlockSend(0, seqNo, dataBuf, nullptr);
     if (ret != SM_OK) {
         SHM_LOG_ERROR("send message failed, result: " << ret);
@@ -532,6 +770,61 @@ std::shared_ptr<shm::acc::AccTcpRequestContext> TcpConfigStore::SendMessageBlock
     return response;
 }
 
+std::future<Result> TcpConfigStore::SendMessageAsync(
+    const SmemMessageView &request,
+    std::function<Result(const shm::acc::AccTcpRequestContext &)> decode) noexcept
+{
+    auto asyncContext = std::make_shared<ClientAsyncContext>(std::move(decode));
+    auto future = asyncContext->GetFuture();
+    if (accClientLink_ == nullptr) {
+        SHM_LOG_ERROR("accClientLink_ is null, connection not established");
+        asyncContext->SetFailedFinish();
+        return future;
+    }
+
+    auto dataBuf = SmemMessagePacker::PackBuffer(request);
+    if (dataBuf == nullptr) {
+        SHM_LOG_ERROR("pack request failed");
+        asyncContext->SetFailedFinish();
+        return future;
+    }
+
+    auto seqNo = reqSeqGen_.fetch_add(1U);
+    std::unique_lock<std::mutex> msgCtxLocker{msgCtxMutex_};
+    msgClientContext_.emplace(seqNo, asyncContext);
+    msgCtxLocker.unlock();
+
+    auto sent = sentCount_.load();
+    auto ret = accClientLink_->NonBlockSend(0, seqNo, dataBuf, nullptr);
+    // the send queue is bounded, a long pipeline waits for the link to drain it instead of failing
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kDefaultSendMsgTimeoutMs);
+    while (ret == shm::acc::ACC_QUEUE_IS_FULL) {
+        sendSpaceWaiters_.fetch_add(1U);
+        std::unique_lock<std::mutex> spaceLocker{sendSpaceMutex_};
+        auto drained = sendSpaceCond_.wait_until(spaceLocker, deadline, [this, sent]() {
+            return sentCount_.load() != sent;
+        });
+        spaceLocker.unlock();
+        sendSpaceWaiters_.fetch_sub(1U);
+        if (!drained) {
+            break;
+        }
+        sent = sentCount_.load();
+        ret = accClientLink_->NonBlockSend(0, seqNo, dataBuf, nullptr);
+    }
+    if (ret != SM_OK) {
+        SHM_LOG_ERROR("send message failed, result: " << ret);
+        std::unique_lock<std::mutex> locker{msgCtxMutex_};
+        auto erased = msgClientContext_.erase(seqNo);
+        locker.unlock();
+        // the link broken handler may have finished it already
+        if (erased > 0) {
+            asyncContext->SetFailedFinish();
+        }
+    }
+    return future;
+}
+
 Result TcpConfigStore::LinkBrokenHandler(const shm::acc::AccTcpLinkComplexPtr &link) noexcept
 {
     SHM_LOG_INFO("link broken, linkId: " << link->Id());
@@ -544,6 +837,18 @@ Result TcpConfigStore::LinkBrokenHandler(const shm::acc::AccTcpLinkComplexPtr &l
         it.second->SetFailedFinish();
     }
 
+    // senders waiting for queue space retry and see the broken link
+    RequestSentHandler();
+    return SM_OK;
+}
+
+Result TcpConfigStore::RequestSentHandler() noexcept
+{
+    sentCount_.fetch_add(1U);
+    if (sendSpaceWaiters_.load() > 0) {
+        std::unique_lock<std::mutex> spaceLocker{sendSpaceMutex_};
+        sendSpaceCond_.notify_all();
+    }
     return SM_OK;
 }
 
@@ -569,7 +874,7 @@ Result TcpConfigStore::ReceiveResponseHandler(const shm::acc::AccTcpRequestConte
     return SM_OK;
 }
 
-Result TcpConfigStore::SendWatchRequest(const std::vector<uint8_t> &reqBody,
+Result TcpConfigStore::SendWatchRequest(const SmemMessageView &request,
                                         const std::function<void(int result, const std::vector<uint8_t> &)> &notify,
                                         uint32_t &id) noexcept
 {
@@ -578,6 +883,12 @@ Result TcpConfigStore::SendWatchRequest(const std::vector<uint8_t> &reqBody,
         return SM_ERROR;
     }
 
+    auto dataBuf = SmemMessagePacker::PackBuffer(request);
+    if (dataBuf == nullptr) {
+        SHM_LOG_ERROR("pack request failed");
+        return SM_ERROR;
+    }
+
     auto seqNo = reqSeqGen_.fetch_add(1U);
 
     auto watchContext = std::make_shared<ClientWatchContext>(notify);
@@ -585,7 +896,6 @@ Result TcpConfigStore::SendWatchRequest(const std::vector<uint8_t> &reqBody,
     msgClientContext_.emplace(seqNo, std::move(watchContext));
     msgCtxLocker.unlock();
 
-    auto dataBuf = shm::acc::AccDataBuffer::Create(reqBody.data(), reqBody.size());
     auto ret = accClientLink_->NonBlockSend(0, seqNo, dataBuf, nullptr);
     if (ret != SM_OK) {
         SHM_LOG_ERROR("send message failed, result: " << ret);
@@ -50,6 +50,14 @@ public:
     Result Append(const std::string &key, const std::vector<uint8_t> &value, uint64_t &newSize) noexcept override;
     Result Cas(const std::string &key, const std::vector<uint8_t> &expect, const std::vector<uint8_t> &value,
                std::vector<uint8_t> &exists) noexcept override;
+    Result Gather(const std::string &key, uint32_t rank, uint32_t rankSize, const std::vector<uint8_t> &value,
+                  std::vector<uint8_t> &output, int64_t timeoutMs) noexcept override;
+    Result Barrier(const std::string &key, uint32_t rankSize, int64_t timeoutMs) noexcept override;
+    std::future<Result> SetAsync(const std::string &key, const std::vector<uint8_t> &value) noexcept override;
+    std::future<Result> GetAsync(const std::string &key, std::vector<uint8_t> &value,
+                                 int64_t timeoutMs) noexcept override;
+    std::future<Result> AddAsync(const std::string &key, int64_t increment, int64_t &value) noexcept override;
+    Result Multi(std::vector<StoreMultiOp> &ops) noexcept override;
     Result Watch(const std::string &key,
                  const std::function<void(int result, const std::string &, const std::vector<uint8_t> &)> &notify,
                  uint32_t &wid) noexcept override;
@@ -74,11 +82,15 @@ protected:
 
 private:
     std::shared_ptr<shm::acc::AccTcpRequestContext> SendMessageBlocked(
-        const std::vector<uint8_t> &reqBody,
+        const SmemMessageView &request,
         int64_t timeoutMs = kDefaultSendMsgTimeoutMs) noexcept;
+    std::future<Result> SendMessageAsync(
+        const SmemMessageView &request,
+        std::function<Result(const shm::acc::AccTcpRequestContext &)> decode) noexcept;
     Result LinkBrokenHandler(const shm::acc::AccTcpLinkComplexPtr &link) noexcept;
+    Result RequestSentHandler() noexcept;
     Result ReceiveResponseHandler(const shm::acc::AccTcpRequestContext &context) noexcept;
-    Result SendWatchRequest(const std::vector<uint8_t> &reqBody,
+    Result SendWatchRequest(const SmemMessageView &request,
                             const std::function<void(int result, const std::vector<uint8_t> &)> &notify,
                             uint32_t &id) noexcept;
 
@@ -93,6 +105,12 @@ private:
     std::unordered_map<uint32_t, std::shared_ptr<ClientCommonContext>> msgClientContext_;
     static std::atomic<uint32_t> reqSeqGen_;
 
+    /* senders blocked on a full link queue wait here, woken by the link draining it or breaking */
+    std::mutex sendSpaceMutex_;
+    std::condition_variable sendSpaceCond_;
+    std::atomic<uint64_t> sentCount_{0};
+    std::atomic<uint32_t> sendSpaceWaiters_{0};
+
     std::mutex mutex_;
     const std::string serverIp_;
     const uint16_t serverPort_;
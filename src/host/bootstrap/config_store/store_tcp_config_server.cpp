@@ -9,6 +9,7 @@
  */
 
 #include <algorithm>
+#include <array>
 #include "host/shmem_host_def.h"
 #include "shmemi_logger.h"
 #include "store_message_packer.h"
@@ -19,16 +20,57 @@
 namespace shm {
 namespace store {
 std::atomic<uint64_t> StoreWaitContext::idGen_{1UL};
-AccStoreServer::AccStoreServer(std::string ip, uint16_t port, int32_t sockFd, uint16_t magic) noexcept
-    : listenIp_{std::move(ip)},
+AccStoreServer::AccStoreServer(std::string ip, uint16_t port, int32_t sockFd, uint16_t magic, uint32_t shardCount,
+                               uint16_t workerCount) noexcept
+    : workerCount_{workerCount == 0 ? DEFAULT_WORKER_COUNT : workerCount},
+      listenIp_{std::move(ip)},
       listenPort_{port},
       sockFd_{sockFd},
       magic_{magic},
       requestHandlers_{
           {MessageType::SET, &AccStoreServer::SetHandler},       {MessageType::GET, &AccStoreServer::GetHandler},
           {MessageType::ADD, &AccStoreServer::AddHandler},       {MessageType::REMOVE, &AccStoreServer::RemoveHandler},
-          {MessageType::APPEND, &AccStoreServer::AppendHandler}, {MessageType::CAS, &AccStoreServer::CasHandler}}
+          {MessageType::APPEND, &AccStoreServer::AppendHandler}, {MessageType::CAS, &AccStoreServer::CasHandler},
+          {MessageType::GATHER, &AccStoreServer::GatherHandler}, {MessageType::BARRIER, &AccStoreServer::BarrierHandler},
+          {MessageType::MULTI, &AccStoreServer::MultiHandler}}
 {
+    shardCount = std::max(shardCount, 1U);
+    shards_.reserve(shardCount);
+    for (uint32_t i = 0; i < shardCount; i++) {
+        shards_.emplace_back(new (std::nothrow) StoreShard);
+        if (shards_.back() == nullptr) {
+            SHM_LOG_ERROR("create store shard failed, use " << i << " shards");
+            shards_.pop_back();
+            break;
+        }
+    }
+}
+
+AccStoreServer::StoreShard &AccStoreServer::ShardOf(const StoreKey &key) noexcept
+{
+    return *shards_[key.Hash() % shards_.size()];
+}
+
+int64_t AccStoreServer::MonotonicMs() noexcept
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+}
+
+uint32_t AccStoreServer::WorkerBusyPollUs() noexcept
+{
+    const char *env = std::getenv("SHMEM_CONFIG_STORE_BUSY_POLL_US");
+    if (env == nullptr) {
+        return 0;
+    }
+
+    long value = 0;
+    if (!CharToLong(env, value) || value < 0 || value > static_cast<long>(MAX_BUSY_POLL_US)) {
+        SHM_LOG_WARN("Invalid SHMEM_CONFIG_STORE_BUSY_POLL_US: " << env << ", should be between 0 and "
+                     << MAX_BUSY_POLL_US << ", busy poll is off.");
+        return 0;
+    }
+    return static_cast<uint32_t>(value);
 }
 
 Result AccStoreServer::AccServerStart(shm::acc::AccTcpServerPtr &accTcpServer,
@@ -38,7 +80,9 @@ Result AccStoreServer::AccServerStart(shm::acc::AccTcpServerPtr &accTcpServer,
     options.listenIp = listenIp_;
     options.listenPort = listenPort_;
     options.enableListener = true;
-    options.linkSendQueueSize = shm::acc::UNO_48;
+    options.workerCount = workerCount_;
+    options.linkSendQueueSize = LINK_SEND_QUEUE_SIZE;
+    options.workerBusyPollUs = WorkerBusyPollUs();
     options.sockFd = sockFd_;
     options.magic = magic_;
 
@@ -76,7 +120,13 @@ Result AccStoreServer::Startup(const AcclinkTlsOption &tlsOption) noexcept
         return ACLSHMEM_SUCCESS;
     }
 
-    SHM_LOG_INFO("AccStoreServer starting on " << listenIp_ << ":" << listenPort_ << " magic=" << magic_);
+    if (shards_.empty()) {
+        SHM_LOG_ERROR("no store shard available");
+        return SM_NEW_OBJECT_FAILED;
+    }
+
+    SHM_LOG_INFO("AccStoreServer starting on " << listenIp_ << ":" << listenPort_ << " magic=" << magic_
+                 << " shards=" << shards_.size() << " workers=" << workerCount_);
     auto tmpAccTcpServer = shm::acc::AccTcpServer::Create();
     if (tmpAccTcpServer == nullptr) {
         SHM_LOG_ERROR("create acc tcp server failed");
@@ -152,8 +202,9 @@ Result AccStoreServer::ReceiveMessageHandler(const shm::acc::AccTcpRequestContex
         return SM_INVALID_PARAM;
     }
 
-    SmemMessage requestMessage;
-    auto size = SmemMessagePacker::Unpack(data, context.DataLen(), requestMessage);
+    // keys and values point into the request body, handlers copy only what they keep
+    SmemMessageView requestMessage;
+    auto size = SmemMessagePacker::UnpackView(data, context.DataLen(), requestMessage);
     if (size < 0) {
         SHM_LOG_ERROR("request(" << context.SeqNo() << ") handle invalid body");
         ReplyWithMessage(context, StoreErrorCode::INVALID_MESSAGE, "invalid request");
@@ -184,7 +235,7 @@ Result AccStoreServer::LinkBrokenHandler(const shm::acc::AccTcpLinkComplexPtr &l
     return ACLSHMEM_SUCCESS;
 }
 
-Result AccStoreServer::SetHandler(const shm::acc::AccTcpRequestContext &context, SmemMessage &request) noexcept
+Result AccStoreServer::SetHandler(const shm::acc::AccTcpRequestContext &context, SmemMessageView &request) noexcept
 {
     if (request.keys.size() != 1 || request.values.size() != 1) {
         SHM_LOG_ERROR("request(" << context.SeqNo() << ") handle invalid body");
@@ -192,40 +243,29 @@ Result AccStoreServer::SetHandler(const shm::acc::AccTcpRequestContext &context,
         return SM_INVALID_PARAM;
     }
 
-    auto &key = request.keys[0];
-    auto &value = request.values[0];
-    if (key.length() > MAX_KEY_LEN_SERVER) {
-        SHM_LOG_ERROR("key length too large, length: " << key.length());
+    StoreKey key{request.keys[0]};
+    if (key.Str().length() > MAX_KEY_LEN_SERVER) {
+        SHM_LOG_ERROR("key length too large, length: " << key.Str().length());
         return StoreErrorCode::INVALID_KEY;
     }
 
+    auto value = request.values[0].ToVector();
     SHM_LOG_DEBUG("SET REQUEST(" << context.SeqNo() << ") for key(" << key << ") start.");
-    std::list<shm::acc::AccTcpRequestContext> wakeupWaiters;
-    std::vector<uint8_t> reqVal;
-    std::unique_lock<std::mutex> lockGuard{storeMutex_};
-    auto pos = kvStore_.find(key);
-    if (pos == kvStore_.end()) {
-        auto wPos = keyWaiters_.find(key);
-        if (wPos != keyWaiters_.end()) {
-            wakeupWaiters = GetOutWaitersInLock(wPos->second);
-            reqVal = value;
-            keyWaiters_.erase(wPos);
-        }
-        kvStore_.emplace(key, std::move(value));
-    } else {
-        pos->second = std::move(value);
-    }
+    StoreOpOutcome outcome;
+    auto &shard = ShardOf(key);
+    std::unique_lock<std::mutex> lockGuard{shard.mutex};
+    SetInLock(shard, key, value, outcome);
     lockGuard.unlock();
 
-    ReplyWithMessage(context, StoreErrorCode::SUCCESS, "success");
-    if (!wakeupWaiters.empty()) {
-        WakeupWaiters(wakeupWaiters, reqVal);
+    ReplyWithMessage(context, outcome.code, outcome.response);
+    if (!outcome.waiters.empty()) {
+        WakeupWaiters(outcome.waiters, outcome.wakeupValue);
     }
 
     return ACLSHMEM_SUCCESS;
 }
 
-Result AccStoreServer::GetHandler(const shm::acc::AccTcpRequestContext &context, SmemMessage &request) noexcept
+Result AccStoreServer::GetHandler(const shm::acc::AccTcpRequestContext &context, SmemMessageView &request) noexcept
 {
     if (request.keys.size() != 1 || !request.values.empty()) {
         SHM_LOG_ERROR("request(" << context.SeqNo() << ") handle invalid body");
@@ -233,23 +273,29 @@ Result AccStoreServer::GetHandler(const shm::acc::AccTcpRequestContext &context,
         return SM_INVALID_PARAM;
     }
 
-    auto &key = request.keys[0];
-    if (key.length() > MAX_KEY_LEN_SERVER) {
-        SHM_LOG_ERROR("key length too large, length: " << key.length());
+    StoreKey key{request.keys[0]};
+    if (key.Str().length() > MAX_KEY_LEN_SERVER) {
+        SHM_LOG_ERROR("key length too large, length: " << key.Str().length());
         return StoreErrorCode::INVALID_KEY;
     }
 
     SHM_LOG_DEBUG("GET REQUEST(" << context.SeqNo() << ") for key(" << key << ") start.");
-    SmemMessage responseMessage{request.mt};
-    std::unique_lock<std::mutex> lockGuard{storeMutex_};
-    auto pos = kvStore_.find(key);
-    if (pos != kvStore_.end()) {
-        responseMessage.values.push_back(pos->second);
+    auto &shard = ShardOf(key);
+    std::unique_lock<std::mutex> lockGuard{shard.mutex};
+    auto pos = shard.kvStore.find(key);
+    if (pos != shard.kvStore.end()) {
+        // the stored value is packed straight into the reply buffer, the only copy made of it
+        SmemMessageView responseMessage{request.mt};
+        responseMessage.values.emplace_back(pos->second);
+        auto response = SmemMessagePacker::PackBuffer(responseMessage);
         lockGuard.unlock();
 
         SHM_LOG_DEBUG("GET REQUEST(" << context.SeqNo() << ") for key(" << key << ") success.");
-        auto response = SmemMessagePacker::Pack(responseMessage);
-        ReplyWithMessage(context, StoreErrorCode::SUCCESS, response);
+        if (response == nullptr) {
+            ReplyWithMessage(context, StoreErrorCode::ERROR, "create get response failed");
+            return ACLSHMEM_SMEM_ERROR;
+        }
+        context.Reply(StoreErrorCode::SUCCESS, response);
         return ACLSHMEM_SUCCESS;
     }
 
@@ -266,32 +312,13 @@ Result AccStoreServer::GetHandler(const shm::acc::AccTcpRequestContext &context,
         return ACLSHMEM_SMEM_ERROR;
     }
     SHM_LOG_DEBUG("GET REQUEST(" << context.SeqNo() << ") for key(" << key << ") waiting timeout=" << request.userDef);
-    auto timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(request.userDef);
-    auto timeoutMs = std::chrono::duration_cast<std::chrono::milliseconds>(timeout.time_since_epoch()).count();
-    SHM_LOG_DEBUG("GET REQUEST(" << context.SeqNo() << ") for key(" << key << ") waiting timeout=" << timeoutMs);
-    StoreWaitContext waitContext{timeoutMs, key, context};
-    auto pair = waitCtx_.emplace(waitContext.Id(), std::move(waitContext));
-    auto wPos = keyWaiters_.find(key);
-    if (wPos != keyWaiters_.end()) {
-        wPos->second.emplace(pair.first->first);
-    } else {
-        keyWaiters_.emplace(key, std::unordered_set<uint64_t>{pair.first->first});
-    }
-
-    if (request.userDef > 0) {
-        auto timerPos = timedWaiters_.find(timeoutMs);
-        if (timerPos == timedWaiters_.end()) {
-            timedWaiters_.emplace(timeoutMs, std::unordered_set<uint64_t>{pair.first->first});
-        } else {
-            timerPos->second.emplace(pair.first->first);
-        }
-    }
+    shard.keyWaiters[key].emplace(AddWaiterInLock(shard, context, request.userDef));
     lockGuard.unlock();
 
     return ACLSHMEM_SUCCESS;
 }
 
-Result AccStoreServer::AddHandler(const shm::acc::AccTcpRequestContext &context, SmemMessage &request) noexcept
+Result AccStoreServer::AddHandler(const shm::acc::AccTcpRequestContext &context, SmemMessageView &request) noexcept
 {
     if (request.keys.size() != 1 || request.values.size() != 1) {
         SHM_LOG_ERROR("request(" << context.SeqNo() << ") handle invalid body");
@@ -299,56 +326,35 @@ Result AccStoreServer::AddHandler(const shm::acc::AccTcpRequestContext &context,
         return SM_INVALID_PARAM;
     }
 
-    auto &key = request.keys[0];
-    auto &value = request.values[0];
-    SHM_VALIDATE_RETURN(key.length() <= MAX_KEY_LEN_SERVER, "key length too large, length: "
-                       << key.length(), StoreErrorCode::INVALID_KEY);
+    StoreKey key{request.keys[0]};
+    auto value = request.values[0].ToVector();
+    SHM_VALIDATE_RETURN(key.Str().length() <= MAX_KEY_LEN_SERVER, "key length too large, length: "
+                       << key.Str().length(), StoreErrorCode::INVALID_KEY);
 
     std::string valueStr{value.begin(), value.end()};
     SHM_LOG_DEBUG("ADD REQUEST(" << context.SeqNo() << ") for key(" << key << ") value(" << valueStr << ") start.");
 
     long valueNum;
-    SHM_VALIDATE_RETURN(StrToLong(valueStr, valueNum), "convert string to long failed.", ACLSHMEM_SMEM_ERROR);
-
-    if (valueStr != std::to_string(valueNum)) {
+    if (!ParseIncrement(value, valueNum)) {
         SHM_LOG_ERROR("request(" << context.SeqNo() << ") add for key(" << key << ") value is not a number");
         ReplyWithMessage(context, StoreErrorCode::INVALID_MESSAGE, "invalid request: value should be a number.");
         return ACLSHMEM_SMEM_ERROR;
     }
 
-    auto responseValue = valueNum;
-    std::list<shm::acc::AccTcpRequestContext> wakeupWaiters;
-    std::vector<uint8_t> reqVal;
-    std::unique_lock<std::mutex> lockGuard{storeMutex_};
-    auto pos = kvStore_.find(key);
-    if (pos == kvStore_.end()) {
-        auto wPos = keyWaiters_.find(key);
-        if (wPos != keyWaiters_.end()) {
-            wakeupWaiters = GetOutWaitersInLock(wPos->second);
-            reqVal = value;
-            keyWaiters_.erase(wPos);
-        }
-        kvStore_.emplace(key, std::move(value));
-    } else {
-        std::string oldValueStr{pos->second.begin(), pos->second.end()};
-        long storedValueNum = 0;
-        SHM_VALIDATE_RETURN(StrToLong(oldValueStr, storedValueNum), "convert string to long failed.", ACLSHMEM_SMEM_ERROR);
-
-        storedValueNum += valueNum;
-        auto storedValueStr = std::to_string(storedValueNum);
-        pos->second = std::vector<uint8_t>(storedValueStr.begin(), storedValueStr.end());
-        responseValue = storedValueNum;
-    }
+    StoreOpOutcome outcome;
+    auto &shard = ShardOf(key);
+    std::unique_lock<std::mutex> lockGuard{shard.mutex};
+    AddInLock(shard, key, valueNum, value, outcome);
     lockGuard.unlock();
-    SHM_LOG_DEBUG("ADD REQUEST(" << context.SeqNo() << ") for key(" << key << ") value(" << responseValue << ") end.");
-    ReplyWithMessage(context, StoreErrorCode::SUCCESS, std::to_string(responseValue));
-    if (!wakeupWaiters.empty()) {
-        WakeupWaiters(wakeupWaiters, reqVal);
+    SHM_LOG_DEBUG("ADD REQUEST(" << context.SeqNo() << ") for key(" << key << ") code(" << outcome.code << ") end.");
+    ReplyWithMessage(context, outcome.code, outcome.response);
+    if (!outcome.waiters.empty()) {
+        WakeupWaiters(outcome.waiters, outcome.wakeupValue);
     }
     return ACLSHMEM_SUCCESS;
 }
 
-Result AccStoreServer::RemoveHandler(const shm::acc::AccTcpRequestContext &context, SmemMessage &request) noexcept
+Result AccStoreServer::RemoveHandler(const shm::acc::AccTcpRequestContext &context, SmemMessageView &request) noexcept
 {
     if (request.keys.size() != 1 || !request.values.empty()) {
         SHM_LOG_ERROR("request(" << context.SeqNo() << ") handle invalid body");
@@ -356,28 +362,24 @@ Result AccStoreServer::RemoveHandler(const shm::acc::AccTcpRequestContext &conte
         return SM_INVALID_PARAM;
     }
 
-    auto &key = request.keys[0];
-    if (key.length() > MAX_KEY_LEN_SERVER) {
-        SHM_LOG_ERROR("key length too large, length: " << key.length());
+    StoreKey key{request.keys[0]};
+    if (key.Str().length() > MAX_KEY_LEN_SERVER) {
+        SHM_LOG_ERROR("key length too large, length: " << key.Str().length());
         return StoreErrorCode::INVALID_KEY;
     }
 
     SHM_LOG_DEBUG("REMOVE REQUEST(" << context.SeqNo() << ") for key(" << key << ") start.");
-    bool removed = false;
-    std::unique_lock<std::mutex> lockGuard{storeMutex_};
-    auto pos = kvStore_.find(key);
-    if (pos != kvStore_.end()) {
-        kvStore_.erase(pos);
-        removed = true;
-    }
+    StoreOpOutcome outcome;
+    auto &shard = ShardOf(key);
+    std::unique_lock<std::mutex> lockGuard{shard.mutex};
+    RemoveInLock(shard, key, outcome);
     lockGuard.unlock();
-    ReplyWithMessage(context, removed ? StoreErrorCode::SUCCESS : StoreErrorCode::NOT_EXIST,
-                     removed ? "success" : "not exist");
+    ReplyWithMessage(context, outcome.code, outcome.response);
 
     return ACLSHMEM_SUCCESS;
 }
 
-Result AccStoreServer::AppendHandler(const shm::acc::AccTcpRequestContext &context, SmemMessage &request) noexcept
+Result AccStoreServer::AppendHandler(const shm::acc::AccTcpRequestContext &context, SmemMessageView &request) noexcept
 {
     if (request.keys.size() != 1 || request.values.size() != 1) {
         SHM_LOG_ERROR("request(" << context.SeqNo() << ") handle invalid body");
@@ -385,43 +387,29 @@ Result AccStoreServer::AppendHandler(const shm::acc::AccTcpRequestContext &conte
         return SM_INVALID_PARAM;
     }
 
-    auto &key = request.keys[0];
+    StoreKey key{request.keys[0]};
     auto &value = request.values[0];
-    if (key.length() > MAX_KEY_LEN_SERVER) {
-        SHM_LOG_ERROR("key length too large, length: " << key.length());
+    if (key.Str().length() > MAX_KEY_LEN_SERVER) {
+        SHM_LOG_ERROR("key length too large, length: " << key.Str().length());
         return StoreErrorCode::INVALID_KEY;
     }
 
     SHM_LOG_DEBUG("APPEND REQUEST(" << context.SeqNo() << ") for key(" << key << ") start.");
-    uint64_t newSize;
-    std::list<shm::acc::AccTcpRequestContext> wakeupWaiters;
-    std::vector<uint8_t> reqVal;
-    std::unique_lock<std::mutex> lockGuard{storeMutex_};
-    auto pos = kvStore_.find(key);
-    if (pos != kvStore_.end()) {
-        pos->second.insert(pos->second.end(), value.begin(), value.end());
-        newSize = pos->second.size();
-    } else {
-        newSize = value.size();
-        auto wPos = keyWaiters_.find(key);
-        if (wPos != keyWaiters_.end()) {
-            wakeupWaiters = GetOutWaitersInLock(wPos->second);
-            reqVal = value;
-            keyWaiters_.erase(wPos);
-        }
-        kvStore_.emplace(key, std::move(value));
-    }
+    StoreOpOutcome outcome;
+    auto &shard = ShardOf(key);
+    std::unique_lock<std::mutex> lockGuard{shard.mutex};
+    AppendInLock(shard, key, value, outcome);
     lockGuard.unlock();
-    ReplyWithMessage(context, StoreErrorCode::SUCCESS, std::to_string(newSize));
-    if (!wakeupWaiters.empty()) {
-        WakeupWaiters(wakeupWaiters, value);
+    ReplyWithMessage(context, outcome.code, outcome.response);
+    if (!outcome.waiters.empty()) {
+        WakeupWaiters(outcome.waiters, outcome.wakeupValue);
     }
 
     return ACLSHMEM_SUCCESS;
 }
 
 Result AccStoreServer::CasHandler(const shm::acc::AccTcpRequestContext &context,
-                                  shm::store::SmemMessage &request) noexcept
+                                  shm::store::SmemMessageView &request) noexcept
 {
     const size_t EXPECTED_KEYS_SIZE = 1;
     const size_t EXPECTED_VALUES_SIZE = 2;
@@ -431,23 +419,24 @@ Result AccStoreServer::CasHandler(const shm::acc::AccTcpRequestContext &context,
         return SM_INVALID_PARAM;
     }
 
-    auto &key = request.keys[0];
-    auto &expected = request.values[0];
-    auto &exchange = request.values[1];
-    auto newValue = exchange;
-    if (key.length() > MAX_KEY_LEN_SERVER) {
-        SHM_LOG_ERROR("key length too large, length: " << key.length());
+    StoreKey key{request.keys[0]};
+    auto expected = request.values[0].ToVector();
+    auto exchange = request.values[1].ToVector();
+    auto &newValue = request.values[1];
+    if (key.Str().length() > MAX_KEY_LEN_SERVER) {
+        SHM_LOG_ERROR("key length too large, length: " << key.Str().length());
         return StoreErrorCode::INVALID_KEY;
     }
 
     std::vector<uint8_t> exists;
-    SmemMessage responseMessage{request.mt};
+    SmemMessageView responseMessage{request.mt};
     std::list<shm::acc::AccTcpRequestContext> wakeupWaiters;
     SHM_LOG_DEBUG("CAS REQUEST(" << context.SeqNo() << ") for key(" << key << ") start.");
 
-    std::unique_lock<std::mutex> lockGuard{storeMutex_};
-    auto pos = kvStore_.find(key);
-    if (pos != kvStore_.end()) {
+    auto &shard = ShardOf(key);
+    std::unique_lock<std::mutex> lockGuard{shard.mutex};
+    auto pos = shard.kvStore.find(key);
+    if (pos != shard.kvStore.end()) {
         if (expected == pos->second) {
             exists = std::move(pos->second);
             pos->second = std::move(exchange);
@@ -456,57 +445,402 @@ Result AccStoreServer::CasHandler(const shm::acc::AccTcpRequestContext &context,
         }
     } else {
         if (expected.empty()) {
-            kvStore_.emplace(key, std::move(exchange));
-            auto wPos = keyWaiters_.find(key);
-            if (wPos != keyWaiters_.end()) {
-                wakeupWaiters = GetOutWaitersInLock(wPos->second);
-                keyWaiters_.erase(wPos);
+            shard.kvStore.emplace(key, std::move(exchange));
+            auto wPos = shard.keyWaiters.find(key);
+            if (wPos != shard.keyWaiters.end()) {
+                wakeupWaiters = GetOutWaitersInLock(shard, wPos->second);
+                shard.keyWaiters.erase(wPos);
             }
         }
     }
     lockGuard.unlock();
     SHM_LOG_DEBUG("CAS REQUEST(" << context.SeqNo() << ") for key(" << key << ") finished.");
 
-    responseMessage.values.push_back(exists);
-    auto response = SmemMessagePacker::Pack(responseMessage);
-    ReplyWithMessage(context, StoreErrorCode::SUCCESS, response);
+    responseMessage.values.emplace_back(exists);
+    ReplyWithMessage(context, StoreErrorCode::SUCCESS, responseMessage);
     if (!wakeupWaiters.empty()) {
         WakeupWaiters(wakeupWaiters, newValue);
     }
     return ACLSHMEM_SUCCESS;
 }
 
+Result AccStoreServer::GatherHandler(const shm::acc::AccTcpRequestContext &context, SmemMessageView &request) noexcept
+{
+    using GatherPosition = std::array<uint32_t, 2>;  // rank, rankSize
+    const size_t EXPECTED_VALUES_SIZE = 2;
+    if (request.keys.size() != 1 || request.values.size() != EXPECTED_VALUES_SIZE ||
+        request.values[1].size != sizeof(GatherPosition)) {
+        SHM_LOG_ERROR("request(" << context.SeqNo() << ") handle invalid body");
+        ReplyWithMessage(context, StoreErrorCode::INVALID_MESSAGE, "invalid request: count(key)=1 & count(value)=2");
+        return SM_INVALID_PARAM;
+    }
+
+    StoreKey key{request.keys[0]};
+    auto &block = request.values[0];
+    SHM_VALIDATE_RETURN(key.Str().length() <= MAX_KEY_LEN_SERVER, "key length too large, length: "
+                       << key.Str().length(), StoreErrorCode::INVALID_KEY);
+
+    auto position = SmemMessagePacker::UnpackPod<GatherPosition>(request.values[1]);
+    auto rank = position[0];
+    auto rankSize = position[1];
+    if (rank >= rankSize || static_cast<uint64_t>(block.size) * rankSize > MAX_VALUE_SIZE ||
+        request.userDef > std::numeric_limits<int>::max()) {
+        SHM_LOG_ERROR("GATHER REQUEST(" << context.SeqNo() << ") for key(" << key << ") invalid rank(" << rank
+            << "/" << rankSize << ") size(" << block.size << ") or timeout(" << request.userDef << ")");
+        ReplyWithMessage(context, StoreErrorCode::INVALID_MESSAGE, "invalid request: gather rank or size");
+        return SM_INVALID_PARAM;
+    }
+
+    SHM_LOG_DEBUG("GATHER REQUEST(" << context.SeqNo() << ") for key(" << key << ") rank(" << rank << "/"
+        << rankSize << ") start.");
+    auto &shard = ShardOf(key);
+    std::unique_lock<std::mutex> lockGuard{shard.mutex};
+    auto gPos = shard.gathers.find(key);
+    if (gPos == shard.gathers.end()) {
+        auto response = shm::acc::AccDataBuffer::Create(static_cast<uint32_t>(block.size * rankSize));
+        if (response == nullptr) {
+            lockGuard.unlock();
+            SHM_LOG_ERROR("create gather response for key(" << key << ") failed");
+            ReplyWithMessage(context, StoreErrorCode::ERROR, "create gather response failed");
+            return ACLSHMEM_SMEM_ERROR;
+        }
+        response->SetDataSize(static_cast<uint32_t>(block.size * rankSize));
+        StoreGatherContext gather;
+        gather.rankSize = rankSize;
+        gather.blockSize = static_cast<uint32_t>(block.size);
+        gather.ranks.resize(rankSize, false);
+        gather.response = std::move(response);
+        gPos = shard.gathers.emplace(key, std::move(gather)).first;
+    }
+
+    auto &gather = gPos->second;
+    if (gather.rankSize != rankSize || gather.blockSize != block.size || gather.ranks[rank]) {
+        lockGuard.unlock();
+        SHM_LOG_ERROR("GATHER REQUEST(" << context.SeqNo() << ") for key(" << key << ") rank(" << rank << "/"
+            << rankSize << ") size(" << block.size << ") mismatch or duplicated");
+        ReplyWithMessage(context, StoreErrorCode::INVALID_MESSAGE, "invalid request: gather mismatch");
+        return SM_INVALID_PARAM;
+    }
+    if (block.size > 0) {
+        std::copy_n(block.data, block.size, gather.response->DataPtr() + static_cast<uint64_t>(rank) * block.size);
+    }
+    gather.ranks[rank] = true;
+    gather.arrived++;
+
+    gather.waiters.emplace(AddWaiterInLock(shard, context, request.userDef, &key));
+    if (gather.arrived < gather.rankSize) {
+        return ACLSHMEM_SUCCESS;
+    }
+
+    // every rank has arrived: all waiters share the one response buffer
+    auto waiters = GetOutWaitersInLock(shard, gather.waiters);
+    auto response = gather.response;
+    shard.gathers.erase(gPos);
+    lockGuard.unlock();
+
+    SHM_LOG_DEBUG("GATHER REQUEST(" << context.SeqNo() << ") for key(" << key << ") finished.");
+    shm::acc::AccTcpRequestContext::ReplyAll(waiters, StoreErrorCode::SUCCESS, response);
+    return ACLSHMEM_SUCCESS;
+}
+
+Result AccStoreServer::BarrierHandler(const shm::acc::AccTcpRequestContext &context, SmemMessageView &request) noexcept
+{
+    if (request.keys.size() != 1 || request.values.size() != 1 || request.values[0].size != sizeof(uint32_t)) {
+        SHM_LOG_ERROR("request(" << context.SeqNo() << ") handle invalid body");
+        ReplyWithMessage(context, StoreErrorCode::INVALID_MESSAGE, "invalid request: key & value should be one.");
+        return SM_INVALID_PARAM;
+    }
+
+    StoreKey key{request.keys[0]};
+    SHM_VALIDATE_RETURN(key.Str().length() <= MAX_KEY_LEN_SERVER, "key length too large, length: "
+                       << key.Str().length(), StoreErrorCode::INVALID_KEY);
+    auto rankSize = SmemMessagePacker::UnpackPod<uint32_t>(request.values[0]);
+    if (rankSize == 0 || request.userDef > std::numeric_limits<int>::max()) {
+        SHM_LOG_ERROR("BARRIER REQUEST(" << context.SeqNo() << ") for key(" << key << ") invalid size(" << rankSize
+            << ") or timeout(" << request.userDef << ")");
+        ReplyWithMessage(context, StoreErrorCode::INVALID_MESSAGE, "invalid request: barrier size");
+        return SM_INVALID_PARAM;
+    }
+
+    SHM_LOG_DEBUG("BARRIER REQUEST(" << context.SeqNo() << ") for key(" << key << ") size(" << rankSize << ") start.");
+    auto &shard = ShardOf(key);
+    std::unique_lock<std::mutex> lockGuard{shard.mutex};
+    auto bPos = shard.barriers.try_emplace(key).first;
+    auto &barrier = bPos->second;
+    if (barrier.rankSize == 0) {
+        barrier.rankSize = rankSize;
+    } else if (barrier.rankSize != rankSize) {
+        lockGuard.unlock();
+        SHM_LOG_ERROR("BARRIER REQUEST(" << context.SeqNo() << ") for key(" << key << ") size(" << rankSize
+            << ") mismatch");
+        ReplyWithMessage(context, StoreErrorCode::INVALID_MESSAGE, "invalid request: barrier size mismatch");
+        return SM_INVALID_PARAM;
+    }
+
+    barrier.waiters.emplace(AddWaiterInLock(shard, context, request.userDef, &key));
+    if (++barrier.arrived < barrier.rankSize) {
+        return ACLSHMEM_SUCCESS;
+    }
+
+    // the last one releases everybody in one sweep, the barrier key is gone afterwards
+    auto waiters = GetOutWaitersInLock(shard, barrier.waiters);
+    shard.barriers.erase(bPos);
+    lockGuard.unlock();
+
+    SHM_LOG_DEBUG("BARRIER REQUEST(" << context.SeqNo() << ") for key(" << key << ") finished.");
+    const std::string message = "success";
+    auto response = shm::acc::AccDataBuffer::Create(message.c_str(), message.size());
+    if (response == nullptr) {
+        SHM_LOG_ERROR("create barrier response failed");
+        return ACLSHMEM_SMEM_ERROR;
+    }
+    shm::acc::AccTcpRequestContext::ReplyAll(waiters, StoreErrorCode::SUCCESS, response);
+    return ACLSHMEM_SUCCESS;
+}
+
+Result AccStoreServer::MultiHandler(const shm::acc::AccTcpRequestContext &context, SmemMessageView &request) noexcept
+{
+    if (!request.keys.empty() || request.values.size() != 1) {
+        SHM_LOG_ERROR("request(" << context.SeqNo() << ") handle invalid body");
+        ReplyWithMessage(context, StoreErrorCode::INVALID_MESSAGE, "invalid request: no key and one value.");
+        return SM_INVALID_PARAM;
+    }
+
+    // the value is a sequence of packed SET/GET/ADD/REMOVE/APPEND messages, the reply a sequence of packed outcomes
+    auto &ops = request.values[0];
+    std::vector<uint8_t> results;
+    std::list<std::pair<std::list<shm::acc::AccTcpRequestContext>, std::vector<uint8_t>>> wakeups;
+    uint64_t offset = 0;
+    uint32_t count = 0;
+    while (offset < ops.size) {
+        SmemMessageView op;
+        auto length = SmemMessagePacker::UnpackView(ops.data + offset, ops.size - offset, op);
+        if (length <= 0) {
+            SHM_LOG_ERROR("request(" << context.SeqNo() << ") unpack multi op(" << count << ") failed");
+            ReplyWithMessage(context, StoreErrorCode::INVALID_MESSAGE, "invalid request: multi op");
+            return SM_INVALID_PARAM;
+        }
+        offset += static_cast<uint64_t>(length);
+        count++;
+
+        StoreOpOutcome outcome;
+        long increment = 0;
+        bool valid = op.keys.size() == 1 && op.keys[0].length() <= MAX_KEY_LEN_SERVER &&
+                     op.values.size() == ((op.mt == MessageType::SET || op.mt == MessageType::ADD ||
+                                           op.mt == MessageType::APPEND) ? 1U : 0U) &&
+                     (op.mt != MessageType::ADD || ParseIncrement(op.values[0], increment));
+        if (!valid) {
+            outcome.code = StoreErrorCode::INVALID_MESSAGE;
+        } else {
+            StoreKey key{op.keys[0]};
+            auto value = (op.values.empty() || op.mt == MessageType::APPEND) ? std::vector<uint8_t>{} :
+                                                                                 op.values[0].ToVector();
+            auto &shard = ShardOf(key);
+            std::unique_lock<std::mutex> lockGuard{shard.mutex};
+            switch (op.mt) {
+                case MessageType::SET:
+                    SetInLock(shard, key, value, outcome);
+                    break;
+                case MessageType::GET:
+                    GetInLock(shard, key, outcome);
+                    break;
+                case MessageType::ADD:
+                    AddInLock(shard, key, increment, value, outcome);
+                    break;
+                case MessageType::REMOVE:
+                    RemoveInLock(shard, key, outcome);
+                    break;
+                case MessageType::APPEND:
+                    AppendInLock(shard, key, op.values[0], outcome);
+                    break;
+                default:
+                    outcome.code = StoreErrorCode::INVALID_MESSAGE;
+                    break;
+            }
+        }
+        if (!outcome.waiters.empty()) {
+            wakeups.emplace_back(std::move(outcome.waiters), std::move(outcome.wakeupValue));
+        }
+
+        SmemMessageView result{op.mt};
+        result.userDef = outcome.code;
+        result.values.emplace_back(outcome.response);
+        auto resultOffset = results.size();
+        results.resize(resultOffset + SmemMessagePacker::PackedSize(result));
+        SmemMessagePacker::PackTo(result, results.data() + resultOffset);
+    }
+
+    SHM_LOG_DEBUG("MULTI REQUEST(" << context.SeqNo() << ") with " << count << " ops finished.");
+    SmemMessageView responseMessage{MessageType::MULTI};
+    responseMessage.values.emplace_back(results);
+    ReplyWithMessage(context, StoreErrorCode::SUCCESS, responseMessage);
+    for (auto &wakeup : wakeups) {
+        WakeupWaiters(wakeup.first, wakeup.second);
+    }
+    return ACLSHMEM_SUCCESS;
+}
+
+bool AccStoreServer::ParseIncrement(const SmemBytesView &value, long &increment) noexcept
+{
+    std::string valueStr{value.data, value.data + value.size};
+    return StrToLong(valueStr, increment) && valueStr == std::to_string(increment);
+}
+
+void AccStoreServer::SetInLock(StoreShard &shard, const StoreKey &key, std::vector<uint8_t> &value,
+                               StoreOpOutcome &outcome) noexcept
+{
+    auto pos = shard.kvStore.find(key);
+    if (pos == shard.kvStore.end()) {
+        auto wPos = shard.keyWaiters.find(key);
+        if (wPos != shard.keyWaiters.end()) {
+            outcome.waiters = GetOutWaitersInLock(shard, wPos->second);
+            outcome.wakeupValue = value;
+            shard.keyWaiters.erase(wPos);
+        }
+        shard.kvStore.emplace(key, std::move(value));
+    } else {
+        pos->second = std::move(value);
+    }
+    outcome.code = StoreErrorCode::SUCCESS;
+    outcome.response = StoreOpOutcome::Text("success");
+}
+
+void AccStoreServer::GetInLock(StoreShard &shard, const StoreKey &key, StoreOpOutcome &outcome) noexcept
+{
+    auto pos = shard.kvStore.find(key);
+    if (pos == shard.kvStore.end()) {
+        outcome.code = StoreErrorCode::NOT_EXIST;
+        outcome.response = StoreOpOutcome::Text("<not exist>");
+        return;
+    }
+    outcome.code = StoreErrorCode::SUCCESS;
+    outcome.response = pos->second;
+}
+
+void AccStoreServer::AddInLock(StoreShard &shard, const StoreKey &key, long increment, std::vector<uint8_t> &value,
+                               StoreOpOutcome &outcome) noexcept
+{
+    auto responseValue = increment;
+    auto pos = shard.kvStore.find(key);
+    if (pos == shard.kvStore.end()) {
+        auto wPos = shard.keyWaiters.find(key);
+        if (wPos != shard.keyWaiters.end()) {
+            outcome.waiters = GetOutWaitersInLock(shard, wPos->second);
+            outcome.wakeupValue = value;
+            shard.keyWaiters.erase(wPos);
+        }
+        shard.kvStore.emplace(key, std::move(value));
+    } else {
+        std::string oldValueStr{pos->second.begin(), pos->second.end()};
+        long storedValueNum = 0;
+        if (!StrToLong(oldValueStr, storedValueNum)) {
+            SHM_LOG_ERROR("add for key(" << key << "), stored value is not a number.");
+            outcome.code = StoreErrorCode::ERROR;
+            outcome.response = StoreOpOutcome::Text("stored value is not a number");
+            return;
+        }
+
+        storedValueNum += increment;
+        auto storedValueStr = std::to_string(storedValueNum);
+        pos->second = std::vector<uint8_t>(storedValueStr.begin(), storedValueStr.end());
+        responseValue = storedValueNum;
+    }
+    outcome.code = StoreErrorCode::SUCCESS;
+    outcome.response = StoreOpOutcome::Text(std::to_string(responseValue));
+}
+
+void AccStoreServer::RemoveInLock(StoreShard &shard, const StoreKey &key, StoreOpOutcome &outcome) noexcept
+{
+    bool removed = shard.kvStore.erase(key) > 0;
+    if (shard.gathers.erase(key) > 0 || shard.barriers.erase(key) > 0) {
+        removed = true;
+    }
+    outcome.code = removed ? StoreErrorCode::SUCCESS : StoreErrorCode::NOT_EXIST;
+    outcome.response = StoreOpOutcome::Text(removed ? "success" : "not exist");
+}
+
+void AccStoreServer::AppendInLock(StoreShard &shard, const StoreKey &key, const SmemBytesView &value,
+                                  StoreOpOutcome &outcome) noexcept
+{
+    uint64_t newSize = value.size;
+    auto pos = shard.kvStore.find(key);
+    if (pos != shard.kvStore.end()) {
+        pos->second.insert(pos->second.end(), value.data, value.data + value.size);
+        newSize = pos->second.size();
+    } else {
+        auto wPos = shard.keyWaiters.find(key);
+        if (wPos != shard.keyWaiters.end()) {
+            outcome.waiters = GetOutWaitersInLock(shard, wPos->second);
+            outcome.wakeupValue = value.ToVector();
+            shard.keyWaiters.erase(wPos);
+        }
+        shard.kvStore.emplace(key, value.ToVector());
+    }
+    outcome.code = StoreErrorCode::SUCCESS;
+    outcome.response = StoreOpOutcome::Text(std::to_string(newSize));
+}
+
+uint64_t AccStoreServer::AddWaiterInLock(StoreShard &shard, const shm::acc::AccTcpRequestContext &context,
+                                         int64_t timeoutMs, const StoreKey *collective) noexcept
+{
+    auto deadline = MonotonicMs() + timeoutMs;
+    StoreWaitContext waitContext{deadline, context};
+    auto id = waitContext.Id();
+    auto &waiter = shard.waitCtx.emplace(id, std::move(waitContext)).first->second;
+    if (timeoutMs > 0) {
+        waiter.SetTimer(shard.timedWaiters.Add(id, deadline));
+    }
+    if (collective != nullptr) {
+        waiter.SetCollective(*collective);
+    }
+    return id;
+}
+
+void AccStoreServer::DropCollectiveWaiterInLock(StoreShard &shard, const StoreKey &key, uint64_t id) noexcept
+{
+    // once its last waiter timed out nobody is left to reply to, the next GATHER or BARRIER on the key starts over
+    auto gPos = shard.gathers.find(key);
+    if (gPos != shard.gathers.end() && gPos->second.waiters.erase(id) > 0 && gPos->second.waiters.empty()) {
+        SHM_LOG_DEBUG("GATHER for key(" << key << ") dropped after its last waiter timed out.");
+        shard.gathers.erase(gPos);
+    }
+    auto bPos = shard.barriers.find(key);
+    if (bPos != shard.barriers.end() && bPos->second.waiters.erase(id) > 0 && bPos->second.waiters.empty()) {
+        SHM_LOG_DEBUG("BARRIER for key(" << key << ") dropped after its last waiter timed out.");
+        shard.barriers.erase(bPos);
+    }
+}
+
 std::list<shm::acc::AccTcpRequestContext> AccStoreServer::GetOutWaitersInLock(
-    const std::unordered_set<uint64_t> &ids) noexcept
+    StoreShard &shard, const std::unordered_set<uint64_t> &ids) noexcept
 {
     std::list<shm::acc::AccTcpRequestContext> reqCtx;
     for (auto id : ids) {
-        auto it = waitCtx_.find(id);
-        if (it != waitCtx_.end()) {
+        auto it = shard.waitCtx.find(id);
+        if (it != shard.waitCtx.end()) {
             reqCtx.emplace_back(std::move(it->second.ReqCtx()));
-            auto wit = timedWaiters_.find(it->second.TimeoutMs());
-            if (wit != timedWaiters_.end()) {
-                wit->second.erase(it->second.Id());
-                if (wit->second.empty()) {
-                    timedWaiters_.erase(wit);
-                }
+            if (it->second.Timed()) {
+                shard.timedWaiters.Cancel(it->second.Timer());
             }
-            waitCtx_.erase(it);
+            shard.waitCtx.erase(it);
         }
     }
-    return std::move(reqCtx);
+    return reqCtx;
 }
 
 void AccStoreServer::WakeupWaiters(const std::list<shm::acc::AccTcpRequestContext> &waiters,
-                                   const std::vector<uint8_t> &value) noexcept
+                                   const SmemBytesView &value) noexcept
 {
-    SmemMessage responseMessage{MessageType::GET};
-    responseMessage.values.push_back(value);
-    auto response = SmemMessagePacker::Pack(responseMessage);
-    for (auto &context : waiters) {
-        SHM_LOG_DEBUG("WAKEUP REQUEST(" << context.SeqNo() << ").");
-        ReplyWithMessage(context, StoreErrorCode::SUCCESS, response);
+    // packed once, every waiter is replied the same buffer by the worker owning its link
+    SmemMessageView responseMessage{MessageType::GET};
+    responseMessage.values.emplace_back(value);
+    auto response = SmemMessagePacker::PackBuffer(responseMessage);
+    if (response == nullptr) {
+        SHM_LOG_ERROR("create wakeup response failed");
+        return;
     }
+    SHM_LOG_DEBUG("WAKEUP " << waiters.size() << " REQUESTS.");
+    shm::acc::AccTcpRequestContext::ReplyAll(waiters, StoreErrorCode::SUCCESS, response);
 }
 
 void AccStoreServer::ReplyWithMessage(const shm::acc::AccTcpRequestContext &ctx, int16_t code,
@@ -533,29 +867,54 @@ void AccStoreServer::ReplyWithMessage(const shm::acc::AccTcpRequestContext &ctx,
     ctx.Reply(code, response);
 }
 
+void AccStoreServer::ReplyWithMessage(const shm::acc::AccTcpRequestContext &ctx, int16_t code,
+                                      const SmemMessageView &message) noexcept
+{
+    auto response = SmemMessagePacker::PackBuffer(message);
+    if (response == nullptr) {
+        SHM_LOG_ERROR("create response message failed");
+        return;
+    }
+
+    ctx.Reply(code, response);
+}
+
 void AccStoreServer::TimerThreadTask() noexcept
 {
-    std::unordered_set<uint64_t> timeoutIds;
+    std::vector<uint64_t> timeoutIds;
+    std::list<shm::acc::AccTcpRequestContext> timeoutContexts;
+    const std::string timeoutMessage = "<timeout>";
+    auto timeoutResponse = shm::acc::AccDataBuffer::Create(timeoutMessage.c_str(), timeoutMessage.size());
+    if (timeoutResponse == nullptr) {
+        SHM_LOG_ERROR("create timeout response failed");
+        return;
+    }
     std::unique_lock<std::mutex> lockerGuard{storeMutex_};
     while (running_) {
-        auto now = std::chrono::steady_clock::now().time_since_epoch();
-        auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
-        while (!timedWaiters_.empty()) {
-            auto it = timedWaiters_.begin();
-            if (it->first > timestamp) {
-                break;
-            }
-            timeoutIds.insert(it->second.begin(), it->second.end());
-            timedWaiters_.erase(it);
-        }
-
-        auto timeoutContexts = GetOutWaitersInLock(timeoutIds);
         lockerGuard.unlock();
+        auto timestamp = MonotonicMs();
+        for (auto &shard : shards_) {
+            // only collect under the shard lock, replies are sent after releasing it
+            std::unique_lock<std::mutex> shardGuard{shard->mutex};
+            shard->timedWaiters.Expire(timestamp, timeoutIds);
+            for (auto id : timeoutIds) {
+                auto it = shard->waitCtx.find(id);
+                if (it != shard->waitCtx.end()) {
+                    if (it->second.Collective() != nullptr) {
+                        DropCollectiveWaiterInLock(*shard, *it->second.Collective(), id);
+                    }
+                    timeoutContexts.emplace_back(std::move(it->second.ReqCtx()));
+                    shard->waitCtx.erase(it);
+                }
+            }
+            shardGuard.unlock();
 
-        timeoutIds.clear();
-        for (auto &ctx : timeoutContexts) {
-            SHM_LOG_DEBUG("reply timeout response for : " << ctx.SeqNo());
-            ReplyWithMessage(ctx, StoreErrorCode::TIMEOUT, "<timeout>");
+            timeoutIds.clear();
+            if (!timeoutContexts.empty()) {
+                SHM_LOG_DEBUG("reply timeout response for " << timeoutContexts.size() << " requests");
+                shm::acc::AccTcpRequestContext::ReplyAll(timeoutContexts, StoreErrorCode::TIMEOUT, timeoutResponse);
+                timeoutContexts.clear();
+            }
         }
 
         lockerGuard.lock();
@@ -13,10 +13,13 @@
 #define STORE_TCP_CONFIG_SERVER_H
 
 #include <list>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <chrono>
-#include <mutex>
 #include <condition_variable>
+#include <ostream>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <system_error>
@@ -24,17 +27,58 @@
 #include "acc_tcp_server.h"
 #include "store_message_packer.h"
 #include "store_obj_ref.h"
+#include "store_op.h"
+#include "store_timer_wheel.h"
 #include "store_utils.h"
 
 namespace shm {
 namespace store {
+/* a request key hashed once, picking the shard and every lookup in it reuse the hash */
+class StoreKey {
+public:
+    explicit StoreKey(std::string_view key) : key_{key}, hash_{std::hash<std::string_view>{}(key)} {}
+
+    const std::string &Str() const noexcept
+    {
+        return key_;
+    }
+
+    size_t Hash() const noexcept
+    {
+        return hash_;
+    }
+
+    bool operator==(const StoreKey &other) const noexcept
+    {
+        return hash_ == other.hash_ && key_ == other.key_;
+    }
+
+    struct Hasher {
+        size_t operator()(const StoreKey &key) const noexcept
+        {
+            return key.hash_;
+        }
+    };
+
+private:
+    std::string key_;
+    size_t hash_;
+};
+
+inline std::ostream &operator<<(std::ostream &os, const StoreKey &key)
+{
+    return os << key.Str();
+}
+
+template <typename T>
+using StoreKeyMap = std::unordered_map<StoreKey, T, StoreKey::Hasher>;
+
 class StoreWaitContext {
 public:
-    StoreWaitContext(int64_t tmMs, std::string key, const shm::acc::AccTcpRequestContext &reqCtx) noexcept
+    StoreWaitContext(int64_t tmMs, const shm::acc::AccTcpRequestContext &reqCtx) noexcept
         : id_{idGen_.fetch_add(1UL)},
           timeoutMs_{tmMs},
-          key_{std::move(key)},
-          reqCtx_{reqCtx}
+          reqCtx_{reqCtx, nullptr}
     {
     }
 
@@ -48,11 +92,6 @@ public:
         return timeoutMs_;
     }
 
-    const std::string &Key() const noexcept
-    {
-        return key_;
-    }
-
     const shm::acc::AccTcpRequestContext &ReqCtx() const noexcept
     {
         return reqCtx_;
@@ -63,57 +102,154 @@ public:
         return reqCtx_;
     }
 
+    void SetTimer(StoreTimerWheel::Handle timer) noexcept
+    {
+        timer_ = timer;
+        timed_ = true;
+    }
+
+    bool Timed() const noexcept
+    {
+        return timed_;
+    }
+
+    StoreTimerWheel::Handle Timer() const noexcept
+    {
+        return timer_;
+    }
+
+    void SetCollective(const StoreKey &key) noexcept
+    {
+        collective_.emplace(key);
+    }
+
+    const StoreKey *Collective() const noexcept
+    {
+        return collective_ ? &*collective_ : nullptr;
+    }
+
 private:
     const uint64_t id_;
     const int64_t timeoutMs_;
-    const std::string key_;
-    shm::acc::AccTcpRequestContext reqCtx_;
+    shm::acc::AccTcpRequestContext reqCtx_;  // only kept for the reply, not the request body
+    StoreTimerWheel::Handle timer_;
+    bool timed_{false};
+    std::optional<StoreKey> collective_;     // key of the GATHER or BARRIER the waiter belongs to
     static std::atomic<uint64_t> idGen_;
 };
 
+/* one pending GATHER: blocks are copied to their rank offset of the response as they arrive */
+struct StoreGatherContext {
+    uint32_t rankSize{0};
+    uint32_t blockSize{0};
+    uint32_t arrived{0};
+    std::vector<bool> ranks;
+    shm::acc::AccDataBufferPtr response;
+    std::unordered_set<uint64_t> waiters;
+};
+
+/* one pending BARRIER, released when arrived reaches rankSize */
+struct StoreBarrierContext {
+    uint32_t rankSize{0};
+    uint32_t arrived{0};
+    std::unordered_set<uint64_t> waiters;
+};
+
 class AccStoreServer : public SmReferable {
 public:
-    AccStoreServer(std::string ip, uint16_t port, int32_t sockFd = -1, uint16_t magic = SMEM_DEFAULT_CONN_MAGIC) noexcept;
+    static constexpr uint32_t DEFAULT_SHARD_COUNT = 16U;
+    static constexpr uint16_t DEFAULT_WORKER_COUNT = 4U;
+    /* the largest send queue a link accepts, leaves room for pipelined requests and their replies */
+    static constexpr uint16_t LINK_SEND_QUEUE_SIZE = shm::acc::UNO_256 - 1U;
+    /* the longest busy poll SHMEM_CONFIG_STORE_BUSY_POLL_US may ask for */
+    static constexpr uint32_t MAX_BUSY_POLL_US = 1000000U;
+
+    AccStoreServer(std::string ip, uint16_t port, int32_t sockFd = -1, uint16_t magic = SMEM_DEFAULT_CONN_MAGIC,
+                   uint32_t shardCount = DEFAULT_SHARD_COUNT, uint16_t workerCount = DEFAULT_WORKER_COUNT) noexcept;
     ~AccStoreServer() override = default;
 
     Result Startup(const AcclinkTlsOption &tlsOption) noexcept;
     void Shutdown(bool afterFork = false) noexcept;
 
+    /* busy poll of the acc workers of both server and clients, from SHMEM_CONFIG_STORE_BUSY_POLL_US, 0 if unset */
+    static uint32_t WorkerBusyPollUs() noexcept;
+
 private:
     Result ReceiveMessageHandler(const shm::acc::AccTcpRequestContext &context) noexcept;
     Result LinkConnectedHandler(const shm::acc::AccConnReq &req, const shm::acc::AccTcpLinkComplexPtr &link) noexcept;
     Result LinkBrokenHandler(const shm::acc::AccTcpLinkComplexPtr &link) noexcept;
 
     /* business handler */
-    Result SetHandler(const shm::acc::AccTcpRequestContext &context, SmemMessage &request) noexcept;
-    Result GetHandler(const shm::acc::AccTcpRequestContext &context, SmemMessage &request) noexcept;
-    Result AddHandler(const shm::acc::AccTcpRequestContext &context, SmemMessage &request) noexcept;
-    Result RemoveHandler(const shm::acc::AccTcpRequestContext &context, SmemMessage &request) noexcept;
-    Result AppendHandler(const shm::acc::AccTcpRequestContext &context, SmemMessage &request) noexcept;
-    Result CasHandler(const shm::acc::AccTcpRequestContext &context, SmemMessage &request) noexcept;
-
-    std::list<shm::acc::AccTcpRequestContext> GetOutWaitersInLock(const std::unordered_set<uint64_t> &ids) noexcept;
-    void WakeupWaiters(const std::list<shm::acc::AccTcpRequestContext> &waiters,
-                       const std::vector<uint8_t> &value) noexcept;
+    Result SetHandler(const shm::acc::AccTcpRequestContext &context, SmemMessageView &request) noexcept;
+    Result GetHandler(const shm::acc::AccTcpRequestContext &context, SmemMessageView &request) noexcept;
+    Result AddHandler(const shm::acc::AccTcpRequestContext &context, SmemMessageView &request) noexcept;
+    Result RemoveHandler(const shm::acc::AccTcpRequestContext &context, SmemMessageView &request) noexcept;
+    Result AppendHandler(const shm::acc::AccTcpRequestContext &context, SmemMessageView &request) noexcept;
+    Result CasHandler(const shm::acc::AccTcpRequestContext &context, SmemMessageView &request) noexcept;
+    Result GatherHandler(const shm::acc::AccTcpRequestContext &context, SmemMessageView &request) noexcept;
+    Result BarrierHandler(const shm::acc::AccTcpRequestContext &context, SmemMessageView &request) noexcept;
+    Result MultiHandler(const shm::acc::AccTcpRequestContext &context, SmemMessageView &request) noexcept;
+
+    /* keys are partitioned by hash, each shard owns its data and waiter indexes under its own lock */
+    struct StoreShard {
+        std::mutex mutex;
+        StoreKeyMap<std::vector<uint8_t>> kvStore;
+        std::unordered_map<uint64_t, StoreWaitContext> waitCtx;
+        StoreKeyMap<std::unordered_set<uint64_t>> keyWaiters;
+        StoreTimerWheel timedWaiters{MonotonicMs()};
+        StoreKeyMap<StoreGatherContext> gathers;
+        StoreKeyMap<StoreBarrierContext> barriers;
+    };
+
+    /* result of one SET/GET/ADD/REMOVE/APPEND, shared by the single request handlers and MULTI */
+    struct StoreOpOutcome {
+        int16_t code{StoreErrorCode::ERROR};
+        std::vector<uint8_t> response;
+        std::list<shm::acc::AccTcpRequestContext> waiters;  // GET waiters to be woken up with wakeupValue
+        std::vector<uint8_t> wakeupValue;
+
+        static std::vector<uint8_t> Text(const std::string &text) noexcept
+        {
+            return std::vector<uint8_t>{text.begin(), text.end()};
+        }
+    };
+
+    StoreShard &ShardOf(const StoreKey &key) noexcept;
+    static int64_t MonotonicMs() noexcept;
+    static bool ParseIncrement(const SmemBytesView &value, long &increment) noexcept;
+    static void SetInLock(StoreShard &shard, const StoreKey &key, std::vector<uint8_t> &value,
+                          StoreOpOutcome &outcome) noexcept;
+    static void GetInLock(StoreShard &shard, const StoreKey &key, StoreOpOutcome &outcome) noexcept;
+    static void AddInLock(StoreShard &shard, const StoreKey &key, long increment, std::vector<uint8_t> &value,
+                          StoreOpOutcome &outcome) noexcept;
+    static void RemoveInLock(StoreShard &shard, const StoreKey &key, StoreOpOutcome &outcome) noexcept;
+    static void AppendInLock(StoreShard &shard, const StoreKey &key, const SmemBytesView &value,
+                             StoreOpOutcome &outcome) noexcept;
+    static uint64_t AddWaiterInLock(StoreShard &shard, const shm::acc::AccTcpRequestContext &context,
+                                    int64_t timeoutMs, const StoreKey *collective = nullptr) noexcept;
+    static void DropCollectiveWaiterInLock(StoreShard &shard, const StoreKey &key, uint64_t id) noexcept;
+    static std::list<shm::acc::AccTcpRequestContext> GetOutWaitersInLock(StoreShard &shard,
+                                                                        const std::unordered_set<uint64_t> &ids) noexcept;
+    void WakeupWaiters(const std::list<shm::acc::AccTcpRequestContext> &waiters, const SmemBytesView &value) noexcept;
     void ReplyWithMessage(const shm::acc::AccTcpRequestContext &ctx, int16_t code, const std::string &message) noexcept;
     void ReplyWithMessage(const shm::acc::AccTcpRequestContext &ctx, int16_t code,
                           const std::vector<uint8_t> &message) noexcept;
+    void ReplyWithMessage(const shm::acc::AccTcpRequestContext &ctx, int16_t code,
+                          const SmemMessageView &message) noexcept;
     void TimerThreadTask() noexcept;
     Result AccServerStart(shm::acc::AccTcpServerPtr &accTcpServer, const AcclinkTlsOption &tlsOption) noexcept;
 
 private:
     static constexpr uint32_t MAX_KEY_LEN_SERVER = 2048U;
 
-    using MessageHandle = int32_t (AccStoreServer::*)(const shm::acc::AccTcpRequestContext &, SmemMessage &);
+    using MessageHandle = int32_t (AccStoreServer::*)(const shm::acc::AccTcpRequestContext &, SmemMessageView &);
     const std::unordered_map<MessageType, MessageHandle> requestHandlers_;
 
-    std::mutex storeMutex_;
+    std::mutex storeMutex_;  // only guards running_ for the timer thread
     std::condition_variable storeCond_;
-    std::unordered_map<std::string, std::vector<uint8_t>> kvStore_;
-    std::unordered_map<uint64_t, StoreWaitContext> waitCtx_;
-    std::unordered_map<std::string, std::unordered_set<uint64_t>> keyWaiters_;
+    std::vector<std::unique_ptr<StoreShard>> shards_;
+    const uint16_t workerCount_;
     shm::acc::AccTcpServerPtr accTcpServer_;
-    std::unordered_map<int64_t, std::unordered_set<uint64_t>> timedWaiters_;
     std::thread timerThread_;
     bool running_{false};
 
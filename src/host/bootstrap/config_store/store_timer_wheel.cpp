@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+#include <algorithm>
+#include <iterator>
+
+#include "store_timer_wheel.h"
+
+namespace shm {
+namespace store {
+StoreTimerWheel::StoreTimerWheel(int64_t nowMs) noexcept : current_{nowMs} {}
+
+StoreTimerWheel::Handle StoreTimerWheel::Add(uint64_t id, int64_t deadlineMs) noexcept
+{
+    spare_.push_back(Entry{id, deadlineMs, 0U, 0U});
+    auto handle = std::prev(spare_.end());
+    // the current tick has been processed already, a due timer fires on the next one
+    Place(spare_, handle, std::max(deadlineMs, current_ + 1));
+    size_++;
+    return handle;
+}
+
+void StoreTimerWheel::Cancel(Handle handle) noexcept
+{
+    wheels_[handle->level][handle->slot].erase(handle);
+    size_--;
+}
+
+void StoreTimerWheel::Expire(int64_t nowMs, std::vector<uint64_t> &expired) noexcept
+{
+    while (current_ < nowMs) {
+        if (size_ == 0) {
+            current_ = nowMs;
+            break;
+        }
+
+        current_++;
+        // entering a new block of a level pulls its slot down, upper levels first as they may refill lower ones
+        for (auto level = LEVEL_COUNT - 1U; level > 0; level--) {
+            if ((current_ & ((1LL << (SLOT_BITS * level)) - 1)) == 0) {
+                Cascade(level);
+            }
+        }
+
+        auto &slot = wheels_[0][current_ & SLOT_MASK];
+        for (auto &entry : slot) {
+            expired.push_back(entry.id);
+        }
+        size_ -= slot.size();
+        slot.clear();
+    }
+}
+
+void StoreTimerWheel::Place(Slot &from, Handle handle, int64_t when) noexcept
+{
+    if (when - current_ >= MAX_SPAN) {
+        when = current_ + MAX_SPAN - 1;
+    }
+
+    auto delta = when - current_;
+    uint32_t level = 0;
+    while (level + 1U < LEVEL_COUNT && delta >= (1LL << (SLOT_BITS * (level + 1U)))) {
+        level++;
+    }
+    auto slot = static_cast<uint32_t>((when >> (SLOT_BITS * level)) & SLOT_MASK);
+    handle->level = level;
+    handle->slot = slot;
+    // splice keeps the handle valid, entries never move in memory
+    auto &to = wheels_[level][slot];
+    to.splice(to.end(), from, handle);
+}
+
+void StoreTimerWheel::Cascade(uint32_t level) noexcept
+{
+    Slot pending;
+    pending.splice(pending.end(), wheels_[level][(current_ >> (SLOT_BITS * level)) & SLOT_MASK]);
+    while (!pending.empty()) {
+        auto handle = pending.begin();
+        Place(pending, handle, std::max(handle->deadline, current_));
+    }
+}
+}  // namespace store
+}  // namespace shm
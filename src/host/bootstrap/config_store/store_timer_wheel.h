@@ -0,0 +1,70 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+#ifndef STORE_TIMER_WHEEL_H
+#define STORE_TIMER_WHEEL_H
+
+#include <array>
+#include <cstdint>
+#include <list>
+#include <vector>
+
+namespace shm {
+namespace store {
+/**
+ * @brief Hierarchical timer wheel with 1ms ticks, 5 levels of 64 slots cover 2^30 ms, longer deadlines are parked
+ * in the last level and re-placed when it cascades. Add and Cancel are O(1), Expire costs one slot per elapsed tick
+ * plus the timers it cascades or fires. Not thread safe, the owner locks.
+ */
+class StoreTimerWheel {
+    struct Entry {
+        uint64_t id;
+        int64_t deadline;
+        uint32_t level;
+        uint32_t slot;
+    };
+    using Slot = std::list<Entry>;
+
+public:
+    using Handle = Slot::iterator;
+
+    explicit StoreTimerWheel(int64_t nowMs) noexcept;
+
+    /* the timer fires on the first Expire whose now is not before deadlineMs */
+    Handle Add(uint64_t id, int64_t deadlineMs) noexcept;
+
+    void Cancel(Handle handle) noexcept;
+
+    /* advances to nowMs and appends the ids of fired timers to expired */
+    void Expire(int64_t nowMs, std::vector<uint64_t> &expired) noexcept;
+
+    uint64_t Size() const noexcept
+    {
+        return size_;
+    }
+
+private:
+    static constexpr uint32_t SLOT_BITS = 6U;
+    static constexpr uint32_t SLOT_COUNT = 1U << SLOT_BITS;
+    static constexpr uint32_t SLOT_MASK = SLOT_COUNT - 1U;
+    static constexpr uint32_t LEVEL_COUNT = 5U;
+    static constexpr int64_t MAX_SPAN = 1LL << (SLOT_BITS * LEVEL_COUNT);
+
+    void Place(Slot &from, Handle handle, int64_t when) noexcept;
+    void Cascade(uint32_t level) noexcept;
+
+    std::array<std::array<Slot, SLOT_COUNT>, LEVEL_COUNT> wheels_;
+    Slot spare_;  // owns entries for an instant between Add and Place
+    int64_t current_;  // last tick processed
+    uint64_t size_{0};
+};
+}  // namespace store
+}  // namespace shm
+
+#endif  // STORE_TIMER_WHEEL_H
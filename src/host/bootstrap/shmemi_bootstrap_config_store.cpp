@@ -181,6 +181,55 @@ static int config_store_bootstrap_allgather(const void *in, void *out, int len,
     return ACLSHMEM_SUCCESS;
 }
 
+static int config_store_bootstrap_alltoallv(const void *in, const int *in_sizes, void *out, const int *out_sizes,
+                                            aclshmemi_bootstrap_handle_t *handle) {
+    if (!in || !in_sizes || !out || !out_sizes || !handle) {
+        SHM_LOG_ERROR("bootstrap alltoallv: invalid arguments (nullptr).");
+        return ACLSHMEM_BOOTSTRAP_ERROR;
+    }
+
+    // Get Bootstrap state
+    auto state = static_cast<ConfigStoreState*>(handle->bootstrap_state);
+    if (!state) return ACLSHMEM_INNER_ERROR;
+
+    std::vector<uint32_t> send_sizes(handle->npes);
+    std::vector<uint32_t> recv_sizes(handle->npes);
+    for (int i = 0; i < handle->npes; i++) {
+        if (in_sizes[i] < 0 || out_sizes[i] < 0) {
+            SHM_LOG_ERROR("bootstrap alltoallv: invalid size for pe " << i);
+            return ACLSHMEM_BOOTSTRAP_ERROR;
+        }
+        send_sizes[i] = static_cast<uint32_t>(in_sizes[i]);
+        recv_sizes[i] = static_cast<uint32_t>(out_sizes[i]);
+    }
+
+    auto ret = (shm::store::SmemGroupEnginePtr(state->group_engine_))->GroupAllToAllV(
+        (const char *)in, send_sizes.data(), (char *)out, recv_sizes.data());
+    if (ret != ACLSHMEM_SUCCESS) {
+        SHM_LOG_ERROR("Group AllToAllV timeout or store failure");
+        return ACLSHMEM_SMEM_ERROR;
+    }
+    return ACLSHMEM_SUCCESS;
+}
+
+static int config_store_bootstrap_alltoall(const void *in, void *out, int len, aclshmemi_bootstrap_handle_t *handle) {
+    if (!in || !out || !handle || len < 0) {
+        SHM_LOG_ERROR("bootstrap alltoall: invalid arguments.");
+        return ACLSHMEM_BOOTSTRAP_ERROR;
+    }
+
+    // Get Bootstrap state
+    auto state = static_cast<ConfigStoreState*>(handle->bootstrap_state);
+    if (!state) return ACLSHMEM_INNER_ERROR;
+
+    auto ret = (shm::store::SmemGroupEnginePtr(state->group_engine_))->GroupAllToAll((const char *)in, len, (char *)out);
+    if (ret != ACLSHMEM_SUCCESS) {
+        SHM_LOG_ERROR("Group AllToAll timeout or store failure");
+        return ACLSHMEM_SMEM_ERROR;
+    }
+    return ACLSHMEM_SUCCESS;
+}
+
 static int config_store_bootstrap_barrier(aclshmemi_bootstrap_handle_t *handle) {
     if (!handle) {
         SHM_LOG_ERROR("bootstrap barrier: invalid arguments (nullptr).");
@@ -269,6 +318,12 @@ int32_t init_group_engine(aclshmemi_bootstrap_handle_t* handle)
         (uint32_t)handle->npes, (uint32_t)handle->mype, handle->timeControlOut * 1000U, false, nullptr, nullptr};
     shm::store::SmemGroupEnginePtr group = shm::store::SmemNetGroupEngine::Create(store_ptr, opt);
     SHM_ASSERT_RETURN(group != nullptr, ACLSHMEM_SMEM_ERROR);
+    if (handle->store_relay && handle->npes > 1) {
+        // barrier and allgather go through one relay per host, pe 0 only sees the relays
+        auto ret = group->StartNodeRelay(handle->session_magic);
+        SHM_VALIDATE_RETURN(ret == ACLSHMEM_SUCCESS, "start config store node relay failed, error: " << ret,
+                            ACLSHMEM_SMEM_ERROR);
+    }
     state->group_engine_ = group;
     return ACLSHMEM_SUCCESS;
 }
@@ -354,7 +409,8 @@ int aclshmemi_bootstrap_plugin_init(void* comm, aclshmemi_bootstrap_handle_t* ha
     handle->allgather = config_store_bootstrap_allgather;
     handle->barrier = config_store_bootstrap_barrier;
     handle->finalize = config_store_bootstrap_finalize;
-    handle->alltoall = nullptr;
+    handle->alltoall = config_store_bootstrap_alltoall;
+    handle->alltoallv = config_store_bootstrap_alltoallv;
     handle->global_exit = config_store_bootstrap_global_exit;
 
     SHM_LOG_INFO("pe " << handle->mype << ": bootstrap plugin initialized successfully");
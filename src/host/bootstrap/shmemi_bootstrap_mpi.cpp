@@ -11,6 +11,7 @@
 #include <mpi.h>
 #include <cstdio>
 #include <cstdlib>
+#include <vector>
 #include "host/shmem_host_def.h"
 #include "utils/shmemi_logger.h"
 #include "utils/shmemi_host_types.h"
@@ -51,6 +52,24 @@ static int aclshmemi_bootstrap_mpi_alltoall(const void *sendbuf, void *recvbuf,
     return status;
 }
 
+static int aclshmemi_bootstrap_mpi_alltoallv(const void *sendbuf, const int *send_sizes, void *recvbuf,
+                                   const int *recv_sizes, aclshmemi_bootstrap_handle_t *handle) {
+    int status = MPI_SUCCESS;
+    int npes = handle->npes;
+    std::vector<int> send_displs(npes, 0);
+    std::vector<int> recv_displs(npes, 0);
+    for (int i = 1; i < npes; i++) {
+        send_displs[i] = send_displs[i - 1] + send_sizes[i - 1];
+        recv_displs[i] = recv_displs[i - 1] + recv_sizes[i - 1];
+    }
+
+    status = MPI_Alltoallv(sendbuf, send_sizes, send_displs.data(), MPI_BYTE, recvbuf, recv_sizes,
+                           recv_displs.data(), MPI_BYTE, aclshmemi_bootstrap_mpi_state.comm);
+    ACLSHMEM_CHECK_RET(status);
+
+    return status;
+}
+
 static void aclshmemi_bootstrap_mpi_global_exit(int status, aclshmemi_bootstrap_handle_t *handle) {
     int rc = MPI_SUCCESS;
 
@@ -123,6 +142,7 @@ int aclshmemi_bootstrap_plugin_init(void *mpi_comm, aclshmemi_bootstrap_handle_t
     ACLSHMEM_CHECK_RET(status);
     handle->allgather = aclshmemi_bootstrap_mpi_allgather;
     handle->alltoall = aclshmemi_bootstrap_mpi_alltoall;
+    handle->alltoallv = aclshmemi_bootstrap_mpi_alltoallv;
     handle->barrier = aclshmemi_bootstrap_mpi_barrier;
     handle->global_exit = aclshmemi_bootstrap_mpi_global_exit;
     handle->finalize = aclshmemi_bootstrap_mpi_finalize;
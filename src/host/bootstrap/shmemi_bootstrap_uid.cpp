@@ -16,7 +16,17 @@
 #include <sys/socket.h>
 #include <netdb.h>
 #include <sys/resource.h>
+#include <sys/epoll.h>
+#include <fcntl.h>
+#include <netinet/tcp.h>
 #include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <new>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 #include "socket/uid_socket.h"
 #include "socket/uid_utils.h"
 #include "bootstrap/config_store/store_net_utils.h"
@@ -27,6 +37,29 @@
 #define BOOTSTRAP_IN_PLACE (void*)0x1
 #define SOCKET_MAGIC 0x243ab9f2fc4b9d6cULL
 
+// allgather算法选择
+#define BOOTSTRAP_ALLGATHER_AUTO 0
+#define BOOTSTRAP_ALLGATHER_RING 1
+#define BOOTSTRAP_ALLGATHER_BRUCK 2
+#define BOOTSTRAP_ALLGATHER_RD 3
+#define BOOTSTRAP_ALLGATHER_RING_MAX_RANKS 8                     // 小规模时环形步数不多，且没有树形的中转拷贝
+#define BOOTSTRAP_ALLGATHER_RING_MIN_BYTES (1UL * 1024 * 1024)   // 总数据量大时耗时取决于带宽，环形每步只传一块
+#define BOOTSTRAP_SENDRECV_INLINE_BYTES (16 * 1024)              // 不超过socket缓冲区时可直接先发后收
+#define BOOTSTRAP_ALLGATHER_TAG_BASE (1 << 30)                  // 与barrier_v2的tag区分
+#define BOOTSTRAP_ALLGATHER_TAG_SEQ_MASK 0xFFFFFU
+#define BOOTSTRAP_ALLGATHER_TAG_STEP_BITS 6
+
+#define BOOTSTRAP_BARRIER_DISSEMINATION 0
+#define BOOTSTRAP_BARRIER_RING 1
+#define BOOTSTRAP_BARRIER_V2 2
+#define BOOTSTRAP_BARRIER_CONN_TAG (1 << 29)                    // 建立barrier常驻连接时使用的tag
+#define BOOTSTRAP_POOL_CONN_TAG (1 << 28)                       // 建立bootstrap_send/recv缓存连接时使用的tag
+#define BOOTSTRAP_ALLTOALL_TAG_BASE (1 << 27)
+#define BOOTSTRAP_ALLTOALL_TAG_SEQ_MASK 0x7FFFFFU
+
+#define BOOTSTRAP_ROOT_EPOLL_EVENTS 256
+#define BOOTSTRAP_ROOT_FANOUT 16                                // root与各级转发rank的路由下发扇出
+
 static const char* env_ip_port = nullptr;
 static const char* env_ifname = nullptr;
 static aclshmemi_bootstrap_uid_state_t aclshmemi_bootstrap_uid_state;
@@ -484,6 +517,14 @@ int32_t aclshmemi_set_ip_info(void *uid, sa_family_t &sockType, char *pta_env_ip
     return ACLSHMEM_SUCCESS;
 }
 
+struct unexpected_msg_table {
+    std::unordered_map<uint64_t, std::deque<std::vector<char>>> msgs;
+};
+
+static uint64_t unexpected_msg_key(int peer, int tag) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(peer)) << 32) | static_cast<uint32_t>(tag);
+}
+
 static int aclshmemi_bootstrap_uid_finalize(aclshmemi_bootstrap_handle_t *handle) {
     if (!handle) {
         return ACLSHMEM_SUCCESS;
@@ -499,6 +540,27 @@ static int aclshmemi_bootstrap_uid_finalize(aclshmemi_bootstrap_handle_t *handle
             elem = next;
         }
         state->unexpected_conns = NULL;
+        for (int step = 0; step < state->barrier_steps; step++) {
+            socket_close(&state->barrier_send_socks[step]);
+            socket_close(&state->barrier_recv_socks[step]);
+        }
+        ACLSHMEM_BOOTSTRAP_PTR_FREE(state->barrier_send_socks);
+        ACLSHMEM_BOOTSTRAP_PTR_FREE(state->barrier_recv_socks);
+        state->barrier_steps = 0;
+        if (state->send_conns != nullptr && state->recv_conns != nullptr) {
+            for (int peer = 0; peer < state->nranks; peer++) {
+                socket_close(&state->send_conns[peer]);
+                socket_close(&state->recv_conns[peer]);
+            }
+        }
+        ACLSHMEM_BOOTSTRAP_PTR_FREE(state->send_conns);
+        ACLSHMEM_BOOTSTRAP_PTR_FREE(state->recv_conns);
+        ACLSHMEM_BOOTSTRAP_PTR_FREE(state->send_broken);
+        state->send_conns = nullptr;
+        state->recv_conns = nullptr;
+        state->send_broken = nullptr;
+        delete state->unexpected_msgs;
+        state->unexpected_msgs = nullptr;
         socket_close(&state->listen_sock);
         socket_close(&state->ring_send_sock);
         socket_close(&state->ring_recv_sock);
@@ -518,7 +580,7 @@ static int aclshmemi_bootstrap_uid_finalize(aclshmemi_bootstrap_handle_t *handle
 }
 
 
-static int aclshmemi_bootstrap_uid_allgather(const void *in, void *out, int len, aclshmemi_bootstrap_handle_t *handle) {
+static int aclshmemi_bootstrap_uid_allgather_ring(const void *in, void *out, int len, aclshmemi_bootstrap_handle_t *handle) {
     if (!in || !out || !handle || !handle->bootstrap_state) {
         SHM_LOG_ERROR("bootstrap allgather: invalid arguments.");
         return ACLSHMEM_BOOTSTRAP_ERROR;
@@ -550,8 +612,8 @@ static int aclshmemi_bootstrap_uid_allgather(const void *in, void *out, int len,
 }
 
 
-static int aclshmemi_bootstrap_uid_barrier(aclshmemi_bootstrap_handle_t *handle) {
-    SHM_LOG_INFO("aclshmemi_bootstrap_uid_barrier");
+static int aclshmemi_bootstrap_uid_barrier_ring(aclshmemi_bootstrap_handle_t *handle) {
+    SHM_LOG_INFO("aclshmemi_bootstrap_uid_barrier_ring");
     if (!handle || !handle->bootstrap_state) {
         SHM_LOG_ERROR("bootstrap barrier: invalid arguments");
         return ACLSHMEM_BOOTSTRAP_ERROR;
@@ -639,6 +701,82 @@ static int unexpected_enqueue(uid_bootstrap_state* state, int peer, int tag, soc
 
     return ACLSHMEM_SUCCESS;
 }
+
+// accept一个新连接并读取对端发来的(rank, tag)连接头
+static int bootstrap_accept_header(uid_bootstrap_state* state, socket_t* sock, int* peer, int* tag) {
+    ACLSHMEM_CHECK_RET(socket_init(sock, SOCKET_TYPE_BOOTSTRAP, SOCKET_MAGIC, NULL), "socket_init new_sock failed");
+    ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_accept(sock, &state->listen_sock), "socket_accept new_sock failed", *sock);
+    ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_recv(sock, peer, sizeof(int)), "socket_recv new_peer failed", *sock);
+    ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_recv(sock, tag, sizeof(int)), "socket_recv new_tag failed", *sock);
+    return ACLSHMEM_SUCCESS;
+}
+
+// 登记不是当前所等待的连接：连接池连接放入recv_conns，其余进入意外连接队列
+static int bootstrap_register_conn(uid_bootstrap_state* state, int peer, int tag, socket_t* sock) {
+    if (tag != BOOTSTRAP_POOL_CONN_TAG) {
+        ACLSHMEM_CHECK_RET_CLOSE_SOCK(unexpected_enqueue(state, peer, tag, sock), "unexpected_enqueue failed", *sock);
+        return ACLSHMEM_SUCCESS;
+    }
+    if (peer < 0 || peer >= state->nranks || state->recv_conns[peer].fd >= 0) {
+        SHM_LOG_ERROR("pe " << state->rank << ": unexpected pool connection from peer " << peer);
+        socket_close(sock);
+        return ACLSHMEM_BOOTSTRAP_ERROR;
+    }
+    std::copy_n(reinterpret_cast<const char*>(sock), sizeof(socket_t), reinterpret_cast<char*>(&state->recv_conns[peer]));
+    return ACLSHMEM_SUCCESS;
+}
+
+// 取得(peer, tag)对应的专用连接，先查意外连接队列，否则持续accept
+static int bootstrap_accept_conn(uid_bootstrap_state* state, int peer, int tag, socket_t* sock) {
+    int found = 0;
+    ACLSHMEM_CHECK_RET(unexpected_dequeue(state, peer, tag, sock, &found));
+    if (found == 1) {
+        return ACLSHMEM_SUCCESS;
+    }
+    while (1) {
+        socket_t new_sock;
+        int new_peer = -1;
+        int new_tag = -1;
+        ACLSHMEM_CHECK_RET(bootstrap_accept_header(state, &new_sock, &new_peer, &new_tag));
+        if (new_peer == peer && new_tag == tag) {
+            std::copy_n(reinterpret_cast<const char*>(&new_sock), sizeof(socket_t), reinterpret_cast<char*>(sock));
+            return ACLSHMEM_SUCCESS;
+        }
+        ACLSHMEM_CHECK_RET(bootstrap_register_conn(state, new_peer, new_tag, &new_sock));
+    }
+}
+
+// 等待peer到本rank的连接池连接建立，期间accept到的其他连接一并登记
+static int bootstrap_pool_recv_conn(uid_bootstrap_state* state, int peer) {
+    while (state->recv_conns[peer].fd < 0) {
+        socket_t new_sock;
+        int new_peer = -1;
+        int new_tag = -1;
+        ACLSHMEM_CHECK_RET(bootstrap_accept_header(state, &new_sock, &new_peer, &new_tag));
+        ACLSHMEM_CHECK_RET(bootstrap_register_conn(state, new_peer, new_tag, &new_sock));
+    }
+    return ACLSHMEM_SUCCESS;
+}
+
+// 每个peer只在首次发送时建链，之后的消息以(tag, size)为帧头复用该连接
+static int bootstrap_pool_send(uid_bootstrap_state* state, int peer, int tag, void* data, int size) {
+    socket_t* sock = &state->send_conns[peer];
+    if (sock->fd < 0) {
+        int conn_tag = BOOTSTRAP_POOL_CONN_TAG;
+        ACLSHMEM_CHECK_RET(socket_init(sock, SOCKET_TYPE_BOOTSTRAP, state->magic, &state->peer_addrs[peer]), "bootstrap_send: socket_init failed for peer " << peer);
+        ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_connect(sock), "bootstrap_send: socket_connect failed for peer " << peer, *sock);
+        ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_send(sock, &state->rank, sizeof(int)), "bootstrap_send: send rank failed to peer " << peer, *sock);
+        ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_send(sock, &conn_tag, sizeof(int)), "bootstrap_send: send pool tag failed to peer " << peer, *sock);
+    }
+    int header[2] = {tag, size};
+    ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_send(sock, header, sizeof(header)), "bootstrap_send: send tag " << tag << " failed to peer " << peer, *sock);
+    if (size > 0) {
+        ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_send(sock, data, size), "bootstrap_send: send data (size=" << size << ") failed to peer " << peer, *sock);
+    }
+    return ACLSHMEM_SUCCESS;
+}
+
+// 接收端每个peer只登记一条缓存连接，发送失败后重连会被拒绝，且旧连接上可能已残留半帧，因此失败对该peer是致命的
 static int bootstrap_send(void* comm_state, int peer, int tag, void* data, int size) {
     if (comm_state == nullptr || data == nullptr || size < 0 || peer < 0) {
         SHM_LOG_ERROR("bootstrap_send: invalid arguments");
@@ -646,54 +784,193 @@ static int bootstrap_send(void* comm_state, int peer, int tag, void* data, int s
     }
 
     uid_bootstrap_state* state = (uid_bootstrap_state*)comm_state;
-    socket_t sock;
-    ACLSHMEM_CHECK_RET(socket_init(&sock, SOCKET_TYPE_BOOTSTRAP, state->magic, &state->peer_addrs[peer]), "bootstrap_send: socket_init failed for peer " << peer);
-
-    ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_connect(&sock), "bootstrap_send: socket_connect failed for peer " << peer, sock);
-    ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_send(&sock, &state->rank, sizeof(int)), "bootstrap_send: send rank failed to peer " << peer, sock);
-    ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_send(&sock, &tag, sizeof(int)), "bootstrap_send: send tag " << tag << " failed to peer " << peer, sock);
-    ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_send(&sock, data, size), "bootstrap_send: send data (size=" << size << ") failed to peer " << peer, sock);
-    if (sock.fd >= 0) {
-        socket_close(&sock);
+    if (state->send_broken[peer] != 0) {
+        SHM_LOG_ERROR("pe " << state->rank << ": connection to peer " << peer << " broken by an earlier send failure");
+        return ACLSHMEM_BOOTSTRAP_ERROR;
     }
-    return ACLSHMEM_SUCCESS;
+    auto ret = bootstrap_pool_send(state, peer, tag, data, size);
+    if (ret != ACLSHMEM_SUCCESS) {
+        state->send_broken[peer] = 1;
+    }
+    return ret;
 }
 
-
+// 同一peer的消息按序到达同一连接，先于所等tag到达的消息按(peer, tag)暂存
 static int bootstrap_recv(void* comm_state, int peer, int tag, void* data, int size) {
     if (comm_state == NULL || data == NULL || size < 0 || peer < 0) {
         return ACLSHMEM_BOOTSTRAP_ERROR;
     }
 
     uid_bootstrap_state* state = (uid_bootstrap_state*)comm_state;
-    socket_t sock;
-    int found = 0;
-    int retry_count = 0;
-    int ret = ACLSHMEM_SUCCESS;
-    ACLSHMEM_CHECK_RET(unexpected_dequeue(state, peer, tag, &sock, &found));
-
-    if (found == 1) {
-        ret = socket_recv(&sock, data, size);
-        socket_close(&sock);
-        return (ret == ACLSHMEM_SUCCESS) ? ACLSHMEM_SUCCESS : ACLSHMEM_BOOTSTRAP_ERROR;
+    auto& msgs = state->unexpected_msgs->msgs;
+    auto it = msgs.find(unexpected_msg_key(peer, tag));
+    if (it != msgs.end()) {
+        std::vector<char> msg = std::move(it->second.front());
+        it->second.pop_front();
+        if (it->second.empty()) {
+            msgs.erase(it);
+        }
+        ACLSHMEM_CHECK_RET(static_cast<int>(msg.size()) != size, "pe " << state->rank << ": recv size mismatch, peer: " << peer << " tag: " << tag << " expect: " << size << " got: " << msg.size(), ACLSHMEM_BOOTSTRAP_ERROR);
+        std::copy_n(msg.data(), size, (char*)data);
+        return ACLSHMEM_SUCCESS;
     }
+
+    ACLSHMEM_CHECK_RET(bootstrap_pool_recv_conn(state, peer), "pe " << state->rank << ": accept failed, peer: " << peer);
+    socket_t* sock = &state->recv_conns[peer];
     while (1) {
-        socket_t new_sock;
-        int new_peer = -1;
-        int new_tag = -1;
-        ACLSHMEM_CHECK_RET(socket_init(&new_sock, SOCKET_TYPE_BOOTSTRAP, SOCKET_MAGIC, NULL), "socket_init new_sock failed");
-        ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_accept(&new_sock, &state->listen_sock), "socket_accept new_sock failed", new_sock);
-        ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_recv(&new_sock, &new_peer, sizeof(int)), "socket_recv new_peer failed", new_sock);
-        ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_recv(&new_sock, &new_tag, sizeof(int)), "socket_recv new_tag failed", new_sock);
-        if (new_peer == peer && new_tag == tag) {
-            ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_recv(&new_sock, data, size), "socket_recv failed", new_sock);
+        int header[2] = {-1, -1};
+        ACLSHMEM_CHECK_RET(socket_recv(sock, header, sizeof(header)), "pe " << state->rank << ": recv header failed, peer: " << peer);
+        if (header[1] < 0) {
+            SHM_LOG_ERROR("pe " << state->rank << ": invalid message size " << header[1] << " from peer " << peer);
+            return ACLSHMEM_BOOTSTRAP_ERROR;
+        }
+        if (header[0] == tag) {
+            ACLSHMEM_CHECK_RET(header[1] != size, "pe " << state->rank << ": recv size mismatch, peer: " << peer << " tag: " << tag << " expect: " << size << " got: " << header[1], ACLSHMEM_BOOTSTRAP_ERROR);
+            if (size > 0) {
+                ACLSHMEM_CHECK_RET(socket_recv(sock, data, size), "pe " << state->rank << ": recv data failed, peer: " << peer << " tag: " << tag);
+            }
             return ACLSHMEM_SUCCESS;
-        } else {
-            ACLSHMEM_CHECK_RET_CLOSE_SOCK(unexpected_enqueue(state, new_peer, new_tag, &new_sock), "unexpected_enqueue failed", new_sock);
         }
+        std::vector<char> msg(header[1]);
+        if (header[1] > 0) {
+            ACLSHMEM_CHECK_RET(socket_recv(sock, msg.data(), header[1]), "pe " << state->rank << ": recv data failed, peer: " << peer << " tag: " << header[0]);
+        }
+        msgs[unexpected_msg_key(peer, header[0])].push_back(std::move(msg));
     }
 }
 
+static int bootstrap_sendrecv(uid_bootstrap_state* state, int dst, void* send_data, int send_size,
+                              int src, void* recv_data, int recv_size, int tag) {
+    if (send_size <= BOOTSTRAP_SENDRECV_INLINE_BYTES) {
+        ACLSHMEM_CHECK_RET(bootstrap_send(state, dst, tag, send_data, send_size), "pe " << state->rank << ": send failed, dst: " << dst << " tag: " << tag);
+        ACLSHMEM_CHECK_RET(bootstrap_recv(state, src, tag, recv_data, recv_size), "pe " << state->rank << ": recv failed, src: " << src << " tag: " << tag);
+        return ACLSHMEM_SUCCESS;
+    }
+
+    // 所有rank同时先发，数据超过socket缓冲区时会环形互等，因此大消息的发送放到单独线程与接收并行
+    int send_ret = ACLSHMEM_SUCCESS;
+    std::thread sender([&send_ret, state, dst, tag, send_data, send_size]() {
+        send_ret = bootstrap_send(state, dst, tag, send_data, send_size);
+    });
+    int recv_ret = bootstrap_recv(state, src, tag, recv_data, recv_size);
+    sender.join();
+    ACLSHMEM_CHECK_RET(send_ret, "pe " << state->rank << ": send failed, dst: " << dst << " tag: " << tag);
+    ACLSHMEM_CHECK_RET(recv_ret, "pe " << state->rank << ": recv failed, src: " << src << " tag: " << tag);
+    return ACLSHMEM_SUCCESS;
+}
+
+static int bootstrap_allgather_tag(uid_bootstrap_state* state, int step) {
+    return BOOTSTRAP_ALLGATHER_TAG_BASE |
+           static_cast<int>((state->coll_seq & BOOTSTRAP_ALLGATHER_TAG_SEQ_MASK) << BOOTSTRAP_ALLGATHER_TAG_STEP_BITS) | step;
+}
+
+// Bruck: 第k步把已收集的前min(2^k, n-2^k)块发给rank-2^k，从rank+2^k收取，共ceil(log2(n))步，适用于任意rank数
+static int aclshmemi_bootstrap_uid_allgather_bruck(const void *in, void *out, int len, uid_bootstrap_state* state) {
+    int rank = state->rank;
+    int nranks = state->nranks;
+    size_t block = static_cast<size_t>(len);
+    // tmp中第i块为rank (rank + i) % nranks 的数据
+    std::vector<char> tmp(block * nranks);
+    const char* self = (in == BOOTSTRAP_IN_PLACE) ? (const char*)out + rank * block : (const char*)in;
+    std::copy_n(self, block, tmp.data());
+
+    int step = 0;
+    for (int dist = 1; dist < nranks; dist <<= 1, step++) {
+        int count = std::min(dist, nranks - dist);
+        int dst = (rank - dist + nranks) % nranks;
+        int src = (rank + dist) % nranks;
+        ACLSHMEM_CHECK_RET(bootstrap_sendrecv(state, dst, tmp.data(), count * len, src, tmp.data() + dist * block,
+                                              count * len, bootstrap_allgather_tag(state, step)),
+                           "pe " << rank << ": bruck allgather step " << step << " failed");
+    }
+
+    for (int i = 0; i < nranks; i++) {
+        std::copy_n(tmp.data() + i * block, block, (char*)out + ((rank + i) % nranks) * block);
+    }
+    return ACLSHMEM_SUCCESS;
+}
+
+// 递归倍增: 第k步与rank^2^k交换各自已收集的2^k块，数据直接落在out中的最终位置，仅适用于2的幂
+static int aclshmemi_bootstrap_uid_allgather_rd(const void *in, void *out, int len, uid_bootstrap_state* state) {
+    int rank = state->rank;
+    int nranks = state->nranks;
+    size_t block = static_cast<size_t>(len);
+    if (in != BOOTSTRAP_IN_PLACE) {
+        std::copy_n((const char*)in, block, (char*)out + rank * block);
+    }
+
+    int step = 0;
+    for (int dist = 1; dist < nranks; dist <<= 1, step++) {
+        int peer = rank ^ dist;
+        char* send_data = (char*)out + (rank & ~(dist - 1)) * block;
+        char* recv_data = (char*)out + (peer & ~(dist - 1)) * block;
+        ACLSHMEM_CHECK_RET(bootstrap_sendrecv(state, peer, send_data, dist * len, peer, recv_data, dist * len,
+                                              bootstrap_allgather_tag(state, step)),
+                           "pe " << rank << ": recursive doubling allgather step " << step << " failed");
+    }
+    return ACLSHMEM_SUCCESS;
+}
+
+static int bootstrap_allgather_algo(uid_bootstrap_state* state, int len) {
+    int nranks = state->nranks;
+    if (state->allgather_algo == BOOTSTRAP_ALLGATHER_RD && (nranks & (nranks - 1)) != 0) {
+        return BOOTSTRAP_ALLGATHER_BRUCK;
+    }
+    if (state->allgather_algo != BOOTSTRAP_ALLGATHER_AUTO) {
+        return state->allgather_algo;
+    }
+    // 环形n-1步，树形log(n)步但每步传送的数据翻倍；树形的连接首次使用后即缓存复用，没有每步建连的开销。
+    // 阈值取回环实测的交叉点：PE数少或总数据量大时环形更快
+    if (nranks <= BOOTSTRAP_ALLGATHER_RING_MAX_RANKS ||
+        static_cast<uint64_t>(len) * nranks >= BOOTSTRAP_ALLGATHER_RING_MIN_BYTES) {
+        return BOOTSTRAP_ALLGATHER_RING;
+    }
+    return (nranks & (nranks - 1)) == 0 ? BOOTSTRAP_ALLGATHER_RD : BOOTSTRAP_ALLGATHER_BRUCK;
+}
+
+static int aclshmemi_bootstrap_uid_allgather(const void *in, void *out, int len, aclshmemi_bootstrap_handle_t *handle) {
+    if (!in || !out || len <= 0 || !handle || !handle->bootstrap_state) {
+        SHM_LOG_ERROR("bootstrap allgather: invalid arguments.");
+        return ACLSHMEM_BOOTSTRAP_ERROR;
+    }
+
+    uid_bootstrap_state* state = (uid_bootstrap_state*) handle->bootstrap_state;
+    if (state->nranks == 1) {
+        if (in != BOOTSTRAP_IN_PLACE) {
+            std::copy_n((const char*)in, len, (char*)out);
+        }
+        return ACLSHMEM_SUCCESS;
+    }
+
+    auto algo = bootstrap_allgather_algo(state, len);
+    if (algo == BOOTSTRAP_ALLGATHER_RING) {
+        return aclshmemi_bootstrap_uid_allgather_ring(in, out, len, handle);
+    }
+    state->coll_seq++;
+    if (algo == BOOTSTRAP_ALLGATHER_RD) {
+        return aclshmemi_bootstrap_uid_allgather_rd(in, out, len, state);
+    }
+    return aclshmemi_bootstrap_uid_allgather_bruck(in, out, len, state);
+}
+
+static int bootstrap_allgather_algo_from_env() {
+    const char* env_algo = std::getenv("SHMEM_BOOTSTRAP_ALLGATHER_ALGO");
+    if (env_algo == nullptr || strcmp(env_algo, "auto") == 0) {
+        return BOOTSTRAP_ALLGATHER_AUTO;
+    }
+    if (strcmp(env_algo, "ring") == 0) {
+        return BOOTSTRAP_ALLGATHER_RING;
+    }
+    if (strcmp(env_algo, "bruck") == 0) {
+        return BOOTSTRAP_ALLGATHER_BRUCK;
+    }
+    if (strcmp(env_algo, "rd") == 0) {
+        return BOOTSTRAP_ALLGATHER_RD;
+    }
+    SHM_LOG_WARN("Invalid SHMEM_BOOTSTRAP_ALLGATHER_ALGO: " << env_algo << ", use auto.");
+    return BOOTSTRAP_ALLGATHER_AUTO;
+}
+
 static int aclshmemi_bootstrap_uid_barrier_v2(aclshmemi_bootstrap_handle_t *handle) {
     SHM_LOG_INFO("aclshmemi_bootstrap_uid_barrier_v2");
     uid_bootstrap_state* state = (uid_bootstrap_state*)(handle->bootstrap_state);
@@ -722,13 +999,121 @@ static int aclshmemi_bootstrap_uid_barrier_v2(aclshmemi_bootstrap_handle_t *hand
     return ACLSHMEM_SUCCESS;
 }
 
+// 每步使用初始化时建立的常驻连接，不再逐次connect/accept，共ceil(log2(n))步
+static int aclshmemi_bootstrap_uid_barrier_dissemination(aclshmemi_bootstrap_handle_t *handle) {
+    if (!handle || !handle->bootstrap_state) {
+        SHM_LOG_ERROR("bootstrap barrier: invalid arguments");
+        return ACLSHMEM_BOOTSTRAP_ERROR;
+    }
+
+    uid_bootstrap_state* state = (uid_bootstrap_state*) handle->bootstrap_state;
+    int rank = state->rank;
+    char token = 0;
+    for (int step = 0; step < state->barrier_steps; step++) {
+        ACLSHMEM_CHECK_RET(socket_send(&state->barrier_send_socks[step], &token, 1), "pe " << rank << ": barrier send failed, step: " << step);
+        ACLSHMEM_CHECK_RET(socket_recv(&state->barrier_recv_socks[step], &token, 1), "pe " << rank << ": barrier recv failed, step: " << step);
+    }
+    return ACLSHMEM_SUCCESS;
+}
+
+// 建立dissemination barrier的常驻连接：先向rank+2^k全部发起连接（对端listen backlog即可完成握手），再逐步accept来自rank-2^k的连接
+static int bootstrap_barrier_connect(uid_bootstrap_state* state) {
+    int rank = state->rank;
+    int nranks = state->nranks;
+    int steps = 0;
+    for (int dist = 1; dist < nranks; dist <<= 1) {
+        steps++;
+    }
+    if (steps == 0) {
+        return ACLSHMEM_SUCCESS;
+    }
+
+    ACLSHMEM_CHECK_RET(ACLSHMEM_BOOTSTRAP_CALLOC(&state->barrier_send_socks, steps));
+    ACLSHMEM_CHECK_RET(ACLSHMEM_BOOTSTRAP_CALLOC(&state->barrier_recv_socks, steps));
+    for (int step = 0; step < steps; step++) {
+        state->barrier_send_socks[step].fd = -1;
+        state->barrier_recv_socks[step].fd = -1;
+    }
+    state->barrier_steps = steps;
+
+    for (int step = 0; step < steps; step++) {
+        int dst = (rank + (1 << step)) % nranks;
+        int tag = BOOTSTRAP_BARRIER_CONN_TAG | step;
+        socket_t* sock = &state->barrier_send_socks[step];
+        ACLSHMEM_CHECK_RET(socket_init(sock, SOCKET_TYPE_BOOTSTRAP, state->magic, &state->peer_addrs[dst]), "pe " << rank << ": barrier socket_init failed for peer " << dst);
+        ACLSHMEM_CHECK_RET(socket_connect(sock), "pe " << rank << ": barrier socket_connect failed for peer " << dst);
+        ACLSHMEM_CHECK_RET(socket_send(sock, &state->rank, sizeof(int)), "pe " << rank << ": barrier send rank failed to peer " << dst);
+        ACLSHMEM_CHECK_RET(socket_send(sock, &tag, sizeof(int)), "pe " << rank << ": barrier send tag failed to peer " << dst);
+    }
+    for (int step = 0; step < steps; step++) {
+        int src = (rank - (1 << step) + nranks) % nranks;
+        ACLSHMEM_CHECK_RET(bootstrap_accept_conn(state, src, BOOTSTRAP_BARRIER_CONN_TAG | step, &state->barrier_recv_socks[step]),
+                           "pe " << rank << ": barrier accept failed for peer " << src);
+    }
+    return ACLSHMEM_SUCCESS;
+}
+
+static int bootstrap_barrier_algo_from_env() {
+    const char* env_algo = std::getenv("SHMEM_BOOTSTRAP_BARRIER_ALGO");
+    if (env_algo == nullptr || strcmp(env_algo, "dissemination") == 0) {
+        return BOOTSTRAP_BARRIER_DISSEMINATION;
+    }
+    if (strcmp(env_algo, "ring") == 0) {
+        return BOOTSTRAP_BARRIER_RING;
+    }
+    if (strcmp(env_algo, "v2") == 0) {
+        return BOOTSTRAP_BARRIER_V2;
+    }
+    SHM_LOG_WARN("Invalid SHMEM_BOOTSTRAP_BARRIER_ALGO: " << env_algo << ", use dissemination.");
+    return BOOTSTRAP_BARRIER_DISSEMINATION;
+}
+
+// 成对交换: 第k步发往rank+k、从rank-k接收，共n-1步，经由bootstrap_send/recv的缓存连接，每个PE只收发自己的那一块
+static int aclshmemi_bootstrap_uid_alltoallv(const void *sendbuf, const int *send_sizes, void *recvbuf,
+                                             const int *recv_sizes, aclshmemi_bootstrap_handle_t *handle) {
+    if (!sendbuf || !send_sizes || !recvbuf || !recv_sizes || !handle || !handle->bootstrap_state) {
+        SHM_LOG_ERROR("bootstrap alltoallv: invalid arguments.");
+        return ACLSHMEM_BOOTSTRAP_ERROR;
+    }
+
+    uid_bootstrap_state* state = (uid_bootstrap_state*) handle->bootstrap_state;
+    int rank = state->rank;
+    int nranks = state->nranks;
+    std::vector<size_t> send_displs(nranks + 1, 0);
+    std::vector<size_t> recv_displs(nranks + 1, 0);
+    for (int i = 0; i < nranks; i++) {
+        if (send_sizes[i] < 0 || recv_sizes[i] < 0) {
+            SHM_LOG_ERROR("bootstrap alltoallv: invalid size for pe " << i);
+            return ACLSHMEM_BOOTSTRAP_ERROR;
+        }
+        send_displs[i + 1] = send_displs[i] + send_sizes[i];
+        recv_displs[i + 1] = recv_displs[i] + recv_sizes[i];
+    }
+    if (send_sizes[rank] != recv_sizes[rank]) {
+        SHM_LOG_ERROR("bootstrap alltoallv: self block size mismatch, send " << send_sizes[rank] << " recv " << recv_sizes[rank]);
+        return ACLSHMEM_BOOTSTRAP_ERROR;
+    }
+    std::copy_n((const char*)sendbuf + send_displs[rank], send_sizes[rank], (char*)recvbuf + recv_displs[rank]);
+
+    int tag = BOOTSTRAP_ALLTOALL_TAG_BASE | static_cast<int>(++state->coll_seq & BOOTSTRAP_ALLTOALL_TAG_SEQ_MASK);
+    for (int k = 1; k < nranks; k++) {
+        int dst = (rank + k) % nranks;
+        int src = (rank - k + nranks) % nranks;
+        ACLSHMEM_CHECK_RET(bootstrap_sendrecv(state, dst, (char*)sendbuf + send_displs[dst], send_sizes[dst], src,
+                                              (char*)recvbuf + recv_displs[src], recv_sizes[src], tag),
+                           "pe " << rank << ": alltoall step " << k << " failed");
+    }
+    return ACLSHMEM_SUCCESS;
+}
+
 static int aclshmemi_bootstrap_uid_alltoall(const void *sendbuf, void *recvbuf, int length,
                                   aclshmemi_bootstrap_handle_t *handle) {
-    (void)sendbuf;
-    (void)recvbuf;
-    (void)length;
-    (void)handle;
-    return ACLSHMEM_NOT_SUPPORTED;
+    if (!handle || length < 0) {
+        SHM_LOG_ERROR("bootstrap alltoall: invalid arguments.");
+        return ACLSHMEM_BOOTSTRAP_ERROR;
+    }
+    std::vector<int> sizes(handle->npes, length);
+    return aclshmemi_bootstrap_uid_alltoallv(sendbuf, sizes.data(), recvbuf, sizes.data(), handle);
 }
 
 static void aclshmemi_bootstrap_uid_global_exit(int status, aclshmemi_bootstrap_handle_t *handle) {
@@ -1017,154 +1402,297 @@ static int set_files_limit() {
     return ACLSHMEM_SUCCESS;
 }
 
-static void* bootstrap_root(void* rargs) {
-    struct bootstrap_root_args* args = (struct bootstrap_root_args*)rargs;
-    if (args == NULL || args->listen_sock == NULL) {
-        SHM_LOG_ERROR("bootstrap_root: invalid args");
-        return NULL;
-    }
+// root登记阶段每个连接的状态：握手(magic+type) -> 版本号 -> bootstrap_ext_info
+enum bootstrap_root_stage {
+    ROOT_STAGE_HANDSHAKE,
+    ROOT_STAGE_VERSION,
+    ROOT_STAGE_INFO,
+};
+
+struct bootstrap_root_conn {
+    int stage = ROOT_STAGE_HANDSHAKE;
+    int received = 0;
+    union {
+        struct {
+            uint64_t magic;
+            socket_type_t type;
+        } __attribute__((packed)) handshake;
+        int version;
+        bootstrap_ext_info info;
+    } buf;
+};
+
+static int bootstrap_root_stage_size(int stage) {
+    if (stage == ROOT_STAGE_HANDSHAKE) {
+        return sizeof(uint64_t) + sizeof(socket_type_t);
+    }
+    return stage == ROOT_STAGE_VERSION ? sizeof(int) : sizeof(bootstrap_ext_info);
+}
 
-    socket_t* listen_sock = args->listen_sock;
-    uint64_t magic = args->magic;
-    int root_version = args->version;
+struct bootstrap_root_registry {
+    uint64_t magic;
+    int root_version;
     int nranks = 0;
-    int c = 0;  // Number of received nodes.
-    bootstrap_ext_info info;
-    sockaddr_t* zero_addr = nullptr;
-    ACLSHMEM_BOOTSTRAP_CALLOC(&zero_addr, 1);
-    sockaddr_t* rank_addrs = NULL;  // Store the common listening addresses of all nodes.
-    sockaddr_t* rank_addrs_root = NULL;  // Store the dedicated root addresses for all nodes.
-
-    if (zero_addr == NULL) {
-        SHM_LOG_ERROR("bootstrap_root: calloc zero_addr failed");
-        ACLSHMEM_BOOTSTRAP_PTR_FREE(args);
-        return NULL;
+    int registered = 0;
+    std::vector<sockaddr_t> rank_addrs;       // 各rank的公共监听地址
+    std::vector<sockaddr_t> rank_addrs_root;  // 各rank接收root路由消息的监听地址
+    std::vector<char> seen;
+};
+
+static int bootstrap_root_register(bootstrap_root_registry* reg, const bootstrap_ext_info& info) {
+    if (reg->registered == 0) {
+        if (info.nranks <= 0) {
+            SHM_LOG_ERROR("bootstrap_root: invalid nranks");
+            return ACLSHMEM_BOOTSTRAP_ERROR;
+        }
+        reg->nranks = info.nranks;
+        reg->rank_addrs.resize(reg->nranks);
+        reg->rank_addrs_root.resize(reg->nranks);
+        reg->seen.assign(reg->nranks, 0);
     }
-
-    // Adjusting file descriptor limits (the root node needs to handle multiple connections)
-    if (set_files_limit() != 0) {
-        SHM_LOG_ERROR("bootstrap_root: set_files_limit failed");
-        ACLSHMEM_BOOTSTRAP_PTR_FREE(zero_addr);
-        ACLSHMEM_BOOTSTRAP_PTR_FREE(args);
-        return NULL;
+    if (info.nranks != reg->nranks || info.rank < 0 || info.rank >= reg->nranks) {
+        SHM_LOG_ERROR("bootstrap_root: invalid info from rank " << info.rank);
+        return ACLSHMEM_BOOTSTRAP_ERROR;
     }
+    if (reg->seen[info.rank]) {
+        SHM_LOG_ERROR("bootstrap_root: duplicate rank " << info.rank);
+        return ACLSHMEM_BOOTSTRAP_ERROR;
+    }
+    reg->seen[info.rank] = 1;
+    reg->rank_addrs[info.rank] = info.ext_addr_listen;
+    reg->rank_addrs_root[info.rank] = info.ext_address_listen_root;
+    reg->registered++;
+    return ACLSHMEM_SUCCESS;
+}
 
-    // Continuously receive connections and information from all slave nodes
-    while (1) {
-        socket_t client_sock;
-        // Initialize client socket (for receiving connections from a single slave node)
-        if (socket_init(&client_sock, SOCKET_TYPE_BOOTSTRAP, SOCKET_MAGIC, NULL) != 0) {
-            SHM_LOG_ERROR("bootstrap_root: socket_init failed");
-            break;
-        }
-
-        // Accept connections from the node (blocking wait)
-        if (socket_accept(&client_sock, listen_sock) != 0) {
-            SHM_LOG_ERROR("bootstrap_root: socket_accept failed");
-            socket_close(&client_sock);
-            break;
-        }
-
-        // Version verification
-        int peer_version;
-        if (socket_recv(&client_sock, &peer_version, sizeof(peer_version)) != 0) {
-            SHM_LOG_ERROR("bootstrap_root: recv peer_version failed");
-            socket_close(&client_sock);
-            break;
-        }
-        if (socket_send(&client_sock, &root_version, sizeof(root_version)) != 0) {
-            SHM_LOG_ERROR("bootstrap_root: send root_version failed");
-            socket_close(&client_sock);
-            break;
+// 推进一个登记连接，返回后*done表示该连接已结束(完成或被丢弃)
+static int bootstrap_root_progress(bootstrap_root_registry* reg, int fd, bootstrap_root_conn* conn, bool* done) {
+    *done = false;
+    while (true) {
+        int size = bootstrap_root_stage_size(conn->stage);
+        char* data = reinterpret_cast<char*>(&conn->buf);
+        ssize_t bytes = recv(fd, data + conn->received, size - conn->received, MSG_DONTWAIT);
+        if (bytes == 0) {
+            SHM_LOG_ERROR("bootstrap_root: peer closed during registration, fd: " << fd);
+            return ACLSHMEM_BOOTSTRAP_ERROR;
         }
-        if (peer_version != root_version) {
-            SHM_LOG_ERROR("bootstrap_root: version mismatch");
-            socket_close(&client_sock);
-            break;
+        if (bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return ACLSHMEM_SUCCESS;
+            }
+            SHM_LOG_ERROR("bootstrap_root: recv failed: " << strerror(errno));
+            return ACLSHMEM_BOOTSTRAP_ERROR;
         }
-
-        // Receive address information from the node
-        if (socket_recv(&client_sock, &info, sizeof(info)) != 0) {
-            SHM_LOG_ERROR("bootstrap_root: recv info failed");
-            socket_close(&client_sock);
-            break;
+        conn->received += bytes;
+        if (conn->received < size) {
+            continue;
         }
-        socket_close(&client_sock);
 
-        // Initialize the address array upon first reception
-        if (c == 0) {
-            nranks = info.nranks;
-            if (nranks <= 0) {
-                SHM_LOG_ERROR("bootstrap_root: invalid nranks");
-                break;
+        conn->received = 0;
+        if (conn->stage == ROOT_STAGE_HANDSHAKE) {
+            if (conn->buf.handshake.magic != reg->magic) {
+                // 与socket_accept一致，magic不匹配的连接直接丢弃
+                SHM_LOG_DEBUG("bootstrap_root: wrong magic " << conn->buf.handshake.magic << " != " << reg->magic);
+                *done = true;
+                return ACLSHMEM_SUCCESS;
             }
-            ACLSHMEM_BOOTSTRAP_CALLOC(&rank_addrs, nranks);
-            ACLSHMEM_BOOTSTRAP_CALLOC(&rank_addrs_root, nranks);
-            if (rank_addrs == NULL || rank_addrs_root == NULL) {
-                SHM_LOG_ERROR("bootstrap_root: calloc addr arrays failed");
-                break;
+            if (conn->buf.handshake.type != SOCKET_TYPE_BOOTSTRAP) {
+                SHM_LOG_ERROR("bootstrap_root: wrong type " << conn->buf.handshake.type);
+                return ACLSHMEM_BOOTSTRAP_ERROR;
+            }
+            conn->stage = ROOT_STAGE_VERSION;
+        } else if (conn->stage == ROOT_STAGE_VERSION) {
+            int peer_version = conn->buf.version;
+            // 新连接的发送缓冲区为空，4字节直接写入
+            if (send(fd, &reg->root_version, sizeof(int), MSG_NOSIGNAL) != sizeof(int)) {
+                SHM_LOG_ERROR("bootstrap_root: send root_version failed");
+                return ACLSHMEM_BOOTSTRAP_ERROR;
             }
+            if (peer_version != reg->root_version) {
+                SHM_LOG_ERROR("bootstrap_root: version mismatch");
+                return ACLSHMEM_BOOTSTRAP_ERROR;
+            }
+            conn->stage = ROOT_STAGE_INFO;
+        } else {
+            *done = true;
+            return bootstrap_root_register(reg, conn->buf.info);
         }
+    }
+}
 
-        if (info.nranks != nranks || info.rank < 0 || info.rank >= nranks) {
-            SHM_LOG_ERROR("bootstrap_root: invalid info from rank " << info.rank);
-            break;
-        }
-        // Check if the rank is duplicated
-        if (memcmp(zero_addr, &rank_addrs_root[info.rank], sizeof(sockaddr_t)) != 0) {
-            SHM_LOG_ERROR("bootstrap_root: duplicate rank " << info.rank);
-            break;
-        }
+// accept4会把已排队连接上的网络错误报告出来，该连接被丢弃但监听socket仍可用，按accept(2)的建议视同EAGAIN重试
+static bool bootstrap_accept_retryable(int err) {
+    switch (err) {
+        case EINTR:
+        case ECONNABORTED:
+        case EPROTO:
+        case ENETDOWN:
+        case ENOPROTOOPT:
+        case EHOSTDOWN:
+        case ENONET:
+        case EHOSTUNREACH:
+        case EOPNOTSUPP:
+        case ENETUNREACH:
+            return true;
+        default:
+            return false;
+    }
+}
 
-        std::copy_n(reinterpret_cast<const char*>(&info.ext_address_listen_root), 
-                    sizeof(sockaddr_t), 
-                    reinterpret_cast<char*>(&rank_addrs_root[info.rank]));
-        std::copy_n(reinterpret_cast<const char*>(&info.ext_addr_listen), 
-                    sizeof(sockaddr_t), 
-                    reinterpret_cast<char*>(&rank_addrs[info.rank]));
-        c++;
+// epoll同时推进所有rank的登记握手，单个慢rank不会阻塞其余rank
+static int bootstrap_root_collect(bootstrap_root_registry* reg, socket_t* listen_sock) {
+    int epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd < 0) {
+        SHM_LOG_ERROR("bootstrap_root: epoll_create1 failed: " << strerror(errno));
+        return ACLSHMEM_BOOTSTRAP_ERROR;
+    }
+    int flags = fcntl(listen_sock->fd, F_GETFL, 0);
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = listen_sock->fd;
+    if (flags < 0 || fcntl(listen_sock->fd, F_SETFL, flags | O_NONBLOCK) != 0 ||
+        epoll_ctl(epfd, EPOLL_CTL_ADD, listen_sock->fd, &ev) != 0) {
+        SHM_LOG_ERROR("bootstrap_root: register listen fd failed: " << strerror(errno));
+        close(epfd);
+        return ACLSHMEM_BOOTSTRAP_ERROR;
+    }
 
-        if (c >= nranks) {
-            SHM_LOG_INFO("bootstrap_root: Address receiving completed");
+    std::unordered_map<int, bootstrap_root_conn> conns;
+    auto drop = [&conns, epfd](int fd) {
+        epoll_ctl(epfd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        conns.erase(fd);
+    };
+    const int one = 1;
+    struct epoll_event events[BOOTSTRAP_ROOT_EPOLL_EVENTS];
+    int ret = ACLSHMEM_SUCCESS;
+    while (ret == ACLSHMEM_SUCCESS && (reg->registered == 0 || reg->registered < reg->nranks)) {
+        int nev = epoll_wait(epfd, events, BOOTSTRAP_ROOT_EPOLL_EVENTS, SOCKET_ACCEPT_TIMEOUT_MS);
+        if (nev < 0 && errno == EINTR) {
+            continue;
+        }
+        if (nev <= 0) {
+            SHM_LOG_ERROR("bootstrap_root: registration " << (nev == 0 ? "timeout" : strerror(errno)) << ", "
+                          << reg->registered << "/" << reg->nranks << " ranks registered");
+            ret = nev == 0 ? ACLSHMEM_TIMEOUT_ERROR : ACLSHMEM_BOOTSTRAP_ERROR;
             break;
         }
+        for (int i = 0; i < nev && ret == ACLSHMEM_SUCCESS; i++) {
+            int fd = events[i].data.fd;
+            if (fd == listen_sock->fd) {
+                while (true) {
+                    int client = accept4(listen_sock->fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if (client < 0) {
+                        if (bootstrap_accept_retryable(errno)) {
+                            SHM_LOG_DEBUG("bootstrap_root: accept retry after: " << strerror(errno));
+                            continue;
+                        }
+                        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                            SHM_LOG_ERROR("bootstrap_root: accept failed: " << strerror(errno));
+                            ret = ACLSHMEM_BOOTSTRAP_ERROR;
+                        }
+                        break;
+                    }
+                    struct epoll_event cev = {};
+                    cev.events = EPOLLIN;
+                    cev.data.fd = client;
+                    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                    if (epoll_ctl(epfd, EPOLL_CTL_ADD, client, &cev) != 0) {
+                        SHM_LOG_ERROR("bootstrap_root: epoll_ctl add failed: " << strerror(errno));
+                        close(client);
+                        ret = ACLSHMEM_BOOTSTRAP_ERROR;
+                        break;
+                    }
+                    conns[client];
+                }
+                continue;
+            }
+            auto it = conns.find(fd);
+            if (it == conns.end()) {
+                continue;
+            }
+            bool done = false;
+            ret = bootstrap_root_progress(reg, fd, &it->second, &done);
+            if (done || ret != ACLSHMEM_SUCCESS) {
+                drop(fd);
+            }
+        }
+    }
+    for (auto& conn : conns) {
+        close(conn.first);
     }
+    close(epfd);
+    return ret;
+}
 
-    if (c == nranks && rank_addrs != NULL && rank_addrs_root != NULL) {
-        SHM_LOG_INFO("bootstrap_root: Start distributing addresses.");
-        for (int r = 0; r < nranks; r++) {
-            int next_rank = (r + 1) % nranks;
-            socket_t send_sock;
+// 把entries[0, count)即rank [first, first+count)的路由按BOOTSTRAP_ROOT_FANOUT切块，发给每块的首个rank，由其继续转发
+static int bootstrap_route_forward(const bootstrap_route_entry* entries, int first, int count, uint64_t magic) {
+    int children = std::min(count, BOOTSTRAP_ROOT_FANOUT);
+    int offset = 0;
+    for (int c = 0; c < children; c++) {
+        int len = count / children + (c < count % children ? 1 : 0);
+        int header[2] = {first + offset, len};
+        socket_t send_sock;
+        ACLSHMEM_CHECK_RET(socket_init(&send_sock, SOCKET_TYPE_BOOTSTRAP, magic, &entries[offset].listen_root),
+                           "bootstrap route: init sock for rank " << header[0] << " failed");
+        ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_connect(&send_sock),
+                                      "bootstrap route: connect to rank " << header[0] << " failed", send_sock);
+        ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_send(&send_sock, header, sizeof(header)),
+                                      "bootstrap route: send header to rank " << header[0] << " failed", send_sock);
+        ACLSHMEM_CHECK_RET_CLOSE_SOCK(
+            socket_send(&send_sock, const_cast<bootstrap_route_entry*>(entries + offset),
+                        len * static_cast<int>(sizeof(bootstrap_route_entry))),
+            "bootstrap route: send entries to rank " << header[0] << " failed", send_sock);
+        socket_close(&send_sock);
+        offset += len;
+    }
+    return ACLSHMEM_SUCCESS;
+}
 
-            if (socket_init(&send_sock, SOCKET_TYPE_BOOTSTRAP, magic, &rank_addrs_root[r]) != 0) {
-                SHM_LOG_ERROR("bootstrap_root: init send_sock for rank " << r << " failed");
-                break;
-            }
+static void* bootstrap_root(void* rargs) {
+    struct bootstrap_root_args* args = (struct bootstrap_root_args*)rargs;
+    if (args == NULL || args->listen_sock == NULL) {
+        SHM_LOG_ERROR("bootstrap_root: invalid args");
+        return NULL;
+    }
 
-            if (socket_connect(&send_sock) != 0) {
-                SHM_LOG_ERROR("bootstrap_root: connect to rank " << r << " failed");
-                socket_close(&send_sock);
-                break;
-            }
+    socket_t* listen_sock = args->listen_sock;
+    bootstrap_root_registry reg;
+    reg.magic = args->magic;
+    reg.root_version = args->version;
+    ACLSHMEM_BOOTSTRAP_PTR_FREE(args);
 
-            if (socket_send(&send_sock, &rank_addrs[next_rank], sizeof(sockaddr_t)) != 0) {
-                SHM_LOG_ERROR("bootstrap_root: send next_addr to rank " << r << " failed");
-                socket_close(&send_sock);
-                break;
-            }
+    // Adjusting file descriptor limits (the root node needs to handle multiple connections)
+    int ret = set_files_limit();
+    if (ret != 0) {
+        SHM_LOG_ERROR("bootstrap_root: set_files_limit failed");
+    }
 
-            socket_close(&send_sock);
-        }
+    auto start = std::chrono::steady_clock::now();
+    if (ret == 0) {
+        ret = bootstrap_root_collect(&reg, listen_sock);
     }
+    auto collected = std::chrono::steady_clock::now();
+    socket_close(listen_sock);
+    ACLSHMEM_BOOTSTRAP_PTR_FREE(listen_sock);
 
-    ACLSHMEM_BOOTSTRAP_PTR_FREE(zero_addr);
-    ACLSHMEM_BOOTSTRAP_PTR_FREE(rank_addrs);
-    ACLSHMEM_BOOTSTRAP_PTR_FREE(rank_addrs_root);
-    if (listen_sock != NULL) {
-        socket_close(listen_sock);
-        ACLSHMEM_BOOTSTRAP_PTR_FREE(listen_sock);
+    if (ret == 0) {
+        SHM_LOG_INFO("bootstrap_root: Address receiving completed, start distributing addresses.");
+        std::vector<bootstrap_route_entry> entries(reg.nranks);
+        for (int r = 0; r < reg.nranks; r++) {
+            entries[r].listen_root = reg.rank_addrs_root[r];
+            entries[r].next_addr = reg.rank_addrs[(r + 1) % reg.nranks];
+        }
+        ret = bootstrap_route_forward(entries.data(), 0, reg.nranks, reg.magic);
     }
-    ACLSHMEM_BOOTSTRAP_PTR_FREE(args);
+    auto distributed = std::chrono::steady_clock::now();
+    using ms = std::chrono::duration<double, std::milli>;
+    SHM_LOG_INFO("bootstrap_root: nranks " << reg.nranks << ", ret " << ret << ", registration "
+                 << ms(collected - start).count() << " ms, distribution " << ms(distributed - collected).count()
+                 << " ms");
     return NULL;
 }
 
@@ -1420,11 +1948,22 @@ int aclshmemi_bootstrap_plugin_init(void* comm, aclshmemi_bootstrap_handle_t* ha
     ACLSHMEM_CHECK_RET(socket_close(&sock), "Sock failed while executing close. fd=" << sock.fd);
 
 
+    // 路由消息来自root或上一级转发rank，第一条是自己的，其余转发给子树
+    int route_header[2] = {0, 0};
     ACLSHMEM_CHECK_RET(socket_init(&sock, SOCKET_TYPE_BOOTSTRAP, SOCKET_MAGIC, nullptr), "Sock failed while executing init. fd=" << sock.fd);
     ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_accept(&sock, &listen_sock_root), "Sock failed while executing accept listen_sock_root. fd=" << sock.fd, sock);
-    ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_recv(&sock, &next_addr, sizeof(next_addr)), "Sock failed while executing recv next_addr. fd=" << sock.fd, sock);
+    ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_recv(&sock, route_header, sizeof(route_header)), "Sock failed while executing recv route header. fd=" << sock.fd, sock);
+    if (route_header[0] != rank || route_header[1] <= 0 || route_header[1] > nranks - rank) {
+        SHM_LOG_ERROR(" rank: " << rank << ": invalid route header, first " << route_header[0] << ", count " << route_header[1]);
+        socket_close(&sock);
+        return ACLSHMEM_BOOTSTRAP_ERROR;
+    }
+    std::vector<bootstrap_route_entry> routes(route_header[1]);
+    ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_recv(&sock, routes.data(), route_header[1] * static_cast<int>(sizeof(bootstrap_route_entry))), "Sock failed while executing recv routes. fd=" << sock.fd, sock);
     ACLSHMEM_CHECK_RET(socket_close(&sock), "Sock failed while executing close. fd=" << sock.fd);
     ACLSHMEM_CHECK_RET(socket_close(&listen_sock_root), "Listen_sock_root failed while executing close. fd=" << listen_sock_root.fd);
+    next_addr = routes[0].next_addr;
+    ACLSHMEM_CHECK_RET(bootstrap_route_forward(routes.data() + 1, rank + 1, route_header[1] - 1, magic), " rank: " << rank << ": forward routes failed");
 
     
     if (next_addr.type == ADDR_IPv4) {
@@ -1449,12 +1988,35 @@ int aclshmemi_bootstrap_plugin_init(void* comm, aclshmemi_bootstrap_handle_t* ha
     ACLSHMEM_CHECK_RET_CLOSE_SOCK(socket_accept(&state->ring_recv_sock, &state->listen_sock),"State's ring_recv_sock failed while executing accept State's listen_sock. fd=" << state->ring_recv_sock.fd, state->ring_recv_sock);
     ACLSHMEM_CHECK_RET(bootstrap_get_sock_addr(&state->listen_sock, state->peer_addrs + handle->mype), "Get addr failed, the listen_sock in state maybe null. fd=" << state->listen_sock.fd);
 
-    ACLSHMEM_CHECK_RET(aclshmemi_bootstrap_uid_allgather(BOOTSTRAP_IN_PLACE, state->peer_addrs, sizeof(sockaddr_t), handle), "Bootstrap_uid_allgather failed");
+    // peer_addrs is what the tree algorithms connect with, so it is always gathered over the ring
+    ACLSHMEM_CHECK_RET(aclshmemi_bootstrap_uid_allgather_ring(BOOTSTRAP_IN_PLACE, state->peer_addrs, sizeof(sockaddr_t), handle), "Bootstrap_uid_allgather failed");
+    state->allgather_algo = bootstrap_allgather_algo_from_env();
+    ACLSHMEM_CHECK_RET(ACLSHMEM_BOOTSTRAP_CALLOC(&state->send_conns, nranks));
+    ACLSHMEM_CHECK_RET(ACLSHMEM_BOOTSTRAP_CALLOC(&state->recv_conns, nranks));
+    ACLSHMEM_CHECK_RET(ACLSHMEM_BOOTSTRAP_CALLOC(&state->send_broken, nranks));
+    for (int peer = 0; peer < nranks; peer++) {
+        state->send_conns[peer].fd = -1;
+        state->recv_conns[peer].fd = -1;
+    }
+    state->unexpected_msgs = new (std::nothrow) unexpected_msg_table();
+    ACLSHMEM_CHECK_RET(state->unexpected_msgs == nullptr, " rank: " << rank << ": failed to allocate unexpected_msgs", ACLSHMEM_BOOTSTRAP_ERROR);
+
+    state->barrier_algo = bootstrap_barrier_algo_from_env();
+    if (state->barrier_algo == BOOTSTRAP_BARRIER_DISSEMINATION) {
+        ACLSHMEM_CHECK_RET(bootstrap_barrier_connect(state), "pe " << rank << ": barrier connections setup failed");
+    }
 
     handle->allgather = aclshmemi_bootstrap_uid_allgather;
-    handle->barrier = aclshmemi_bootstrap_uid_barrier_v2;
+    if (state->barrier_algo == BOOTSTRAP_BARRIER_RING) {
+        handle->barrier = aclshmemi_bootstrap_uid_barrier_ring;
+    } else if (state->barrier_algo == BOOTSTRAP_BARRIER_V2) {
+        handle->barrier = aclshmemi_bootstrap_uid_barrier_v2;
+    } else {
+        handle->barrier = aclshmemi_bootstrap_uid_barrier_dissemination;
+    }
     handle->finalize = aclshmemi_bootstrap_uid_finalize;
-    handle->alltoall = nullptr;
+    handle->alltoall = aclshmemi_bootstrap_uid_alltoall;
+    handle->alltoallv = aclshmemi_bootstrap_uid_alltoallv;
     handle->global_exit = nullptr;
 
     SHM_LOG_INFO("pe " << rank << ": bootstrap plugin initialized successfully");
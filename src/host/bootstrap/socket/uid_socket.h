@@ -83,6 +83,12 @@ typedef struct {
     sockaddr_t ext_address_listen_root;
 } bootstrap_ext_info;
 
+// root下发的路由条目，消息格式为int[2]{首个rank, 条目数}加按rank连续排列的条目
+typedef struct {
+    sockaddr_t listen_root;  // 该rank接收路由消息的监听地址
+    sockaddr_t next_addr;    // 该rank在环上下一个rank的监听地址
+} bootstrap_route_entry;
+
 struct bootstrap_netstate {
     char bootstrap_netifname[MAX_IF_NAME_SIZE + 1];     /* Socket Interface Name */
     sockaddr_t bootstrap_netifaddr; /* Socket Interface Address */
@@ -98,6 +104,8 @@ typedef struct unexpected_conn {
     struct unexpected_conn* next;  // 链表下一个节点
 } unexpected_conn_t;
 
+struct unexpected_msg_table;       // 按(peer, tag)哈希索引的意外消息队列，定义见shmemi_bootstrap_uid.cpp
+
 typedef struct {
     int rank;
     int nranks;
@@ -107,6 +115,16 @@ typedef struct {
     socket_t ring_recv_sock;
     sockaddr_t* peer_addrs;
     unexpected_conn_t* unexpected_conns;  // 意外连接队列
+    int allgather_algo;                   // SHMEM_BOOTSTRAP_ALLGATHER_ALGO指定的allgather算法
+    uint32_t coll_seq;                    // 集合通信序号，用于区分前后两次调用的tag
+    int barrier_algo;                     // SHMEM_BOOTSTRAP_BARRIER_ALGO指定的barrier算法
+    int barrier_steps;                    // dissemination barrier的步数ceil(log2(nranks))
+    socket_t* barrier_send_socks;         // 第k步发往rank+2^k的常驻连接
+    socket_t* barrier_recv_socks;         // 第k步来自rank-2^k的常驻连接
+    socket_t* send_conns;                 // bootstrap_send到各peer的缓存连接，首次发送时建立
+    socket_t* recv_conns;                 // bootstrap_recv来自各peer的缓存连接，首次accept时登记
+    uint8_t* send_broken;                 // 到该peer的缓存连接发送失败过，对端流中可能残留半帧，不再重连
+    struct unexpected_msg_table* unexpected_msgs;
 } uid_bootstrap_state;
 
 int socket_init(socket_t* sock, socket_type_t type, uint64_t magic, const sockaddr_t* init_addr);
@@ -9,6 +9,9 @@
  */
 #include <random>
 #include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
 #include <arpa/inet.h>
 #include <ifaddrs.h>
 #include <net/if.h>
@@ -22,6 +25,25 @@
 #include "store_net_common.h"
 #include "mem_entity_def.h"
 
+// SHMEM_HEAP_COMMIT_GRANULE_MB 未设置或为0时在初始化阶段一次性提交整个堆，与原有行为一致
+static uint64_t aclshmemi_heap_commit_granule()
+{
+    constexpr unsigned long long max_granule_mb = 1024ULL * 1024ULL;
+    const char *env_granule = std::getenv("SHMEM_HEAP_COMMIT_GRANULE_MB");
+    if (env_granule == nullptr) {
+        return 0;
+    }
+
+    char *end = nullptr;
+    errno = 0;
+    auto granule_mb = std::strtoull(env_granule, &end, 10);
+    if (errno != 0 || end == env_granule || *end != '\0' || granule_mb > max_granule_mb) {
+        SHM_LOG_WARN("Invalid SHMEM_HEAP_COMMIT_GRANULE_MB: " << env_granule << ", commit the whole heap at init.");
+        return 0;
+    }
+    return ALIGN_UP(static_cast<uint64_t>(granule_mb) * 1024UL * 1024UL, ACLSHMEM_PAGE_SIZE);
+}
+
 aclshmemi_init_backend::aclshmemi_init_backend()
 {
     auto status = aclrtGetDevice(&device_id);
@@ -417,9 +439,13 @@ int aclshmemi_init_backend::exchange_slice(aclshmem_mem_type_t mem_type)
         return ACLSHMEM_INNER_ERROR;
     }
 
+    // collective, a PE failing locally still takes every step so the peers don't wait for it
     auto ret = hybm_export(entity, slice, 0, &ex_info);
     if (ret != 0) {
         SHM_LOG_ERROR("hybm export slice failed, result: " << ret);
+    }
+    ret = all_succeeded(ret);
+    if (ret != 0) {
         return ret;
     }
 
@@ -431,10 +457,9 @@ int aclshmemi_init_backend::exchange_slice(aclshmem_mem_type_t mem_type)
     }
 
     // import memory
-    ret = hybm_import(entity, all_ex_info, host_state->npes, nullptr, 0);
-    if (ret != 0) {
-        SHM_LOG_ERROR("hybm import failed, result: " << ret);
-        return ret;
+    auto import_ret = hybm_import(entity, all_ex_info, host_state->npes, nullptr, 0);
+    if (import_ret != 0) {
+        SHM_LOG_ERROR("hybm import failed, result: " << import_ret);
     }
 
     ret = aclshmemi_control_barrier_all();
@@ -442,7 +467,7 @@ int aclshmemi_init_backend::exchange_slice(aclshmem_mem_type_t mem_type)
         SHM_LOG_ERROR("hybm barrier for slice failed, result: " << ret);
         return ret;
     }
-    return ACLSHMEM_SUCCESS;
+    return import_ret;
 }
 
 int aclshmemi_init_backend::exchange_entity(aclshmem_mem_type_t mem_type)
@@ -472,9 +497,13 @@ int aclshmemi_init_backend::exchange_entity(aclshmem_mem_type_t mem_type)
 
     hybm_exchange_info ex_info;
     bzero(&ex_info, sizeof(ex_info));
+    // collective, a PE failing locally still takes every step so the peers don't wait for it
     auto ret = hybm_export(entity, nullptr, 0, &ex_info);
     if (ret != 0) {
         SHM_LOG_ERROR("hybm export entity failed, result: " << ret);
+    }
+    ret = all_succeeded(ret);
+    if (ret != 0) {
         return ret;
     }
 
@@ -489,10 +518,9 @@ int aclshmemi_init_backend::exchange_entity(aclshmem_mem_type_t mem_type)
         return ret;
     }
     // import entity
-    ret = hybm_import(entity, all_ex_info, host_state->npes, nullptr, 0);
-    if (ret != 0) {
-        SHM_LOG_ERROR("hybm import entity failed, result: " << ret);
-        return ret;
+    auto import_ret = hybm_import(entity, all_ex_info, host_state->npes, nullptr, 0);
+    if (import_ret != 0) {
+        SHM_LOG_ERROR("hybm import entity failed, result: " << import_ret);
     }
 
     ret = aclshmemi_control_barrier_all();
@@ -500,7 +528,7 @@ int aclshmemi_init_backend::exchange_entity(aclshmem_mem_type_t mem_type)
         SHM_LOG_ERROR("hybm barrier for slice failed, result: " << ret);
         return ret;
     }
-    return ACLSHMEM_SUCCESS;
+    return import_ret;
 }
 
 int aclshmemi_init_backend::setup_heap(aclshmem_mem_type_t mem_type)
@@ -529,10 +557,21 @@ int aclshmemi_init_backend::setup_heap(aclshmem_mem_type_t mem_type)
         return ACLSHMEM_INNER_ERROR;
     }
 
+    // device heap may only commit its first granule, the remaining VA is backed on demand by commit_heap.
+    // a heap smaller than the granule is committed up to its page-aligned end, still inside the PE's VA range
+    uint64_t commit_size = host_state->heap_size;
+    if (mem_type == DEVICE_SIDE) {
+        elem->hbm_commit_granule = aclshmemi_heap_commit_granule();
+        if (elem->hbm_commit_granule != 0) {
+            commit_size = std::min(elem->hbm_commit_granule,
+                                   ALIGN_UP(static_cast<uint64_t>(host_state->heap_size), ACLSHMEM_PAGE_SIZE));
+        }
+    }
+
     // alloc memory
-    auto slice = hybm_alloc_local_memory(entity, mType, host_state->heap_size, 0);
+    auto slice = hybm_alloc_local_memory(entity, mType, commit_size, 0);
     if (slice == nullptr) {
-        SHM_LOG_ERROR("alloc local mem failed, size: " << host_state->heap_size);
+        SHM_LOG_ERROR("alloc local mem failed, size: " << commit_size);
         return ACLSHMEM_SMEM_ERROR;
     }
     if (mem_type == HOST_SIDE) {
@@ -574,6 +613,8 @@ int aclshmemi_init_backend::setup_heap(aclshmem_mem_type_t mem_type)
         return ACLSHMEM_SUCCESS;
     }
     // device side heap info save
+    elem->hbm_committed = commit_size;
+    SHM_LOG_INFO("device heap committed " << commit_size << " of " << host_state->heap_size << " bytes at init.");
     auto aligned = ALIGN_UP(host_state->heap_size, ACLSHMEM_HEAP_ALIGNMENT_SIZE);
     host_state->heap_base = (void *)((uintptr_t)elem->hbm_gva + aligned * static_cast<uint32_t>(attributes->my_pe));
     ACLSHMEM_CHECK_RET(aclrtMallocHost((void **)&host_state->p2p_device_heap_base, host_state->npes * sizeof(void *)));
@@ -594,6 +635,135 @@ int aclshmemi_init_backend::setup_heap(aclshmem_mem_type_t mem_type)
     return ACLSHMEM_SUCCESS;
 }
 
+int aclshmemi_init_backend::grow_heap(entity_member *elem, uint64_t size)
+{
+    // every step is agreed on by all PEs, so they either all grow or all fail
+    auto slice = hybm_alloc_local_memory(elem->hbm_entity, HYBM_MEM_TYPE_DEVICE, size, 0);
+    if (slice == nullptr) {
+        SHM_LOG_ERROR("alloc local mem for heap growth failed, size: " << size);
+    }
+    auto ret = all_succeeded(slice == nullptr ? ACLSHMEM_SMEM_ERROR : ACLSHMEM_SUCCESS);
+    if (ret != 0) {
+        if (slice != nullptr) {
+            (void)hybm_free_local_memory(elem->hbm_entity, slice, 1, 0);
+        }
+        return ret;
+    }
+
+    // only the new slice is exported and imported, slices committed before stay mapped on every peer
+    elem->hbm_slice = slice;
+    ret = all_succeeded(exchange_slice(DEVICE_SIDE));
+    if (ret != 0) {
+        SHM_LOG_ERROR("exchange grown slice failed, result: " << ret);
+        return ret;
+    }
+    // the entity exchange hands the transports the memory keys of the new slice, like at init
+    ret = all_succeeded(exchange_entity(DEVICE_SIDE));
+    if (ret != 0) {
+        SHM_LOG_ERROR("exchange entity for grown slice failed, result: " << ret);
+        return ret;
+    }
+    ret = hybm_mmap(elem->hbm_entity, 0);
+    if (ret != 0) {
+        SHM_LOG_ERROR("hybm mmap grown slice failed, result: " << ret);
+    }
+    return all_succeeded(ret);
+}
+
+int aclshmemi_init_backend::all_succeeded(int local_ret)
+{
+    bool all = false;
+    auto ret = is_all_agreed(local_ret == 0, all);
+    if (ret != 0) {
+        return ret;
+    }
+    if (all) {
+        return ACLSHMEM_SUCCESS;
+    }
+    return local_ret != 0 ? local_ret : ACLSHMEM_SMEM_ERROR;
+}
+
+int aclshmemi_init_backend::commit_heap(const void *ptr, uint64_t size)
+{
+    // fetch entity_member
+    entity_member *elem = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(entity_map_mutex_);
+        auto it = entity_map_.find(g_instance_ctx->id);
+        if (it == entity_map_.end() || it->second == nullptr) {
+            SHM_LOG_ERROR("Inner backend find instance context failed !");
+            return ACLSHMEM_INNER_ERROR;
+        }
+        elem = it->second;
+    }
+
+    auto host_state = elem->entity_host_state;
+    auto boot_handle = elem->entity_boot_handle;
+    if (elem->hbm_entity == nullptr || host_state == nullptr || host_state->heap_base == nullptr ||
+        boot_handle == nullptr) {
+        SHM_LOG_ERROR("One of entity_member's required fields is null: "
+                      "entity, host_state, heap_base, boot_handle. Please Check!");
+        return ACLSHMEM_INNER_ERROR;
+    }
+    std::lock_guard<std::mutex> lock(heap_commit_mutex_);
+    // committed at init as a whole, or already grown to the whole heap, same on every PE
+    if (elem->hbm_commit_granule == 0 || elem->hbm_committed >= host_state->heap_size) {
+        return ACLSHMEM_SUCCESS;
+    }
+
+    // collective from here on, a PE whose allocation failed joins with nullptr and the commit fails on all PEs
+    uint64_t vote[2] = {0, 1}; // end of the block, allocation ok
+    auto offset = reinterpret_cast<uintptr_t>(ptr) - reinterpret_cast<uintptr_t>(host_state->heap_base);
+    if (ptr == nullptr) {
+        vote[1] = (size == 0) ? 1 : 0;
+    } else if (reinterpret_cast<uintptr_t>(ptr) < reinterpret_cast<uintptr_t>(host_state->heap_base) ||
+        offset > host_state->heap_size || size > host_state->heap_size - offset) {
+        SHM_LOG_ERROR("commit range out of heap, ptr: " << ptr << ", size: " << size);
+        vote[1] = 0;
+    } else {
+        vote[0] = offset + size;
+    }
+    std::vector<uint64_t> all_votes(2 * host_state->npes, 0);
+    auto ret = boot_handle->allgather(vote, all_votes.data(), static_cast<int>(sizeof(vote)), boot_handle);
+    if (ret != ACLSHMEM_SUCCESS) {
+        SHM_LOG_ERROR("bootstrap allgather for heap commit failed, ret: " << ret);
+        return ret;
+    }
+    uint64_t end = 0;
+    for (int32_t i = 0; i < host_state->npes; i++) {
+        if (all_votes[2 * i + 1] == 0) {
+            SHM_LOG_ERROR("PE " << i << " failed to allocate, heap commit fails on every PE.");
+            return ACLSHMEM_SMEM_ERROR;
+        }
+        end = std::max(end, all_votes[2 * i]);
+    }
+    if (end <= elem->hbm_committed) {
+        return ACLSHMEM_SUCCESS;
+    }
+    if (elem->hbm_grow_failed) {
+        SHM_LOG_ERROR("device heap can't grow after an earlier failure, committed: " << elem->hbm_committed);
+        return ACLSHMEM_SMEM_ERROR;
+    }
+
+    // the farthest block end of all PEs decides, so every PE grows by the same size
+    auto grow_size = ALIGN_UP(end - elem->hbm_committed, elem->hbm_commit_granule);
+    // the last step ends at the heap end rounded up to a page, so every mapped slice stays a whole number of pages
+    auto heap_end = ALIGN_UP(static_cast<uint64_t>(host_state->heap_size), ACLSHMEM_PAGE_SIZE);
+    grow_size = std::min(grow_size, heap_end - elem->hbm_committed);
+    auto start = std::chrono::steady_clock::now();
+    ret = grow_heap(elem, grow_size);
+    if (ret != ACLSHMEM_SUCCESS) {
+        elem->hbm_grow_failed = true;
+        SHM_LOG_ERROR("grow device heap by " << grow_size << " failed, committed: " << elem->hbm_committed);
+        return ret;
+    }
+    elem->hbm_committed += grow_size;
+    auto cost = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    SHM_LOG_INFO("device heap committed " << elem->hbm_committed << " of " << host_state->heap_size
+                 << " bytes, grow " << grow_size << " cost " << cost.count() << "us.");
+    return ACLSHMEM_SUCCESS;
+}
+
 int aclshmemi_init_backend::remove_heap(aclshmem_mem_type_t mem_type)
 {
     // fetch entity_member
@@ -697,6 +867,7 @@ int aclshmemi_init_backend::release_heap(aclshmem_mem_type_t mem_type)
     }
     else {
         elem->hbm_slice = nullptr;
+        elem->hbm_committed = 0;
         elem->hbm_gva = nullptr;
         elem->hbm_entity = nullptr;
     }
@@ -758,4 +929,85 @@ int aclshmemi_init_backend::is_alloc_size_symmetric(size_t size)
         return ACLSHMEM_INVALID_PARAM;
     }
     return ACLSHMEM_SUCCESS;
-}
\ No newline at end of file
+}
+
+int aclshmemi_init_backend::is_all_agreed(bool local, bool &all)
+{
+    // fetch entity_member
+    entity_member *elem = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(entity_map_mutex_);
+        auto iter = entity_map_.find(g_instance_ctx->id);
+        if (iter == entity_map_.end() || iter->second == nullptr) {
+            SHM_LOG_ERROR("Inner backend find instance context failed !");
+            return ACLSHMEM_INNER_ERROR;
+        }
+        elem = iter->second;
+    }
+
+    auto host_state = elem->entity_host_state;
+    auto boot_handle = elem->entity_boot_handle;
+    if (host_state == nullptr || boot_handle == nullptr) {
+        SHM_LOG_ERROR("One of entity_member's required fields is null: "
+                      "host_state, boot_handle. Please Check!");
+        return ACLSHMEM_INNER_ERROR;
+    }
+
+    int32_t vote = local ? 1 : 0;
+    std::vector<int32_t> all_vote(host_state->npes, 0);
+    auto ret = boot_handle->allgather(&vote, all_vote.data(), static_cast<int>(sizeof(int32_t)), boot_handle);
+    if (ret != ACLSHMEM_SUCCESS) {
+        SHM_LOG_ERROR("bootstrap allgather failed, ret: " << ret);
+        return ret;
+    }
+    all = std::all_of(all_vote.begin(), all_vote.end(), [](int32_t v) { return v != 0; });
+    return ACLSHMEM_SUCCESS;
+}
+
+int aclshmemi_init_backend::is_alloc_sizes_symmetric(const size_t *sizes, size_t count)
+{
+    // fetch entity_member
+    entity_member *elem = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(entity_map_mutex_);
+        auto iter = entity_map_.find(g_instance_ctx->id);
+        if (iter == entity_map_.end() || iter->second == nullptr) {
+            SHM_LOG_ERROR("Inner backend find instance context failed !");
+            return ACLSHMEM_INNER_ERROR;
+        }
+        elem = iter->second;
+    }
+
+    auto host_state = elem->entity_host_state;
+    auto boot_handle = elem->entity_boot_handle;
+    if (host_state == nullptr || boot_handle == nullptr) {
+        SHM_LOG_ERROR("One of entity_member's required fields is null: "
+                      "host_state, boot_handle. Please Check!");
+        return ACLSHMEM_INNER_ERROR;
+    }
+
+    // the whole size vector is folded into {count, fnv-1a hash}, so one fixed-size allgather checks the batch
+    constexpr uint64_t fnv_offset_basis = 14695981039346656037ULL;
+    constexpr uint64_t fnv_prime = 1099511628211ULL;
+    uint64_t digest[2] = {static_cast<uint64_t>(count), fnv_offset_basis};
+    for (size_t i = 0; i < count; ++i) {
+        digest[1] = (digest[1] ^ static_cast<uint64_t>(sizes[i])) * fnv_prime;
+    }
+
+    std::vector<uint64_t> all_digest(host_state->npes * 2, 0);
+    auto ret = boot_handle->allgather(digest, all_digest.data(), static_cast<int>(sizeof(digest)), boot_handle);
+    if (ret != ACLSHMEM_SUCCESS) {
+        SHM_LOG_ERROR("bootstrap allgather failed, ret: " << ret);
+        return ret;
+    }
+
+    for (int i = 1; i < host_state->npes; ++i) {
+        if (all_digest[i * 2] != all_digest[0] || all_digest[i * 2 + 1] != all_digest[1]) {
+            SHM_LOG_ERROR("Asymmetric batch alloc detected, ref(pe0) count = " << all_digest[0]
+                          << ", first detected bad(pe" << i << ") count = " << all_digest[i * 2]
+                          << ", cur(pe" << host_state->mype << ") count = " << count);
+            return ACLSHMEM_INVALID_PARAM;
+        }
+    }
+    return ACLSHMEM_SUCCESS;
+}
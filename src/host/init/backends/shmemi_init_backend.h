@@ -33,6 +33,12 @@ typedef struct entity_member {
     hybm_mem_slice_t hbm_slice = nullptr;
     hybm_mem_slice_t dram_slice = nullptr;
 
+    // device heap bytes backed by HBM, the rest of heap_size is only reserved VA
+    uint64_t hbm_committed = 0;
+    uint64_t hbm_commit_granule = 0;
+    // a failed growth may leave the slices of the PEs at different offsets, the heap never grows again
+    bool hbm_grow_failed = false;
+
     aclshmemx_init_attr_t *entity_attr;
     aclshmemi_bootstrap_handle_t *entity_boot_handle;
     aclshmem_device_host_state_t *entity_host_state;
@@ -53,9 +59,12 @@ public:
     int setup_heap(aclshmem_mem_type_t mem_type = DEVICE_SIDE);
     int remove_heap(aclshmem_mem_type_t mem_type = DEVICE_SIDE);
     int release_heap(aclshmem_mem_type_t mem_type = DEVICE_SIDE);
+    int commit_heap(const void *ptr, uint64_t size);
 
     int aclshmemi_control_barrier_all();
     int is_alloc_size_symmetric(size_t size);
+    int is_alloc_sizes_symmetric(const size_t *sizes, size_t count);
+    int is_all_agreed(bool local, bool &all);
 
     int bind_aclshmem_entity(aclshmemx_init_attr_t *attr, aclshmem_device_host_state_t *state, aclshmemi_bootstrap_handle_t *handle);
     int release_aclshmem_entity(uint64_t instance_id);
@@ -65,6 +74,8 @@ private:
     int create_entity(aclshmem_mem_type_t mem_type = DEVICE_SIDE);
     int exchange_slice(aclshmem_mem_type_t mem_type = DEVICE_SIDE);
     int exchange_entity(aclshmem_mem_type_t mem_type = DEVICE_SIDE);
+    int grow_heap(entity_member *elem, uint64_t size);
+    int all_succeeded(int local_ret);
 
 private:
     int device_id;
@@ -73,6 +84,7 @@ private:
     shm::mstx_mem_register_base* mstx_reg_ptr_ = nullptr;
 
     std::mutex entity_map_mutex_;
+    std::mutex heap_commit_mutex_;
     std::map<uint64_t, entity_member*> entity_map_ = {};
 };
 
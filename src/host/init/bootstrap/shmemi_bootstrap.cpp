@@ -263,6 +263,7 @@ int32_t aclshmemi_bootstrap_init(int flags, aclshmemx_init_attr_t *attr) {
     int32_t status = ACLSHMEM_SUCCESS;
     void *arg;
     g_boot_handle.use_attr_ipport = false;
+    g_boot_handle.store_relay = (attr != NULL) && (attr->store_topology == ACLSHMEMX_STORE_TOPOLOGY_NODE_RELAY);
     // Reset session_magic to default at entry so that a non-UID init
     // (or a DEFAULT init after a previous UID init/finalize cycle)
     // never picks up a stale value from a prior session.
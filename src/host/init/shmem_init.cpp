@@ -182,13 +182,33 @@ int32_t check_attr(aclshmemx_init_attr_t* attributes)
     SHM_VALIDATE_RETURN(attributes->option_attr.data_op_engine_type > 0, "sockFd is invalid", ACLSHMEM_INVALID_VALUE);
     SHM_ASSERT_RETURN(
         is_valid_data_op_engine_type(attributes->option_attr.data_op_engine_type), ACLSHMEM_INVALID_VALUE);
+    SHM_VALIDATE_RETURN(attributes->store_topology == ACLSHMEMX_STORE_TOPOLOGY_FLAT ||
+        attributes->store_topology == ACLSHMEMX_STORE_TOPOLOGY_NODE_RELAY, "store_topology is invalid",
+        ACLSHMEM_INVALID_VALUE);
     return ACLSHMEM_SUCCESS;
 }
 
-int32_t aclshmemi_control_barrier_all() { return init_manager->aclshmemi_control_barrier_all(); }
+int32_t aclshmemi_control_barrier_all()
+{
+    auto ret = init_manager->aclshmemi_control_barrier_all();
+    if (ret == 0) {
+        // every PE has passed this point, pointers queued by aclshmemx_free_deferred are no longer in use
+        aclshmemi_flush_deferred_free();
+    }
+    return ret;
+}
 
 int32_t is_alloc_size_symmetric(size_t size) { return init_manager->is_alloc_size_symmetric(size); }
 
+int32_t is_alloc_sizes_symmetric(const size_t *sizes, size_t count)
+{
+    return init_manager->is_alloc_sizes_symmetric(sizes, count);
+}
+
+int32_t aclshmemi_commit_heap(const void *ptr, size_t size) { return init_manager->commit_heap(ptr, size); }
+
+int32_t aclshmemi_all_agreed(bool local, bool &all) { return init_manager->is_all_agreed(local, all); }
+
 int32_t update_device_state()
 {
     return init_manager->update_device_state((void*)&g_state, sizeof(aclshmem_device_host_state_t));
@@ -30,6 +30,9 @@ extern aclshmem_instance_ctx *g_instance_ctx;
 
 int32_t aclshmemi_control_barrier_all();
 int32_t is_alloc_size_symmetric(size_t size);
+int32_t is_alloc_sizes_symmetric(const size_t *sizes, size_t count);
+int32_t aclshmemi_commit_heap(const void *ptr, size_t size);
+int32_t aclshmemi_all_agreed(bool local, bool &all);
 
 int32_t update_device_state(void);
 int32_t aclshmemx_instance_ctx_set_impl(uint64_t instance_id);
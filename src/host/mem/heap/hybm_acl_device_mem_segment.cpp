@@ -322,7 +322,8 @@ Result MemSegmentDevice::Mmap() noexcept
             continue;
         }
 
-        auto remoteAddress = reservedVirtualAddresses_[im.rankId];
+        // slices allocated after init are mapped behind the ones already imported
+        auto remoteAddress = reservedVirtualAddresses_[im.rankId] + im.mappingOffset;
         if (mappedMem_.find((uint64_t)remoteAddress) != mappedMem_.end()) {
             SHM_LOG_INFO("remote slice on rank(" << im.rankId << ") has maped: " << (void *)remoteAddress);
             continue;
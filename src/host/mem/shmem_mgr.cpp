@@ -7,6 +7,8 @@
  * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
  * See LICENSE in the root of the software repository for the full text of the License.
  */
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include "acl/acl.h"
 #include "shmemi_host_common.h"
@@ -21,53 +23,63 @@ bool range_size_first_comparator::operator()(const memory_range &mr1, const memo
     return mr1.offset < mr2.offset;
 }
 
-memory_manager::memory_manager(void *base, uint64_t size) noexcept : base_{reinterpret_cast<uint8_t *>(base)}, size_{size}
+memory_manager::memory_manager(void *base, uint64_t size, bool slab_enabled) noexcept
+    : base_{reinterpret_cast<uint8_t *>(base)},
+      size_{size},
+      slab_enabled_{slab_enabled},
+      slab_radix_(slab_enabled ? ((((size + SLAB_GRANULE_SIZE - 1UL) >> SLAB_GRANULE_SHIFT) +
+                                   SLAB_RADIX_LEAF_SIZE - 1UL) >> SLAB_RADIX_LEAF_BITS) : 0UL)
 {
     pthread_spin_init(&spinlock_, 0);
     address_idle_tree_[0] = size;
-    size_idle_tree_.insert({0, size});
+    size_idle_insert_in_lock(memory_range{0, size});
+
+    for (uint32_t i = 0; i < SLAB_CLASS_NUM; i++) {
+        auto slot_size = 1UL << (SLAB_MIN_SLOT_SHIFT + i);
+        slab_classes_[i].slot_size = slot_size;
+        slab_classes_[i].span_size = std::max(SLAB_GRANULE_SIZE, slot_size * SLAB_MIN_SLOTS_PER_SPAN);
+    }
+    for (auto &leaf : slab_radix_) {
+        leaf.store(nullptr, std::memory_order_relaxed);
+    }
 }
 
 memory_manager::~memory_manager() noexcept
 {
+    // spans are owned by slab_span_storage_, only the radix leaves need to be deleted here
+    for (auto &leaf : slab_radix_) {
+        delete leaf.load(std::memory_order_relaxed);
+    }
+    for (auto &shard : used_index_) {
+        pthread_rwlock_destroy(&shard.lock);
+    }
     pthread_spin_destroy(&spinlock_);
 }
 
 void *memory_manager::allocate(uint64_t size) noexcept
 {
-    if (size == 0 || size > g_state.heap_size) {
+    if (size == 0 || size > size_) {
         SHM_LOG_ERROR("cannot allocate with size " << size);
         return nullptr;
     }
 
     auto aligned_size = allocated_size_align_up(size);
-    memory_range anchor{0, aligned_size};
+    uint64_t target_offset = 0;
 
     pthread_spin_lock(&spinlock_);
-    auto size_pos = size_idle_tree_.lower_bound(anchor);
-    if (size_pos == size_idle_tree_.end()) {
+    auto class_index = slab_class_index(aligned_size, 1UL);
+    if (slab_enabled_ && class_index >= 0 && slab_allocate_in_lock(class_index, target_offset)) {
         pthread_spin_unlock(&spinlock_);
-        SHM_LOG_ERROR("cannot allocate with size: " << size);
-        return nullptr;
+        return base_ + target_offset;
     }
 
-    auto target_offset = size_pos->offset;
-    auto target_size = size_pos->size;
-    auto addr_pos = address_idle_tree_.find(target_offset);
-    if (addr_pos == address_idle_tree_.end()) {
+    if (!tree_allocate_in_lock(1UL, aligned_size, target_offset)) {
         pthread_spin_unlock(&spinlock_);
-        SHM_LOG_ERROR("offset(" << target_offset << ") size(" << target_size << ") in size tree, not in address tree.");
+        SHM_LOG_ERROR("cannot allocate with size: " << size);
         return nullptr;
     }
-
-    size_idle_tree_.erase(size_pos);
-    address_idle_tree_.erase(addr_pos);
-    address_used_tree_.emplace(target_offset, aligned_size);
-    if (target_size > aligned_size) {
-        memory_range left{target_offset + aligned_size, target_size - aligned_size};
-        address_idle_tree_.emplace(left.offset, left.size);
-        size_idle_tree_.emplace(left);
-    }
+    used_index_set(target_offset, aligned_size);
+    account_allocate_in_lock(aligned_size);
     pthread_spin_unlock(&spinlock_);
 
     return base_ + target_offset;
@@ -75,7 +87,7 @@ void *memory_manager::allocate(uint64_t size) noexcept
 
 void *memory_manager::aligned_allocate(uint64_t alignment, uint64_t size) noexcept
 {
-    if (size == 0 || alignment == 0 || size > g_state.heap_size) {
+    if (size == 0 || alignment == 0 || size > size_) {
         SHM_LOG_ERROR("invalid input, align=" << alignment << ", size=" << size);
         return nullptr;
     }
@@ -85,49 +97,33 @@ void *memory_manager::aligned_allocate(uint64_t alignment, uint64_t size) noexce
         return nullptr;
     }
 
-    uint64_t head_skip = 0;
     auto aligned_size = allocated_size_align_up(size);
-    memory_range anchor{0, aligned_size};
+    uint64_t target_offset = 0;
 
     pthread_spin_lock(&spinlock_);
-    auto size_pos = size_idle_tree_.lower_bound(anchor);
-    while (size_pos != size_idle_tree_.end() && !alignment_matches(*size_pos, alignment, aligned_size, head_skip)) {
-        ++size_pos;
+    auto class_index = slab_class_index(aligned_size, alignment);
+    if (slab_enabled_ && class_index >= 0 && slab_allocate_in_lock(class_index, target_offset)) {
+        pthread_spin_unlock(&spinlock_);
+        return base_ + target_offset;
     }
 
-    if (size_pos == size_idle_tree_.end()) {
+    if (!tree_allocate_in_lock(alignment, aligned_size, target_offset)) {
         pthread_spin_unlock(&spinlock_);
         SHM_LOG_ERROR("cannot allocate with size: " << size << ", alignment: " << alignment);
         return nullptr;
     }
-
-    auto target_offset = size_pos->offset;
-    auto target_size = size_pos->size;
-    memory_range result_range{size_pos->offset + head_skip, aligned_size};
-    size_idle_tree_.erase(size_pos);
-
-    if (head_skip > 0) {
-        size_idle_tree_.emplace(memory_range{target_offset, head_skip});
-        address_idle_tree_.emplace(target_offset, head_skip);
-    }
-
-    if (head_skip + aligned_size < target_size) {
-        memory_range leftMR{target_offset + head_skip + aligned_size, target_size - head_skip - aligned_size};
-        size_idle_tree_.emplace(leftMR);
-        address_idle_tree_.emplace(leftMR.offset, leftMR.size);
-    }
-
-    address_used_tree_.emplace(result_range.offset, result_range.size);
+    used_index_set(target_offset, aligned_size);
+    account_allocate_in_lock(aligned_size);
     pthread_spin_unlock(&spinlock_);
 
-    return base_ + result_range.offset;
+    return base_ + target_offset;
 }
 
 bool memory_manager::change_size(void *address, uint64_t size) noexcept
 {
     auto u8a = reinterpret_cast<uint8_t *>(address);
     if (u8a < base_ || u8a >= base_ + size_) {
-        SHM_LOG_ERROR("release invalid address " << address);
+        SHM_LOG_ERROR("change size for invalid address " << address);
         return false;
     }
 
@@ -136,8 +132,23 @@ bool memory_manager::change_size(void *address, uint64_t size) noexcept
         return true;
     }
 
-    auto offset = u8a - base_;
+    // tree blocks keep the allocation granularity, otherwise the idle block behind would lose its alignment
+    auto aligned_size = allocated_size_align_up(size);
+    auto offset = static_cast<uint64_t>(u8a - base_);
     pthread_spin_lock(&spinlock_);
+    auto span = slab_span_of(offset);
+    if (span != nullptr) {
+        uint64_t slot_size = 0;
+        if (!slab_slot_used(span, offset, slot_size)) {
+            pthread_spin_unlock(&spinlock_);
+            SHM_LOG_ERROR("change size for address " << address << " not allocated.");
+            return false;
+        }
+        // slab slots have a fixed size, only sizes which still fit in the slot are accepted
+        pthread_spin_unlock(&spinlock_);
+        return aligned_size <= slot_size;
+    }
+
     auto pos = address_used_tree_.find(offset);
     if (pos == address_used_tree_.end()) {
         pthread_spin_unlock(&spinlock_);
@@ -146,25 +157,61 @@ bool memory_manager::change_size(void *address, uint64_t size) noexcept
     }
 
     // size不变
-    if (pos->second == size) {
+    if (pos->second == aligned_size) {
         pthread_spin_unlock(&spinlock_);
         return true;
     }
 
     // 缩小size
-    if (pos->second > size) {
-        reduce_size_in_lock(pos, size);
+    if (pos->second > aligned_size) {
+        used_bytes_ -= pos->second - aligned_size;
+        reduce_size_in_lock(pos, aligned_size);
+        used_index_set(offset, aligned_size);
         pthread_spin_unlock(&spinlock_);
         return true;
     }
 
     // 扩大size
-    auto success = expend_size_in_lock(pos, size);
+    auto old_size = pos->second;
+    auto success = expend_size_in_lock(pos, aligned_size);
+    if (success) {
+        used_index_set(offset, aligned_size);
+        used_bytes_ += aligned_size - old_size;
+        high_water_mark_ = std::max(high_water_mark_, used_bytes_);
+    }
     pthread_spin_unlock(&spinlock_);
 
     return success;
 }
 
+bool memory_manager::can_change_size(void *address, uint64_t size) const noexcept
+{
+    auto u8a = reinterpret_cast<uint8_t *>(address);
+    if (u8a < base_ || u8a >= base_ + size_ || size == 0) {
+        return false;
+    }
+
+    auto aligned_size = allocated_size_align_up(size);
+    auto offset = static_cast<uint64_t>(u8a - base_);
+    auto success = false;
+    pthread_spin_lock(&spinlock_);
+    auto span = slab_span_of(offset);
+    if (span != nullptr) {
+        uint64_t slot_size = 0;
+        success = slab_slot_used(span, offset, slot_size) && aligned_size <= slot_size;
+    } else {
+        auto pos = address_used_tree_.find(offset);
+        if (pos != address_used_tree_.end()) {
+            // same check as expend_size_in_lock, without touching the trees
+            auto next_addr_pos = address_idle_tree_.find(offset + pos->second);
+            success = aligned_size <= pos->second ||
+                      (next_addr_pos != address_idle_tree_.end() && next_addr_pos->second >= aligned_size - pos->second);
+        }
+    }
+    pthread_spin_unlock(&spinlock_);
+    return success;
+}
+
 int32_t memory_manager::release(void *address) noexcept
 {
     auto u8a = reinterpret_cast<uint8_t *>(address);
@@ -173,45 +220,35 @@ int32_t memory_manager::release(void *address) noexcept
         return -1;
     }
 
-    auto offset = u8a - base_;
-    pthread_spin_lock(&spinlock_);
-    auto pos = address_used_tree_.find(offset);
-    if (pos == address_used_tree_.end()) {
-        pthread_spin_unlock(&spinlock_);
+    // reject frees of unknown addresses without touching the allocator lock, the locked path below re-checks
+    auto offset = static_cast<uint64_t>(u8a - base_);
+    uint64_t size = 0;
+    if (!lookup_lock_free(offset, size)) {
         SHM_LOG_ERROR("release address " << address << " not allocated.");
         return -1;
     }
 
-    auto size = pos->second;
-    uint64_t final_offset = static_cast<uint64_t>(offset);
-    uint64_t final_size = size;
-    address_used_tree_.erase(pos);
-
-    auto prev_addr_pos = address_idle_tree_.lower_bound(offset);
-    if (prev_addr_pos != address_idle_tree_.begin()) {
-        --prev_addr_pos;
-        if (prev_addr_pos != address_idle_tree_.end() &&
-            prev_addr_pos->first + prev_addr_pos->second == static_cast<uint64_t>(offset)) {
-            // 合并前一个range
-            final_offset = prev_addr_pos->first;
-            final_size += prev_addr_pos->second;
-
-            auto prev_addr_range = *prev_addr_pos;
-            address_idle_tree_.erase(prev_addr_pos);
-            size_idle_tree_.erase(memory_range{prev_addr_range.first, prev_addr_range.second});
+    pthread_spin_lock(&spinlock_);
+    auto span = slab_span_of(offset);
+    if (span != nullptr) {
+        auto ret = slab_release_in_lock(span, offset);
+        pthread_spin_unlock(&spinlock_);
+        if (ret != 0) {
+            SHM_LOG_ERROR("release address " << address << " not allocated.");
         }
+        return ret;
     }
 
-    auto next_addr_pos = address_idle_tree_.find(offset + size);
-    if (next_addr_pos != address_idle_tree_.end()) {  // 合并后一个range
-        uint64_t next_addr = next_addr_pos->first;
-        uint64_t next_size = next_addr_pos->second;
-        final_size += next_size;
-        address_idle_tree_.erase(next_addr_pos);
-        size_idle_tree_.erase(memory_range{next_addr, next_size});
+    auto pos = address_used_tree_.find(offset);
+    if (pos == address_used_tree_.end()) {
+        pthread_spin_unlock(&spinlock_);
+        SHM_LOG_ERROR("release address " << address << " not allocated.");
+        return -1;
     }
-    address_idle_tree_.emplace(final_offset, final_size);
-    size_idle_tree_.emplace(memory_range{final_offset, final_size});
+
+    used_index_erase(offset);
+    account_release_in_lock(pos->second);
+    tree_release_in_lock(pos);
     pthread_spin_unlock(&spinlock_);
 
     return 0;
@@ -225,17 +262,42 @@ bool memory_manager::allocated_size(void *address, uint64_t &size) const noexcep
         return false;
     }
 
-    auto offset = u8a - base_;
-    bool exist = false;
+    return lookup_lock_free(static_cast<uint64_t>(u8a - base_), size);
+}
+
+void memory_manager::heap_stats(aclshmemx_heap_stats_t &stats) const noexcept
+{
     pthread_spin_lock(&spinlock_);
-    auto pos = address_used_tree_.find(offset);
-    if (pos != address_used_tree_.end()) {
-        exist = true;
-        size = pos->second;
-    }
+    stats.total_bytes = size_;
+    stats.used_bytes = used_bytes_;
+    stats.free_bytes = size_ - used_bytes_;
+    stats.high_water_mark = high_water_mark_;
+    stats.allocated_blocks = allocated_blocks_;
+    stats.slab_bytes = slab_bytes_;
+    stats.free_block_count = size_idle_tree_.size();
+    stats.largest_free_block = size_idle_tree_.empty() ? 0UL : size_idle_tree_.rbegin()->size;
+    std::copy(std::begin(free_block_histogram_), std::end(free_block_histogram_), stats.free_block_histogram);
     pthread_spin_unlock(&spinlock_);
+}
 
-    return exist;
+void memory_manager::defer_release(void *address) noexcept
+{
+    pthread_spin_lock(&spinlock_);
+    deferred_releases_.push_back(address);
+    pthread_spin_unlock(&spinlock_);
+}
+
+uint64_t memory_manager::flush_deferred_releases() noexcept
+{
+    std::vector<void *> pending;
+    pthread_spin_lock(&spinlock_);
+    pending.swap(deferred_releases_);
+    pthread_spin_unlock(&spinlock_);
+
+    for (auto address : pending) {
+        release(address);
+    }
+    return pending.size();
 }
 
 uint64_t memory_manager::allocated_size_align_up(uint64_t input_size) noexcept
@@ -270,12 +332,14 @@ void memory_manager::reduce_size_in_lock(const std::map<uint64_t, uint64_t>::ite
     auto next_addr_pos = address_idle_tree_.find(offset + old_size);
     if (next_addr_pos == address_idle_tree_.end()) {
         address_idle_tree_.emplace(offset + new_size, old_size - new_size);
-        size_idle_tree_.emplace(memory_range{offset + new_size, old_size - new_size});
+        size_idle_insert_in_lock(memory_range{offset + new_size, old_size - new_size});
     } else {
         auto next_size_pos = size_idle_tree_.find(memory_range{next_addr_pos->first, next_addr_pos->second});
-        size_idle_tree_.erase(next_size_pos);
-        next_addr_pos->second += (old_size - new_size);
-        size_idle_tree_.emplace(memory_range{next_addr_pos->first, next_addr_pos->second});
+        size_idle_erase_in_lock(next_size_pos);
+        auto merged_size = next_addr_pos->second + (old_size - new_size);
+        address_idle_tree_.erase(next_addr_pos);
+        address_idle_tree_.emplace(offset + new_size, merged_size);
+        size_idle_insert_in_lock(memory_range{offset + new_size, merged_size});
     }
 }
 
@@ -292,14 +356,408 @@ bool memory_manager::expend_size_in_lock(const std::map<uint64_t, uint64_t>::ite
 
     pos->second = new_size;
     auto next_size_pos = size_idle_tree_.find(memory_range{next_addr_pos->first, next_addr_pos->second});
-    if (next_addr_pos->second == delta) {
-        size_idle_tree_.erase(next_size_pos);
+    size_idle_erase_in_lock(next_size_pos);
+    auto left_size = next_addr_pos->second - delta;
+    address_idle_tree_.erase(next_addr_pos);
+    if (left_size > 0) {
+        address_idle_tree_.emplace(offset + new_size, left_size);
+        size_idle_insert_in_lock(memory_range{offset + new_size, left_size});
+    }
+
+    return true;
+}
+
+uint32_t memory_manager::heap_stats_bucket(uint64_t size) noexcept
+{
+    auto order = static_cast<uint32_t>(63 - __builtin_clzll(size | 1UL));
+    if (order <= HEAP_STATS_MIN_ORDER) {
+        return 0;
+    }
+    return std::min(order - HEAP_STATS_MIN_ORDER, ACLSHMEM_HEAP_STATS_BUCKET_NUM - 1U);
+}
+
+void memory_manager::size_idle_insert_in_lock(const memory_range &mr) noexcept
+{
+    size_idle_tree_.emplace(mr);
+    free_block_histogram_[heap_stats_bucket(mr.size)]++;
+}
+
+void memory_manager::size_idle_erase_in_lock(const std::set<memory_range, range_size_first_comparator>::iterator &pos) noexcept
+{
+    free_block_histogram_[heap_stats_bucket(pos->size)]--;
+    size_idle_tree_.erase(pos);
+}
+
+void memory_manager::account_allocate_in_lock(uint64_t size) noexcept
+{
+    used_bytes_ += size;
+    allocated_blocks_++;
+    high_water_mark_ = std::max(high_water_mark_, used_bytes_);
+}
+
+void memory_manager::account_release_in_lock(uint64_t size) noexcept
+{
+    used_bytes_ -= size;
+    allocated_blocks_--;
+}
+
+bool memory_manager::tree_allocate_in_lock(uint64_t alignment, uint64_t aligned_size, uint64_t &offset) noexcept
+{
+    uint64_t head_skip = 0;
+    memory_range anchor{0, aligned_size};
+    auto size_pos = size_idle_tree_.lower_bound(anchor);
+    while (size_pos != size_idle_tree_.end() && !alignment_matches(*size_pos, alignment, aligned_size, head_skip)) {
+        ++size_pos;
+    }
+
+    if (size_pos == size_idle_tree_.end()) {
+        // idle slab spans hold heap space back from the trees, give them back and try once more
+        if (!slab_drain_empty_spans_in_lock()) {
+            return false;
+        }
+        return tree_allocate_in_lock(alignment, aligned_size, offset);
+    }
+
+    auto target_offset = size_pos->offset;
+    auto target_size = size_pos->size;
+    auto addr_pos = address_idle_tree_.find(target_offset);
+    if (addr_pos == address_idle_tree_.end()) {
+        SHM_LOG_ERROR("offset(" << target_offset << ") size(" << target_size << ") in size tree, not in address tree.");
+        return false;
+    }
+
+    size_idle_erase_in_lock(size_pos);
+    address_idle_tree_.erase(addr_pos);
+
+    if (head_skip > 0) {
+        size_idle_insert_in_lock(memory_range{target_offset, head_skip});
+        address_idle_tree_.emplace(target_offset, head_skip);
+    }
+
+    if (head_skip + aligned_size < target_size) {
+        memory_range left{target_offset + head_skip + aligned_size, target_size - head_skip - aligned_size};
+        size_idle_insert_in_lock(left);
+        address_idle_tree_.emplace(left.offset, left.size);
+    }
+
+    offset = target_offset + head_skip;
+    address_used_tree_.emplace(offset, aligned_size);
+    return true;
+}
+
+void memory_manager::tree_release_in_lock(const std::map<uint64_t, uint64_t>::iterator &pos) noexcept
+{
+    auto offset = pos->first;
+    auto size = pos->second;
+    uint64_t final_offset = offset;
+    uint64_t final_size = size;
+    address_used_tree_.erase(pos);
+
+    auto prev_addr_pos = address_idle_tree_.lower_bound(offset);
+    if (prev_addr_pos != address_idle_tree_.begin()) {
+        --prev_addr_pos;
+        if (prev_addr_pos != address_idle_tree_.end() && prev_addr_pos->first + prev_addr_pos->second == offset) {
+            // 合并前一个range
+            final_offset = prev_addr_pos->first;
+            final_size += prev_addr_pos->second;
+
+            auto prev_addr_range = *prev_addr_pos;
+            address_idle_tree_.erase(prev_addr_pos);
+            size_idle_erase_in_lock(size_idle_tree_.find(memory_range{prev_addr_range.first, prev_addr_range.second}));
+        }
+    }
+
+    auto next_addr_pos = address_idle_tree_.find(offset + size);
+    if (next_addr_pos != address_idle_tree_.end()) {  // 合并后一个range
+        uint64_t next_addr = next_addr_pos->first;
+        uint64_t next_size = next_addr_pos->second;
+        final_size += next_size;
         address_idle_tree_.erase(next_addr_pos);
+        size_idle_erase_in_lock(size_idle_tree_.find(memory_range{next_addr, next_size}));
+    }
+    address_idle_tree_.emplace(final_offset, final_size);
+    size_idle_insert_in_lock(memory_range{final_offset, final_size});
+}
+
+used_block_shard &memory_manager::used_shard_of(uint64_t offset) const noexcept
+{
+    return used_index_[(offset >> SLAB_GRANULE_SHIFT) % USED_INDEX_SHARD_NUM];
+}
+
+void memory_manager::used_index_set(uint64_t offset, uint64_t size) noexcept
+{
+    auto &shard = used_shard_of(offset);
+    pthread_rwlock_wrlock(&shard.lock);
+    shard.blocks[offset] = size;
+    pthread_rwlock_unlock(&shard.lock);
+}
+
+void memory_manager::used_index_erase(uint64_t offset) noexcept
+{
+    auto &shard = used_shard_of(offset);
+    pthread_rwlock_wrlock(&shard.lock);
+    shard.blocks.erase(offset);
+    pthread_rwlock_unlock(&shard.lock);
+}
+
+bool memory_manager::lookup_lock_free(uint64_t offset, uint64_t &size) const noexcept
+{
+    while (true) {
+        auto span = slab_span_of(offset);
+        if (span == nullptr) {
+            break;
+        }
+
+        // seqlock style read, a span retired or reused meanwhile changes the generation and we look again
+        auto generation = span->generation.load(std::memory_order_acquire);
+        if ((generation & 1UL) == 0) {
+            uint64_t slot_size = 0;
+            auto used = slab_slot_used(span, offset, slot_size);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (span->generation.load(std::memory_order_relaxed) == generation) {
+                if (used) {
+                    size = slot_size;
+                }
+                return used;
+            }
+        }
+    }
+
+    bool exist = false;
+    auto &shard = used_shard_of(offset);
+    pthread_rwlock_rdlock(&shard.lock);
+    auto pos = shard.blocks.find(offset);
+    if (pos != shard.blocks.end()) {
+        exist = true;
+        size = pos->second;
+    }
+    pthread_rwlock_unlock(&shard.lock);
+    return exist;
+}
+
+int32_t memory_manager::slab_class_index(uint64_t aligned_size, uint64_t alignment) noexcept
+{
+    auto request = std::max(aligned_size, alignment);
+    if (request > (1UL << SLAB_MAX_SLOT_SHIFT)) {
+        return -1;
+    }
+
+    uint64_t shift = SLAB_MIN_SLOT_SHIFT;
+    while ((1UL << shift) < request) {
+        shift++;
+    }
+    return static_cast<int32_t>(shift - SLAB_MIN_SLOT_SHIFT);
+}
+
+slab_span *memory_manager::slab_span_of(uint64_t offset) const noexcept
+{
+    auto granule = offset >> SLAB_GRANULE_SHIFT;
+    if ((granule >> SLAB_RADIX_LEAF_BITS) >= slab_radix_.size()) {
+        return nullptr;
+    }
+    auto leaf = slab_radix_[granule >> SLAB_RADIX_LEAF_BITS].load(std::memory_order_acquire);
+    if (leaf == nullptr) {
+        return nullptr;
+    }
+    return leaf->spans[granule & (SLAB_RADIX_LEAF_SIZE - 1U)].load(std::memory_order_acquire);
+}
+
+void memory_manager::slab_span_publish(slab_span *span, slab_span *value) noexcept
+{
+    auto first = span->offset.load(std::memory_order_relaxed) >> SLAB_GRANULE_SHIFT;
+    for (uint64_t granule = first; granule < first + (span->size >> SLAB_GRANULE_SHIFT); granule++) {
+        auto &slot = slab_radix_[granule >> SLAB_RADIX_LEAF_BITS];
+        auto leaf = slot.load(std::memory_order_relaxed);
+        if (leaf == nullptr) {
+            if (value == nullptr) {
+                continue;
+            }
+            leaf = new (std::nothrow) slab_radix_leaf;
+            if (leaf == nullptr) {
+                SHM_LOG_ERROR("allocate slab radix leaf failed.");
+                continue;
+            }
+            slot.store(leaf, std::memory_order_release);
+        }
+        leaf->spans[granule & (SLAB_RADIX_LEAF_SIZE - 1U)].store(value, std::memory_order_release);
+    }
+}
+
+bool memory_manager::slab_slot_used(const slab_span *span, uint64_t offset, uint64_t &slot_size) noexcept
+{
+    auto span_offset = span->offset.load(std::memory_order_relaxed);
+    slot_size = span->slot_size.load(std::memory_order_relaxed);
+    if (slot_size == 0 || offset < span_offset) {
+        return false;
+    }
+
+    auto relative = offset - span_offset;
+    if (relative % slot_size != 0) {
+        return false;
+    }
+    // bits past slot_count are never set, so an offset beyond the span simply reads as free
+    auto slot = relative / slot_size;
+    if (slot >= SLAB_MAX_SLOTS_PER_SPAN) {
+        return false;
+    }
+    return (span->used_bitmap[slot >> 6U].load(std::memory_order_acquire) & (1UL << (slot & 63U))) != 0;
+}
+
+bool memory_manager::slab_allocate_in_lock(int32_t class_index, uint64_t &offset) noexcept
+{
+    auto &cls = slab_classes_[class_index];
+    auto span = cls.partial_head;
+    if (span == nullptr) {
+        span = slab_new_span_in_lock(class_index);
+        if (span == nullptr) {
+            return false;
+        }
+    }
+
+    uint32_t slot;
+    if (!span->free_slots.empty()) {
+        slot = span->free_slots.back();
+        span->free_slots.pop_back();
     } else {
-        size_idle_tree_.erase(next_size_pos);
-        next_addr_pos->second -= delta;
-        size_idle_tree_.emplace(memory_range{next_addr_pos->first, next_addr_pos->second});
+        slot = span->bump_index++;
+    }
+    span->used_bitmap[slot >> 6U].fetch_or(1UL << (slot & 63U), std::memory_order_release);
+    span->used_count++;
+
+    if (cls.empty_span == span) {
+        cls.empty_span = nullptr;
+    }
+    if (span->used_count == span->slot_count) {
+        slab_unlink_partial(span);
     }
 
+    offset = span->offset.load(std::memory_order_relaxed) + slot * cls.slot_size;
+    account_allocate_in_lock(cls.slot_size);
     return true;
 }
+
+slab_span *memory_manager::slab_new_span_in_lock(int32_t class_index) noexcept
+{
+    auto &cls = slab_classes_[class_index];
+    uint64_t span_offset = 0;
+    if (!tree_allocate_in_lock(SLAB_GRANULE_SIZE, cls.span_size, span_offset)) {
+        return nullptr;
+    }
+
+    slab_span *span = nullptr;
+    if (!slab_span_pool_.empty()) {
+        span = slab_span_pool_.back();
+        slab_span_pool_.pop_back();
+    } else {
+        std::unique_ptr<slab_span> holder{new (std::nothrow) slab_span};
+        if (holder != nullptr) {
+            span = holder.get();
+            slab_span_storage_.push_back(std::move(holder));
+        }
+    }
+    if (span == nullptr) {
+        tree_release_in_lock(address_used_tree_.find(span_offset));
+        return nullptr;
+    }
+
+    // the generation is odd while retired, readers holding a stale pointer see it change and retry
+    std::atomic_thread_fence(std::memory_order_release);
+    span->offset.store(span_offset, std::memory_order_relaxed);
+    span->slot_size.store(cls.slot_size, std::memory_order_relaxed);
+    span->size = cls.span_size;
+    span->class_index = static_cast<uint32_t>(class_index);
+    span->slot_count = static_cast<uint32_t>(cls.span_size / cls.slot_size);
+    span->used_count = 0;
+    span->bump_index = 0;
+    span->free_slots.clear();
+    span->generation.fetch_add(1UL, std::memory_order_release);
+
+    // spans are owned by the radix tree from now on, the used tree does not track them
+    address_used_tree_.erase(span_offset);
+    slab_bytes_ += cls.span_size;
+    slab_span_publish(span, span);
+    slab_link_partial(span);
+    return span;
+}
+
+int32_t memory_manager::slab_release_in_lock(slab_span *span, uint64_t offset) noexcept
+{
+    auto &cls = slab_classes_[span->class_index];
+    auto relative = offset - span->offset.load(std::memory_order_relaxed);
+    if (relative % cls.slot_size != 0) {
+        return -1;
+    }
+
+    auto slot = static_cast<uint32_t>(relative / cls.slot_size);
+    auto mask = 1UL << (slot & 63U);
+    if ((span->used_bitmap[slot >> 6U].load(std::memory_order_relaxed) & mask) == 0) {
+        return -1;
+    }
+
+    span->used_bitmap[slot >> 6U].fetch_and(~mask, std::memory_order_release);
+    account_release_in_lock(cls.slot_size);
+    span->free_slots.push_back(slot);
+    if (span->used_count-- == span->slot_count) {
+        slab_link_partial(span);
+    }
+
+    if (span->used_count == 0) {
+        if (cls.empty_span == nullptr) {
+            cls.empty_span = span;
+        } else {
+            slab_free_span_in_lock(span);
+        }
+    }
+    return 0;
+}
+
+void memory_manager::slab_free_span_in_lock(slab_span *span) noexcept
+{
+    slab_unlink_partial(span);
+    slab_span_publish(span, nullptr);
+    span->generation.fetch_add(1UL, std::memory_order_release);
+
+    slab_bytes_ -= span->size;
+    auto pos = address_used_tree_.emplace(span->offset.load(std::memory_order_relaxed), span->size).first;
+    tree_release_in_lock(pos);
+    slab_span_pool_.push_back(span);
+}
+
+bool memory_manager::slab_drain_empty_spans_in_lock() noexcept
+{
+    bool drained = false;
+    for (auto &cls : slab_classes_) {
+        if (cls.empty_span != nullptr) {
+            slab_free_span_in_lock(cls.empty_span);
+            cls.empty_span = nullptr;
+            drained = true;
+        }
+    }
+    return drained;
+}
+
+void memory_manager::slab_link_partial(slab_span *span) noexcept
+{
+    auto &cls = slab_classes_[span->class_index];
+    span->prev = nullptr;
+    span->next = cls.partial_head;
+    if (cls.partial_head != nullptr) {
+        cls.partial_head->prev = span;
+    }
+    cls.partial_head = span;
+}
+
+void memory_manager::slab_unlink_partial(slab_span *span) noexcept
+{
+    auto &cls = slab_classes_[span->class_index];
+    if (span->prev != nullptr) {
+        span->prev->next = span->next;
+    } else {
+        cls.partial_head = span->next;
+    }
+    if (span->next != nullptr) {
+        span->next->prev = span->prev;
+    }
+    span->prev = nullptr;
+    span->next = nullptr;
+}
@@ -7,6 +7,7 @@
  * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
  * See LICENSE in the root of the software repository for the full text of the License.
  */
+#include <algorithm>
 #include <memory>
 #include "acl/acl.h"
 #include "shmemi_host_common.h"
@@ -26,6 +27,25 @@ int32_t memory_manager_initialize(void *base, uint64_t size, aclshmem_mem_type_t
     return ACLSHMEM_SUCCESS;
 }
 
+// device heap may be committed lazily, back [ptr, ptr + size) with HBM before it is handed out
+static void *commit_or_release(const std::shared_ptr<memory_manager> &mem_manager, void *ptr, size_t size,
+                               aclshmem_mem_type_t mem_type = DEVICE_SIDE)
+{
+    if (mem_type == HOST_SIDE) {
+        return ptr;
+    }
+    // collective, a PE whose allocation failed still joins with nullptr so all PEs fail together
+    auto ret = aclshmemi_commit_heap(ptr, size);
+    if (ret != 0) {
+        SHM_LOG_ERROR("commit heap for " << size << " bytes at " << ptr << " failed, ret: " << ret);
+        if (ptr != nullptr) {
+            mem_manager->release(ptr);
+        }
+        return nullptr;
+    }
+    return ptr;
+}
+
 void memory_manager_destroy()
 {
     aclshmemi_memory_manager.reset();
@@ -42,6 +62,7 @@ void *aclshmem_malloc(size_t size)
     }
 
     void *ptr = aclshmemi_memory_manager->allocate(size);
+    ptr = commit_or_release(aclshmemi_memory_manager, ptr, size);
     SHM_LOG_DEBUG("aclshmem_malloc(" << size << ")" << " ptr: " << ptr);
     auto ret = aclshmemi_control_barrier_all();
     if (ret != 0) {
@@ -71,6 +92,7 @@ void *aclshmem_calloc(size_t nmemb, size_t size)
 
     auto total_size = nmemb * size;
     auto ptr = aclshmemi_memory_manager->allocate(total_size);
+    ptr = commit_or_release(aclshmemi_memory_manager, ptr, total_size);
     if (ptr != nullptr) {
         auto ret = aclrtMemset(ptr, total_size, 0, total_size);
         if (ret != 0) {
@@ -101,6 +123,7 @@ void *aclshmem_align(size_t alignment, size_t size)
     }
 
     auto ptr = aclshmemi_memory_manager->aligned_allocate(alignment, size);
+    ptr = commit_or_release(aclshmemi_memory_manager, ptr, size);
     auto ret = aclshmemi_control_barrier_all();
     if (ret != 0) {
         SHM_LOG_ERROR("aclshmem_align mem barrier failed, ret: " << ret);
@@ -201,6 +224,7 @@ void *aclshmemx_malloc(size_t size, aclshmem_mem_type_t mem_type)
         return nullptr;
     }
     void *ptr = mem_manager->allocate(size);
+    ptr = commit_or_release(mem_manager, ptr, size, mem_type);
     SHM_LOG_DEBUG("aclshmem_malloc(" << size << ")");
     auto ret = aclshmemi_control_barrier_all();
     if (ret != 0) {
@@ -225,6 +249,7 @@ void *aclshmemx_calloc(size_t nmemb, size_t size, aclshmem_mem_type_t mem_type)
     SHM_ASSERT_MULTIPLY_OVERFLOW(nmemb, size, g_state.heap_size, nullptr);
     auto total_size = nmemb * size;
     auto ptr = mem_manager->allocate(total_size);
+    ptr = commit_or_release(mem_manager, ptr, total_size, mem_type);
     if (ptr != nullptr) {
         auto ret = aclrtMemset(ptr, total_size, 0, total_size);
         if (ret != 0) {
@@ -256,6 +281,7 @@ void *aclshmemx_align(size_t alignment, size_t size, aclshmem_mem_type_t mem_typ
         return nullptr;
     }
     auto ptr = mem_manager->aligned_allocate(alignment, size);
+    ptr = commit_or_release(mem_manager, ptr, size, mem_type);
     auto ret = aclshmemi_control_barrier_all();
     if (ret != 0) {
         SHM_LOG_ERROR("align mem barrier failed, ret: " << ret);
@@ -297,4 +323,248 @@ void aclshmemx_free(void *ptr, aclshmem_mem_type_t mem_type)
     }
 
     SHM_LOG_DEBUG("aclshmemx_free " << ret);
-}
\ No newline at end of file
+}
+
+// every PE copies its own block, the copy is queued on the default stream and waited once
+static int32_t copy_heap_block(void *dst, const void *src, uint64_t size, aclshmem_mem_type_t mem_type)
+{
+    if (mem_type == HOST_SIDE) {
+        return aclrtMemcpy(dst, size, src, size, ACL_MEMCPY_HOST_TO_HOST);
+    }
+    auto stream = g_state_host.default_stream;
+    ACLSHMEM_CHECK_RET(aclrtMemcpyAsync(dst, size, src, size, ACL_MEMCPY_DEVICE_TO_DEVICE, stream));
+    ACLSHMEM_CHECK_RET(aclrtSynchronizeStream(stream));
+    return ACLSHMEM_SUCCESS;
+}
+
+void *aclshmemx_realloc(void *ptr, size_t size, aclshmem_mem_type_t mem_type)
+{
+    if (ptr == nullptr) {
+        return aclshmemx_malloc(size, mem_type);
+    }
+    if (size == 0) {
+        aclshmemx_free(ptr, mem_type);
+        return nullptr;
+    }
+    if (!support_host_mem_type(mem_type)) {
+        return nullptr;
+    }
+    auto mem_manager = mem_type == HOST_SIDE ? aclshmemi_host_memory_manager : aclshmemi_memory_manager;
+    if (mem_manager == nullptr) {
+        SHM_LOG_ERROR("Memory Heap Not Initialized.");
+        return nullptr;
+    }
+    uint64_t old_size = 0;
+    if (!mem_manager->allocated_size(ptr, old_size)) {
+        SHM_LOG_ERROR("aclshmemx_realloc invalid ptr: " << ptr);
+        return nullptr;
+    }
+
+    // the block is resized in place only when it can be resized on every PE, decided by one allgather
+    bool in_place = false;
+    auto ret = aclshmemi_all_agreed(mem_manager->can_change_size(ptr, size), in_place);
+    if (ret != 0) {
+        SHM_LOG_ERROR("realloc agreement failed, ret: " << ret);
+        return nullptr;
+    }
+    if (in_place) {
+        // every PE resizes and commits, then agrees on the result, a failure anywhere restores the old size everywhere
+        bool resized = mem_manager->change_size(ptr, size);
+        if (!resized) {
+            SHM_LOG_ERROR("aclshmemx_realloc(" << ptr << ", " << size << ") change size failed.");
+        }
+        if (mem_type == DEVICE_SIDE && aclshmemi_commit_heap(resized ? ptr : nullptr, size) != 0) {
+            SHM_LOG_ERROR("commit heap for realloc(" << ptr << ", " << size << ") failed.");
+            if (resized) {
+                mem_manager->change_size(ptr, old_size);
+                resized = false;
+            }
+        }
+        bool all_resized = false;
+        ret = aclshmemi_all_agreed(resized, all_resized);
+        if (ret != 0 || !all_resized) {
+            SHM_LOG_ERROR("aclshmemx_realloc(" << ptr << ", " << size << ") not resized on every PE, ret: " << ret);
+            if (resized) {
+                mem_manager->change_size(ptr, old_size);
+            }
+            return nullptr;
+        }
+        SHM_LOG_DEBUG("aclshmemx_realloc(" << ptr << ", " << size << ") in place");
+        return ptr;
+    }
+
+    // fall back to allocate + copy + free, the old block stays valid if anything fails
+    auto new_ptr = commit_or_release(mem_manager, mem_manager->allocate(size), size, mem_type);
+    if (new_ptr != nullptr) {
+        ret = copy_heap_block(new_ptr, ptr, std::min(static_cast<uint64_t>(size), old_size), mem_type);
+        if (ret != 0) {
+            SHM_LOG_ERROR("aclshmemx_realloc(" << ptr << ", " << size << ") copy failed: " << ret);
+            mem_manager->release(new_ptr);
+            new_ptr = nullptr;
+        }
+    }
+
+    // the old block is freed only when every PE moved, otherwise all PEs keep it and drop the new one
+    bool all_moved = false;
+    ret = aclshmemi_all_agreed(new_ptr != nullptr, all_moved);
+    if (ret != 0 || !all_moved) {
+        SHM_LOG_ERROR("aclshmemx_realloc(" << ptr << ", " << size << ") not moved on every PE, ret: " << ret);
+        if (new_ptr != nullptr) {
+            mem_manager->release(new_ptr);
+        }
+        return nullptr;
+    }
+    mem_manager->release(ptr);
+    SHM_LOG_DEBUG("aclshmemx_realloc(" << ptr << ", " << size << ") moved to " << new_ptr);
+    return new_ptr;
+}
+
+void aclshmemi_flush_deferred_free()
+{
+    if (aclshmemi_memory_manager != nullptr) {
+        aclshmemi_memory_manager->flush_deferred_releases();
+    }
+    if (aclshmemi_host_memory_manager != nullptr) {
+        aclshmemi_host_memory_manager->flush_deferred_releases();
+    }
+}
+
+int32_t aclshmemx_malloc_batch(const size_t *sizes, size_t count, void **ptrs, aclshmem_mem_type_t mem_type)
+{
+    if (sizes == nullptr || ptrs == nullptr || count == 0) {
+        SHM_LOG_ERROR("invalid input, sizes=" << sizes << ", ptrs=" << ptrs << ", count=" << count);
+        return ACLSHMEM_INVALID_PARAM;
+    }
+    if (!support_host_mem_type(mem_type)) {
+        return ACLSHMEM_NOT_SUPPORTED;
+    }
+    auto mem_manager = getory_manager(mem_type);
+    if (mem_manager == nullptr) {
+        return ACLSHMEM_NOT_INITED;
+    }
+
+    std::fill(ptrs, ptrs + count, nullptr);
+    int32_t result = ACLSHMEM_SUCCESS;
+    void *last_ptr = nullptr;
+    size_t last_size = 0;
+    for (size_t i = 0; i < count; i++) {
+        ptrs[i] = mem_manager->allocate(sizes[i]);
+        if (ptrs[i] == nullptr) {
+            SHM_LOG_ERROR("aclshmemx_malloc_batch allocate index " << i << " size " << sizes[i] << " failed.");
+            result = ACLSHMEM_MALLOC_FAILED;
+        } else if (last_ptr == nullptr || reinterpret_cast<uintptr_t>(ptrs[i]) + sizes[i] >
+                   reinterpret_cast<uintptr_t>(last_ptr) + last_size) {
+            last_ptr = ptrs[i];
+            last_size = sizes[i];
+        }
+    }
+
+    // one commit up to the farthest block end backs the whole batch,
+    // a PE that failed to allocate joins with nullptr and a non-zero size so the commit fails on every PE
+    if (mem_type == DEVICE_SIDE) {
+        bool ok = result == ACLSHMEM_SUCCESS;
+        auto ret = aclshmemi_commit_heap(ok ? last_ptr : nullptr, ok ? last_size : 1U);
+        if (ret != 0) {
+            SHM_LOG_ERROR("commit heap for malloc batch of " << count << " blocks failed, ret: " << ret);
+            result = ACLSHMEM_MALLOC_FAILED;
+        }
+    }
+
+    // every PE still joins the barrier, so a local failure cannot leave the others hanging
+    auto ret = aclshmemi_control_barrier_all();
+    if (ret != 0) {
+        SHM_LOG_ERROR("malloc batch barrier failed, ret: " << ret);
+        result = ACLSHMEM_BOOTSTRAP_ERROR;
+    }
+#ifdef DEBUG_MODE
+    // collective, every PE runs it whatever its own result is
+    if (is_alloc_sizes_symmetric(sizes, count) != 0) {
+        SHM_LOG_ERROR("asymmetric batch alloc detected");
+        if (result == ACLSHMEM_SUCCESS) {
+            result = ACLSHMEM_INVALID_PARAM;
+        }
+    }
+#endif
+    if (result != ACLSHMEM_SUCCESS) {
+        for (size_t i = 0; i < count; i++) {
+            if (ptrs[i] != nullptr) {
+                mem_manager->release(ptrs[i]);
+            }
+            ptrs[i] = nullptr;
+        }
+        return result;
+    }
+
+    SHM_LOG_DEBUG("aclshmemx_malloc_batch(" << count << ")");
+    return ACLSHMEM_SUCCESS;
+}
+
+void aclshmemx_free_batch(void **ptrs, size_t count, aclshmem_mem_type_t mem_type)
+{
+    if (ptrs == nullptr || count == 0) {
+        return;
+    }
+    if (!support_host_mem_type(mem_type)) {
+        return;
+    }
+    auto mem_manager = mem_type == HOST_SIDE ? aclshmemi_host_memory_manager : aclshmemi_memory_manager;
+    if (mem_manager == nullptr) {
+        SHM_LOG_ERROR("Memory Heap Not Initialized.");
+        return;
+    }
+
+    int ctrl_ret = aclshmemi_control_barrier_all();
+    if (ctrl_ret != 0) {
+        SHM_LOG_ERROR("free batch barrier failed, ret: " << ctrl_ret);
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (ptrs[i] == nullptr) {
+            continue;
+        }
+        auto ret = mem_manager->release(ptrs[i]);
+        if (ret != 0) {
+            SHM_LOG_ERROR("release index " << i << " failed: " << ret);
+        }
+    }
+
+    SHM_LOG_DEBUG("aclshmemx_free_batch(" << count << ")");
+}
+
+void aclshmemx_free_deferred(void *ptr, aclshmem_mem_type_t mem_type)
+{
+    if (!support_host_mem_type(mem_type)) {
+        return;
+    }
+    if (ptr == nullptr) {
+        return;
+    }
+    auto mem_manager = mem_type == HOST_SIDE ? aclshmemi_host_memory_manager : aclshmemi_memory_manager;
+    if (mem_manager == nullptr) {
+        SHM_LOG_ERROR("Memory Heap Not Initialized.");
+        return;
+    }
+
+    mem_manager->defer_release(ptr);
+    SHM_LOG_DEBUG("aclshmemx_free_deferred " << ptr);
+}
+
+int32_t aclshmemx_heap_stats(aclshmemx_heap_stats_t *stats, aclshmem_mem_type_t mem_type)
+{
+    if (stats == nullptr) {
+        SHM_LOG_ERROR("heap stats output is null.");
+        return ACLSHMEM_INVALID_PARAM;
+    }
+    if (!support_host_mem_type(mem_type)) {
+        return ACLSHMEM_NOT_SUPPORTED;
+    }
+    auto mem_manager = mem_type == HOST_SIDE ? aclshmemi_host_memory_manager : aclshmemi_memory_manager;
+    if (mem_manager == nullptr) {
+        SHM_LOG_ERROR("Memory Heap Not Initialized.");
+        return ACLSHMEM_NOT_INITED;
+    }
+
+    mem_manager->heap_stats(*stats);
+    return ACLSHMEM_SUCCESS;
+}
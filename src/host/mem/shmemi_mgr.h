@@ -11,9 +11,13 @@
 #define SHMEMI_HEAP_H
 
 #include <pthread.h>
+#include <atomic>
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 #include "host/shmem_host_def.h"
 #include "utils/shmemi_host_types.h"
@@ -31,17 +35,68 @@ struct range_size_first_comparator {
     bool operator()(const memory_range &mr1, const memory_range &mr2) const noexcept;
 };
 
+constexpr uint32_t SLAB_MAX_SLOTS_PER_SPAN = 1024U;
+constexpr uint32_t SLAB_BITMAP_WORDS = SLAB_MAX_SLOTS_PER_SPAN / 64U;
+
+/**
+ * A span is a contiguous range carved from the best-fit trees and cut into equal slots of one size class.
+ * All bookkeeping lives on host, the device memory itself is never touched.
+ * Span objects are recycled but never freed while the manager lives, so lock-free readers may hold a stale
+ * pointer; they validate what they read against <i>generation</i>, which is odd while the span is retired.
+ */
+struct slab_span {
+    std::atomic<uint64_t> generation{1};
+    std::atomic<uint64_t> offset{0};
+    std::atomic<uint64_t> slot_size{0};
+    std::atomic<uint64_t> used_bitmap[SLAB_BITMAP_WORDS]{};
+    uint64_t size{0};
+    uint32_t class_index{0};
+    uint32_t slot_count{0};
+    uint32_t used_count{0};
+    uint32_t bump_index{0};             // slots in [bump_index, slot_count) have never been handed out
+    std::vector<uint32_t> free_slots;   // LIFO of released slots
+    slab_span *prev{nullptr};
+    slab_span *next{nullptr};
+};
+
+struct slab_class {
+    uint64_t slot_size{0};
+    uint64_t span_size{0};
+    slab_span *partial_head{nullptr};   // spans which still have free slots
+    slab_span *empty_span{nullptr};     // one fully free span kept to avoid carve/return thrashing
+};
+
+constexpr uint32_t SLAB_RADIX_LEAF_BITS = 10U;
+constexpr uint32_t SLAB_RADIX_LEAF_SIZE = 1U << SLAB_RADIX_LEAF_BITS;
+
+struct slab_radix_leaf {
+    std::atomic<slab_span *> spans[SLAB_RADIX_LEAF_SIZE]{};
+};
+
+/**
+ * Index of blocks owned by the best-fit trees, sharded by (offset >> 16) so that lookups only take a shard read
+ * lock and never the allocator lock. Writers always hold the allocator lock as well.
+ */
+struct used_block_shard {
+    mutable pthread_rwlock_t lock = PTHREAD_RWLOCK_INITIALIZER;
+    std::unordered_map<uint64_t, uint64_t> blocks;
+};
+
 class memory_manager {
 public:
-    memory_manager(void *base, uint64_t size) noexcept;
+    memory_manager(void *base, uint64_t size, bool slab_enabled = true) noexcept;
     ~memory_manager() noexcept;
 
 public:
     void *allocate(uint64_t size) noexcept;
     void *aligned_allocate(uint64_t alignment, uint64_t size) noexcept;
     bool change_size(void *address, uint64_t size) noexcept;
+    bool can_change_size(void *address, uint64_t size) const noexcept;
     int32_t release(void *address) noexcept;
     bool allocated_size(void *address, uint64_t &size) const noexcept;
+    void heap_stats(aclshmemx_heap_stats_t &stats) const noexcept;
+    void defer_release(void *address) noexcept;
+    uint64_t flush_deferred_releases() noexcept;
 
 private:
     static uint64_t allocated_size_align_up(uint64_t input_size) noexcept;
@@ -50,13 +105,63 @@ private:
     void reduce_size_in_lock(const std::map<uint64_t, uint64_t>::iterator &pos, uint64_t new_size) noexcept;
     bool expend_size_in_lock(const std::map<uint64_t, uint64_t>::iterator &pos, uint64_t new_size) noexcept;
 
+    static uint32_t heap_stats_bucket(uint64_t size) noexcept;
+    void size_idle_insert_in_lock(const memory_range &mr) noexcept;
+    void size_idle_erase_in_lock(const std::set<memory_range, range_size_first_comparator>::iterator &pos) noexcept;
+    void account_allocate_in_lock(uint64_t size) noexcept;
+    void account_release_in_lock(uint64_t size) noexcept;
+
+    bool tree_allocate_in_lock(uint64_t alignment, uint64_t aligned_size, uint64_t &offset) noexcept;
+    void tree_release_in_lock(const std::map<uint64_t, uint64_t>::iterator &pos) noexcept;
+
+    used_block_shard &used_shard_of(uint64_t offset) const noexcept;
+    void used_index_set(uint64_t offset, uint64_t size) noexcept;
+    void used_index_erase(uint64_t offset) noexcept;
+    bool lookup_lock_free(uint64_t offset, uint64_t &size) const noexcept;
+
+    static int32_t slab_class_index(uint64_t aligned_size, uint64_t alignment) noexcept;
+    slab_span *slab_span_of(uint64_t offset) const noexcept;
+    void slab_span_publish(slab_span *span, slab_span *value) noexcept;
+    static bool slab_slot_used(const slab_span *span, uint64_t offset, uint64_t &slot_size) noexcept;
+    bool slab_allocate_in_lock(int32_t class_index, uint64_t &offset) noexcept;
+    slab_span *slab_new_span_in_lock(int32_t class_index) noexcept;
+    int32_t slab_release_in_lock(slab_span *span, uint64_t offset) noexcept;
+    void slab_free_span_in_lock(slab_span *span) noexcept;
+    bool slab_drain_empty_spans_in_lock() noexcept;
+    void slab_link_partial(slab_span *span) noexcept;
+    void slab_unlink_partial(slab_span *span) noexcept;
+
 private:
+    static constexpr uint64_t SLAB_GRANULE_SHIFT = 16UL;
+    static constexpr uint64_t SLAB_GRANULE_SIZE = 1UL << SLAB_GRANULE_SHIFT;
+    static constexpr uint64_t SLAB_MIN_SLOT_SHIFT = 6UL;
+    static constexpr uint64_t SLAB_MAX_SLOT_SHIFT = 16UL;
+    static constexpr uint64_t SLAB_MIN_SLOTS_PER_SPAN = 16UL;
+    static constexpr uint32_t SLAB_CLASS_NUM = SLAB_MAX_SLOT_SHIFT - SLAB_MIN_SLOT_SHIFT + 1U;
+    static constexpr uint32_t USED_INDEX_SHARD_NUM = 64U;
+    static constexpr uint32_t HEAP_STATS_MIN_ORDER = 6U;
+
     uint8_t *const base_;
     const uint64_t size_;
+    const bool slab_enabled_;
     mutable pthread_spinlock_t spinlock_{};
     std::map<uint64_t, uint64_t> address_idle_tree_;
     std::map<uint64_t, uint64_t> address_used_tree_;
     std::set<memory_range, range_size_first_comparator> size_idle_tree_;
+    slab_class slab_classes_[SLAB_CLASS_NUM];
+    // two-level radix tree, (offset >> SLAB_GRANULE_SHIFT) -> owning span, leaves are created on demand
+    std::vector<std::atomic<slab_radix_leaf *>> slab_radix_;
+    std::vector<std::unique_ptr<slab_span>> slab_span_storage_;
+    std::vector<slab_span *> slab_span_pool_;    // retired spans waiting for reuse
+    mutable used_block_shard used_index_[USED_INDEX_SHARD_NUM];
+    std::vector<void *> deferred_releases_;      // released at the next control barrier
+
+    // kept up to date by every tree and slab operation, heap_stats() never walks the trees
+    uint64_t used_bytes_{0};
+    uint64_t high_water_mark_{0};
+    uint64_t allocated_blocks_{0};
+    uint64_t slab_bytes_{0};
+    uint64_t free_block_histogram_[ACLSHMEM_HEAP_STATS_BUCKET_NUM]{};
 };
 
 #endif  // SHMEMI_HEAP_H
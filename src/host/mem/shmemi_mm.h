@@ -19,5 +19,6 @@
 
 int32_t memory_manager_initialize(void *base, uint64_t size, aclshmem_mem_type_t mem_type = DEVICE_SIDE);
 void memory_manager_destroy();
+void aclshmemi_flush_deferred_free();
 
 #endif  // ACLSHMEMI_MM_H
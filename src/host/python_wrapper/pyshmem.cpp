@@ -138,6 +138,10 @@ void DefineShmemAttr(py::module_ &m)
         .value("ROCE", ACLSHMEM_DATA_OP_ROCE)
         .value("UDMA", ACLSHMEM_DATA_OP_UDMA);
 
+    py::enum_<aclshmemx_store_topology_t>(m, "StoreTopology")
+        .value("FLAT", ACLSHMEMX_STORE_TOPOLOGY_FLAT)
+        .value("NODE_RELAY", ACLSHMEMX_STORE_TOPOLOGY_NODE_RELAY);
+
     py::class_<aclshmem_init_optional_attr_t>(m, "OptionalAttr")
         .def(py::init([]() {
             auto optional_attr = new (std::nothrow) aclshmem_init_optional_attr_t;
@@ -171,7 +175,8 @@ void DefineShmemAttr(py::module_ &m)
                             self.ip_port[copy_len] = '\0';
                         })
         .def_readwrite("local_mem_size", &aclshmemx_init_attr_t::local_mem_size)
-        .def_readwrite("option_attr", &aclshmemx_init_attr_t::option_attr);
+        .def_readwrite("option_attr", &aclshmemx_init_attr_t::option_attr)
+        .def_readwrite("store_topology", &aclshmemx_init_attr_t::store_topology);
 
     py::class_<aclshmem_team_config_t>(m, "TeamConfig")
         .def(py::init<>())
@@ -252,6 +257,27 @@ void DefineShmemMemType(py::module_ &m)
         .value("DEVICE_SIDE", DEVICE_SIDE);
 }
 
+void DefineShmemHeapStats(py::module_ &m)
+{
+    py::class_<aclshmemx_heap_stats_t>(m, "HeapStats")
+        .def(py::init([]() {
+            aclshmemx_heap_stats_t obj{};
+            return obj;
+        }))
+        .def_readonly("total_bytes", &aclshmemx_heap_stats_t::total_bytes)
+        .def_readonly("used_bytes", &aclshmemx_heap_stats_t::used_bytes)
+        .def_readonly("free_bytes", &aclshmemx_heap_stats_t::free_bytes)
+        .def_readonly("largest_free_block", &aclshmemx_heap_stats_t::largest_free_block)
+        .def_readonly("free_block_count", &aclshmemx_heap_stats_t::free_block_count)
+        .def_readonly("high_water_mark", &aclshmemx_heap_stats_t::high_water_mark)
+        .def_readonly("allocated_blocks", &aclshmemx_heap_stats_t::allocated_blocks)
+        .def_readonly("slab_bytes", &aclshmemx_heap_stats_t::slab_bytes)
+        .def_property_readonly("free_block_histogram", [](const aclshmemx_heap_stats_t &self) {
+            return std::vector<uint64_t>(self.free_block_histogram,
+                                         self.free_block_histogram + ACLSHMEM_HEAP_STATS_BUCKET_NUM);
+        });
+}
+
 PYBIND11_MODULE(_pyshmem, m)
 {
     DefineShmemAttr(m);
@@ -260,6 +286,7 @@ PYBIND11_MODULE(_pyshmem, m)
     DefineShmemSignalOp(m);
     DefineShmemCmpOp(m);
     DefineShmemMemType(m);
+    DefineShmemHeapStats(m);
 
     m.def("aclshmem_init", &shm::aclshmem_initialize, py::call_guard<py::gil_scoped_release>(), py::arg("attributes"), R"(
 Initialize share memory module.
@@ -441,6 +468,28 @@ Returns:
     Pointer to the start address of the symmetric memory heap, or 0 if not initialized.
     )");
 
+    m.def(
+        "aclshmemx_heap_stats",
+        [](py::object mem_type) {
+            aclshmem_mem_type_t mt = mem_type.is_none() ? DEVICE_SIDE : mem_type.cast<aclshmem_mem_type_t>();
+            aclshmemx_heap_stats_t stats{};
+            auto ret = aclshmemx_heap_stats(&stats, mt);
+            if (ret != 0) {
+                throw std::runtime_error("aclshmemx_heap_stats failed, ret: " + std::to_string(ret));
+            }
+            return stats;
+        },
+        py::arg("mem_type") = py::none(),
+        R"(
+Reads usage and fragmentation statistics of the local symmetric heap without walking it.
+
+Arguments:
+    mem_type(MemType): Allocation location of symmetric memory (MemType.HOST_SIDE / MemType.DEVICE_SIDE), default is MemType.DEVICE_SIDE
+Returns:
+    HeapStats with total_bytes, used_bytes, free_bytes, largest_free_block, free_block_count, high_water_mark,
+    allocated_blocks, slab_bytes and free_block_histogram (bucket i counts free blocks of [2^(i+6), 2^(i+7)) bytes).
+    )");
+
     m.def("my_pe", &aclshmem_my_pe, py::call_guard<py::gil_scoped_release>(), R"(Get my PE number.)");
 
     m.def(
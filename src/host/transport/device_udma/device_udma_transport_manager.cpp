@@ -804,8 +804,47 @@ Result UdmaTransportManager::ResolveRelaySlotRoute(
     return ACLSHMEM_SUCCESS;
 }
 
+Result UdmaTransportManager::ExchangePeerEndpointDescriptors(EndpointExchange& exchange) const
+{
+    // Peer p dials our endpoint on our local EID toward p, so that is the only descriptor p needs.
+    // The alltoall is collective: a missing descriptor leaves valid == 0 for that peer and fails after it.
+    Result local_ret = ACLSHMEM_SUCCESS;
+    std::vector<ExchangedEndpointDesc> send_descs(rank_count_);
+    for (const auto& peer_entry : peer_eid_index_map_) {
+        auto desc_it = endpoint_desc_map_.find(peer_entry.second);
+        if (peer_entry.first >= rank_count_ || desc_it == endpoint_desc_map_.end()) {
+            SHM_LOG_ERROR("No local hcomm endpoint descriptor for peer " << peer_entry.first << " on EID index "
+                                                                         << peer_entry.second);
+            local_ret = ACLSHMEM_INNER_ERROR;
+            continue;
+        }
+        ExchangedEndpointDesc& packed = send_descs[peer_entry.first];
+        packed.eid_index = peer_entry.second;
+        packed.valid = 1;
+        packed.desc = desc_it->second;
+    }
+
+    exchange.max_count = 1;
+    exchange.counts.assign(rank_count_, 1);
+    exchange.counts[rank_id_] = 0;
+    exchange.descs.assign(rank_count_, ExchangedEndpointDesc{});
+    auto ret = g_boot_handle.alltoall(
+        send_descs.data(), exchange.descs.data(), static_cast<int>(sizeof(ExchangedEndpointDesc)), &g_boot_handle);
+    if (ret != 0) {
+        SHM_LOG_ERROR("Alltoall of hcomm endpoint descriptors failed, ret = " << ret);
+        return ACLSHMEM_INNER_ERROR;
+    }
+    return local_ret;
+}
+
 Result UdmaTransportManager::ExchangeEndpointDescriptors(EndpointExchange& exchange) const
 {
+    if constexpr (!ACLSHMEM_UDMA_RELAY_ENABLED) {
+        if (g_boot_handle.alltoall != nullptr) {
+            return ExchangePeerEndpointDescriptors(exchange);
+        }
+    }
+
     const uint32_t local_endpoint_count = static_cast<uint32_t>(endpoint_desc_map_.size());
     exchange.counts.assign(rank_count_, 0);
     g_boot_handle.allgather(&local_endpoint_count, exchange.counts.data(), sizeof(uint32_t), &g_boot_handle);
@@ -1081,20 +1120,34 @@ bool UdmaTransportManager::PrepareOpenDevice(uint32_t device_id, uint32_t rank_c
         }
     }
 
-    std::vector<int32_t> all_route_by_peer(rank_count * rank_count, INVALID_EID_INDEX);
-    g_boot_handle.allgather(
-        local_route_by_peer.data(), all_route_by_peer.data(), sizeof(int32_t) * rank_count, &g_boot_handle);
-
-    if constexpr (ACLSHMEM_UDMA_RELAY_ENABLED) {
-        // Full N x N routing matrix; only the relay path needs it to resolve each slot's target EID.
-        all_local_routes_ = all_route_by_peer;
+    // remote_route_by_peer[p] is p's local route toward this rank.
+    std::vector<int32_t> remote_route_by_peer(rank_count, INVALID_EID_INDEX);
+    if (ACLSHMEM_UDMA_RELAY_ENABLED || g_boot_handle.alltoall == nullptr) {
+        std::vector<int32_t> all_route_by_peer(rank_count * rank_count, INVALID_EID_INDEX);
+        g_boot_handle.allgather(
+            local_route_by_peer.data(), all_route_by_peer.data(), sizeof(int32_t) * rank_count, &g_boot_handle);
+        for (uint32_t peer = 0; peer < rank_count; ++peer) {
+            remote_route_by_peer[peer] = all_route_by_peer[peer * rank_count + rank_id_];
+        }
+        if constexpr (ACLSHMEM_UDMA_RELAY_ENABLED) {
+            // Full N x N routing matrix; only the relay path needs it to resolve each slot's target EID.
+            all_local_routes_ = std::move(all_route_by_peer);
+        }
+    } else {
+        // Direct path only needs its column of the matrix.
+        ret = g_boot_handle.alltoall(
+            local_route_by_peer.data(), remote_route_by_peer.data(), sizeof(int32_t), &g_boot_handle);
+        if (ret != 0) {
+            SHM_LOG_ERROR("Alltoall of local EID routes failed, ret = " << ret);
+            return false;
+        }
     }
 
     for (uint32_t peer = 0; peer < rank_count; ++peer) {
         if (peer == rank_id_) {
             continue;
         }
-        int32_t remote_route = all_route_by_peer[peer * rank_count + rank_id_];
+        int32_t remote_route = remote_route_by_peer[peer];
         if (remote_route < 0 || static_cast<uint32_t>(remote_route) >= max_eid_count) {
             SHM_LOG_ERROR(
                 "Invalid remote EID route for peer rank "
@@ -86,6 +86,8 @@ private:
     bool PrepareOpenDevice(uint32_t device_id, uint32_t rank_count);
     // Allgather the local HCOMM endpoint descriptors into `exchange`.
     Result ExchangeEndpointDescriptors(EndpointExchange& exchange) const;
+    // Direct build only: alltoall each peer the single descriptor it connects to (max_count == 1).
+    Result ExchangePeerEndpointDescriptors(EndpointExchange& exchange) const;
     // Locate dst_pe's exchanged endpoint descriptor on remote_eid_index, or nullptr if absent.
     const ExchangedEndpointDesc* FindRemoteEndpointDesc(
         const EndpointExchange& exchange, uint32_t dst_pe, uint32_t remote_eid_index) const;
@@ -45,6 +45,9 @@ typedef struct aclshmemi_bootstrap_handle {
     int (*allgather)(const void *sendbuf, void *recvbuf, int size, aclshmemi_bootstrap_handle *boot_handle);
     int (*barrier)(aclshmemi_bootstrap_handle *boot_handle);
     int (*alltoall)(const void *sendbuf, void *recvbuf, int size, aclshmemi_bootstrap_handle *boot_handle);
+    // sendbuf/recvbuf中各PE的数据按PE序号紧密排列，第i块长度为send_sizes[i]/recv_sizes[i]
+    int (*alltoallv)(const void *sendbuf, const int *send_sizes, void *recvbuf, const int *recv_sizes,
+                     aclshmemi_bootstrap_handle *boot_handle);
     void (*global_exit)(int status, aclshmemi_bootstrap_handle *boot_handle);
     aclshmem_decrypt_handler decrypt_handler;
 
@@ -59,6 +62,7 @@ typedef struct aclshmemi_bootstrap_handle {
 
     bool is_bootstraped = false;
     bool use_attr_ipport = false;
+    bool store_relay = false;
     bool tls_enable = false;
 
     uint16_t session_magic = SHMEMI_DEFAULT_CONN_MAGIC;
@@ -248,7 +248,7 @@ def _import_bindings():
     from ._pyshmem import (  # noqa: E402
         aclshmem_init, aclshmem_get_unique_id, aclshmem_init_using_unique_id,
         aclshmem_finalize, aclshmem_malloc, aclshmem_free,
-        aclshmem_ptr, aclshmemx_get_heap_base, my_pe, pe_count, set_conf_store_tls_key, team_split_strided,
+        aclshmem_ptr, aclshmemx_get_heap_base, aclshmemx_heap_stats, HeapStats, my_pe, pe_count, set_conf_store_tls_key, team_split_strided,
         team_split_2d, team_translate_pe,
         team_destroy, InitAttr, OpEngineType,
         InitStatus, aclshmem_calloc, aclshmem_align, aclshmemx_init_status, get_ffts_config,
@@ -300,6 +300,8 @@ if _NATIVE_LOADED:
         'aclshmem_free',
         'aclshmem_ptr',
         'aclshmemx_get_heap_base',
+        'aclshmemx_heap_stats',
+        'HeapStats',
         'my_pe',
         'pe_count',
         'set_conf_store_tls_key',
@@ -15,7 +15,7 @@ import logging
 import shmem._pyshmem as _pyshmem
 from shmem.core.utils import Buffer, AclshmemError
 
-__all__ = ['buffer', 'free', 'get_peer_buffer']
+__all__ = ['buffer', 'free', 'get_peer_buffer', 'heap_stats']
 
 logger = logging.getLogger("aclshmem")
 
@@ -75,3 +75,39 @@ def get_peer_buffer(buf: Buffer, pe: int) -> Buffer:
 
     peer_buffer = Buffer(peer_addr, buf.length)
     return peer_buffer
+
+
+def heap_stats(mem_type=None) -> dict:
+    """
+    Get usage and fragmentation statistics of the local symmetric heap.
+
+    A request of ``size`` bytes can only succeed if ``size <= largest_free_block``. A ``free_bytes`` much larger than
+    ``largest_free_block`` means the heap is fragmented rather than exhausted.
+
+    Args:
+        mem_type (MemType, optional): ``MemType.DEVICE_SIDE`` (default) or ``MemType.HOST_SIDE``.
+
+    Returns:
+        dict: ``total_bytes``, ``used_bytes``, ``free_bytes``, ``largest_free_block``, ``free_block_count``,
+        ``high_water_mark``, ``allocated_blocks``, ``slab_bytes`` and ``free_block_histogram``, where bucket ``i``
+        counts free blocks of ``[2^(i+6), 2^(i+7))`` bytes.
+
+    Raises:
+        AclshmemError: If the heap is not initialized.
+    """
+    try:
+        stats = _pyshmem.aclshmemx_heap_stats(mem_type)
+    except RuntimeError as e:
+        raise AclshmemError("Get heap stats failed.") from e
+
+    return {
+        'total_bytes': stats.total_bytes,
+        'used_bytes': stats.used_bytes,
+        'free_bytes': stats.free_bytes,
+        'largest_free_block': stats.largest_free_block,
+        'free_block_count': stats.free_block_count,
+        'high_water_mark': stats.high_water_mark,
+        'allocated_blocks': stats.allocated_blocks,
+        'slab_bytes': stats.slab_bytes,
+        'free_block_histogram': list(stats.free_block_histogram),
+    }
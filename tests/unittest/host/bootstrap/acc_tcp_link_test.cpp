@@ -0,0 +1,385 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "acc_tcp_server.h"
+
+using shm::acc::AccConnReq;
+using shm::acc::AccDataBuffer;
+using shm::acc::AccTcpLinkComplexPtr;
+using shm::acc::AccTcpRequestContext;
+using shm::acc::AccTcpServer;
+using shm::acc::AccTcpServerPtr;
+
+static uint16_t link_find_free_port()
+{
+    int sockfd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (sockfd < 0) {
+        return 0;
+    }
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    if (::bind(sockfd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(sockfd);
+        return 0;
+    }
+    socklen_t len = sizeof(addr);
+    ::getsockname(sockfd, (struct sockaddr *)&addr, &len);
+    close(sockfd);
+    return ntohs(addr.sin_port);
+}
+
+// a listening server with the given request handler and a listener-less client connected to it
+class AccTcpLinkTest : public testing::Test {
+protected:
+    void Start(const std::function<int32_t(const AccTcpRequestContext &)> &serverHandler,
+               const std::function<int32_t(const AccTcpRequestContext &)> &clientHandler)
+    {
+        auto port = link_find_free_port();
+        ASSERT_NE(0, port);
+        auto linkHandler = [](const AccConnReq &, const AccTcpLinkComplexPtr &) { return 0; };
+        auto brokenHandler = [](const AccTcpLinkComplexPtr &) { return 0; };
+
+        server_ = AccTcpServer::Create();
+        ASSERT_TRUE(server_ != nullptr);
+        server_->RegisterNewRequestHandler(0, serverHandler);
+        server_->RegisterNewLinkHandler(linkHandler);
+        server_->RegisterLinkBrokenHandler(brokenHandler);
+        shm::acc::AccTcpServerOptions options;
+        options.listenIp = "127.0.0.1";
+        options.listenPort = port;
+        options.enableListener = true;
+        options.workerCount = serverWorkers_;
+        options.acceptorCount = acceptors_;
+        options.linkSendQueueSize = QUEUE_SIZE;
+        options.workerBusyPollUs = busyPollUs_;
+        ASSERT_EQ(0, server_->Start(options));
+        port_ = port;
+
+        client_ = AccTcpServer::Create();
+        ASSERT_TRUE(client_ != nullptr);
+        client_->RegisterNewRequestHandler(0, clientHandler);
+        client_->RegisterLinkBrokenHandler(brokenHandler);
+        shm::acc::AccTcpServerOptions clientOptions;
+        clientOptions.linkSendQueueSize = QUEUE_SIZE;
+        clientOptions.workerBusyPollUs = busyPollUs_;
+        ASSERT_EQ(0, client_->Start(clientOptions));
+        AccConnReq req;
+        req.rankId = 1;
+        ASSERT_EQ(0, client_->ConnectToPeerServer("127.0.0.1", port, req, 100U, link_));
+    }
+
+    void TearDown() override
+    {
+        link_ = nullptr;
+        if (client_ != nullptr) {
+            client_->Stop();
+        }
+        if (server_ != nullptr) {
+            server_->Stop();
+        }
+    }
+
+    // retries while the send queue is full, like a producer outrunning the socket does
+    void Send(uint32_t seqNo, const shm::acc::AccDataBufferPtr &data)
+    {
+        while (link_->NonBlockSend(0, seqNo, data, nullptr) == shm::acc::ACC_QUEUE_IS_FULL) {
+            std::this_thread::yield();
+        }
+    }
+
+    // the server echoes every request back, the client counts the echoes
+    void StartEcho()
+    {
+        Start(
+            [](const AccTcpRequestContext &context) {
+                (void)context.Reply(0, AccDataBuffer::Create(context.DataPtr(), context.DataLen()));
+                return 0;
+            },
+            [this](const AccTcpRequestContext &) {
+                replied_++;
+                return 0;
+            });
+    }
+
+    // one request at a time in mixed sizes, created and released on different threads
+    void EchoRoundTrips(uint32_t rounds)
+    {
+        const uint32_t sizes[] = {16U, 200U, 3000U, 40000U};
+        std::vector<char> payload(40000U, 0);
+        for (uint32_t i = 0; i < rounds; i++, sent_++) {
+            auto size = sizes[i % (sizeof(sizes) / sizeof(sizes[0]))];
+            ASSERT_EQ(0, link_->NonBlockSend(0, sent_, AccDataBuffer::Create(payload.data(), size), nullptr));
+            while (replied_.load() <= sent_) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    static constexpr uint16_t QUEUE_SIZE = 128U;
+    uint32_t busyPollUs_ = 0;
+    uint16_t serverWorkers_ = 1U;
+    uint16_t acceptors_ = 1U;
+    uint16_t port_ = 0;
+    AccTcpServerPtr server_;
+    AccTcpServerPtr client_;
+    AccTcpLinkComplexPtr link_;
+    std::atomic<uint32_t> replied_{0};
+    uint32_t sent_ = 0;
+};
+
+TEST_F(AccTcpLinkTest, stream_keeps_order_across_partial_writes)
+{
+    // mixed sizes, the large ones overflow the socket buffer and leave batches partially written
+    constexpr uint32_t count = 20000U;
+    const uint32_t sizes[] = {16U, 64U, 1500U, 5U, 256U * 1024U};
+    std::atomic<uint32_t> received{0};
+    std::atomic<uint32_t> failures{0};
+    Start(
+        [&](const AccTcpRequestContext &context) {
+            uint32_t index = received.load();
+            uint32_t head = 0;
+            auto expectSize = sizes[index % (sizeof(sizes) / sizeof(sizes[0]))];
+            std::memcpy(&head, context.DataPtr(), sizeof(head));
+            auto tail = static_cast<uint8_t *>(context.DataPtr())[context.DataLen() - 1U];
+            if (context.SeqNo() != index || head != index || context.DataLen() != expectSize ||
+                tail != static_cast<uint8_t>(index)) {
+                failures++;
+            }
+            received++;
+            return 0;
+        },
+        [](const AccTcpRequestContext &) { return 0; });
+    ASSERT_TRUE(link_ != nullptr);
+
+    for (uint32_t i = 0; i < count; i++) {
+        auto size = sizes[i % (sizeof(sizes) / sizeof(sizes[0]))];
+        auto data = AccDataBuffer::Create(size);
+        ASSERT_TRUE(data != nullptr);
+        std::memset(data->DataPtrVoid(), 0, size);
+        std::memcpy(data->DataPtrVoid(), &i, sizeof(i));
+        static_cast<uint8_t *>(data->DataPtrVoid())[size - 1U] = static_cast<uint8_t>(i);
+        data->SetDataSize(size);
+        Send(i, data);
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+    while (received.load() < count && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(count, received.load());
+    EXPECT_EQ(0U, failures.load());
+}
+
+TEST_F(AccTcpLinkTest, pipelined_requests_are_all_answered_in_order)
+{
+    // a burst of small requests lands in few receive calls, every one of them still gets its own reply
+    constexpr uint32_t count = 50000U;
+    std::atomic<uint32_t> replied{0};
+    std::atomic<uint32_t> failures{0};
+    Start(
+        [](const AccTcpRequestContext &context) {
+            (void)context.Reply(0, AccDataBuffer::Create(context.DataPtr(), context.DataLen()));
+            return 0;
+        },
+        [&replied, &failures](const AccTcpRequestContext &context) {
+            uint32_t index = 0;
+            std::memcpy(&index, context.DataPtr(), sizeof(index));
+            if (context.SeqNo() != replied.load() || index != replied.load()) {
+                failures++;
+            }
+            replied++;
+            return 0;
+        });
+    ASSERT_TRUE(link_ != nullptr);
+
+    for (uint32_t i = 0; i < count; i++) {
+        char payload[24U] = {};
+        std::memcpy(payload, &i, sizeof(i));
+        Send(i, AccDataBuffer::Create(payload, sizeof(payload)));
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+    while (replied.load() < count && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(count, replied.load());
+    EXPECT_EQ(0U, failures.load());
+}
+
+TEST_F(AccTcpLinkTest, buffers_are_recycled_after_warm_up)
+{
+    StartEcho();
+    ASSERT_TRUE(link_ != nullptr);
+    // the caches of every thread fill up during the warm-up
+    EchoRoundTrips(5000U);
+
+    constexpr uint32_t rounds = 5000U;
+    auto before = AccTcpServer::BufferPoolStats();
+    EchoRoundTrips(rounds);
+    auto after = AccTcpServer::BufferPoolStats();
+
+    auto allocs = after.allocCount - before.allocCount;
+    auto heapAllocs = after.heapAllocCount - before.heapAllocCount;
+    // blocks piling up in the cache of a releasing thread make its allocating peer go to the heap now and then
+    EXPECT_GE(allocs, rounds * 2U);
+    EXPECT_LE(heapAllocs, allocs / 20U);
+}
+
+TEST_F(AccTcpLinkTest, cached_buffers_are_dropped_when_the_last_server_stops)
+{
+    StartEcho();
+    ASSERT_TRUE(link_ != nullptr);
+    EchoRoundTrips(100U);
+    EXPECT_GT(AccTcpServer::BufferPoolStats().cachedBytes, 0U);
+
+    TearDown();
+    auto stats = AccTcpServer::BufferPoolStats();
+    EXPECT_EQ(0U, stats.cachedBytes);
+    EXPECT_EQ(0U, stats.cachedBuffers);
+
+    // nothing is cached while no server runs
+    std::vector<char> payload(3000U, 0);
+    (void)AccDataBuffer::Create(payload.data(), payload.size());
+    EXPECT_EQ(0U, AccTcpServer::BufferPoolStats().cachedBytes);
+}
+
+TEST_F(AccTcpLinkTest, busy_poll_round_trips_are_counted)
+{
+    // workers spin for a while after each event instead of sleeping in epoll
+    busyPollUs_ = 50000U;
+    std::atomic<uint32_t> replied{0};
+    Start(
+        [](const AccTcpRequestContext &context) {
+            (void)context.Reply(0, AccDataBuffer::Create(context.DataPtr(), context.DataLen()));
+            return 0;
+        },
+        [&replied](const AccTcpRequestContext &) {
+            replied++;
+            return 0;
+        });
+    ASSERT_TRUE(link_ != nullptr);
+
+    constexpr uint32_t rounds = 1000U;
+    char payload[64U] = {};
+    for (uint32_t i = 0; i < rounds; i++) {
+        ASSERT_EQ(0, link_->NonBlockSend(0, i, AccDataBuffer::Create(payload, sizeof(payload)), nullptr));
+        while (replied.load() <= i) {
+            std::this_thread::yield();
+        }
+    }
+
+    auto serverStats = server_->WorkerStats();
+    ASSERT_EQ(1U, serverStats.size());
+    EXPECT_GE(serverStats[0].events, rounds);
+    EXPECT_GT(serverStats[0].wakeups, 0U);
+    EXPECT_GT(serverStats[0].busyPolls, 0U);
+    EXPECT_GE(serverStats[0].pollBatch, 16U);
+}
+
+// opens the given number of raw connections at once and reads the handshake response of each
+static uint32_t link_connect_storm(uint16_t port, uint32_t count, std::vector<int> &fds)
+{
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    AccConnReq req;
+    for (uint32_t i = 0; i < count; i++) {
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            break;
+        }
+        fds.push_back(fd);
+        req.rankId = i;
+        if (::connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+            ::send(fd, &req, sizeof(req), 0) != sizeof(req)) {
+            break;
+        }
+    }
+
+    uint32_t accepted = 0;
+    for (auto fd : fds) {
+        shm::acc::AccConnResp resp;
+        resp.result = -1;
+        if (::recv(fd, &resp, sizeof(resp), MSG_WAITALL) == sizeof(resp) && resp.result == 0) {
+            accepted++;
+        }
+    }
+    return accepted;
+}
+
+static uint32_t link_total(const std::vector<shm::acc::AccWorkerStats> &stats)
+{
+    uint32_t total = 0;
+    for (auto &item : stats) {
+        total += item.links;
+    }
+    return total;
+}
+
+TEST_F(AccTcpLinkTest, connection_storm_is_balanced_over_workers)
+{
+    // thousands of ranks connecting at once, taken by several SO_REUSEPORT acceptors
+    serverWorkers_ = 4U;
+    acceptors_ = 4U;
+    Start([](const AccTcpRequestContext &) { return 0; }, [](const AccTcpRequestContext &) { return 0; });
+    ASSERT_TRUE(link_ != nullptr);
+
+    constexpr uint32_t threadCount = 8U;
+    constexpr uint32_t perThread = 250U;
+    std::atomic<uint32_t> accepted{0};
+    std::vector<std::vector<int>> fds(threadCount);
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < threadCount; i++) {
+        threads.emplace_back([&, i]() { accepted += link_connect_storm(port_, perThread, fds[i]); });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(threadCount * perThread, accepted.load());
+
+    // the fixture client holds one more link
+    auto stats = server_->WorkerStats();
+    ASSERT_EQ(4U, stats.size());
+    EXPECT_EQ(threadCount * perThread + 1U, link_total(stats));
+    uint32_t minLinks = UINT32_MAX;
+    uint32_t maxLinks = 0;
+    for (auto &item : stats) {
+        minLinks = std::min(minLinks, item.links);
+        maxLinks = std::max(maxLinks, item.links);
+    }
+    EXPECT_LE(maxLinks - minLinks, 1U);
+
+    // closed links leave the workers
+    for (auto &items : fds) {
+        for (auto fd : items) {
+            close(fd);
+        }
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (link_total(server_->WorkerStats()) > 1U && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(1U, link_total(server_->WorkerStats()));
+}
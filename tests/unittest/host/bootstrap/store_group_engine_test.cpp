@@ -0,0 +1,331 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "store_factory.h"
+#include "store_net_group_engine.h"
+
+// every rank is a thread with its own client store, rank 0 also hosts the server like init_config_store does
+static uint16_t group_find_free_port()
+{
+    int sockfd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (sockfd < 0) {
+        return 0;
+    }
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    if (::bind(sockfd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(sockfd);
+        return 0;
+    }
+    socklen_t len = sizeof(addr);
+    ::getsockname(sockfd, (struct sockaddr *)&addr, &len);
+    close(sockfd);
+    return ntohs(addr.sin_port);
+}
+
+static uint8_t group_pattern(uint32_t src, uint32_t dst, uint32_t i)
+{
+    return static_cast<uint8_t>(src * 31U + dst * 7U + i);
+}
+
+static uint32_t group_block_size(uint32_t src, uint32_t dst)
+{
+    // zero sized blocks included
+    return (src * 3U + dst) % 5U * 9U;
+}
+
+static void run_group_ranks(uint32_t rank_size, const std::function<void(shm::store::SmemGroupEnginePtr &)> &body,
+                            const std::vector<uint32_t> &node_of_rank = {})
+{
+    const std::string ip = "127.0.0.1";
+    auto port = group_find_free_port();
+    ASSERT_NE(0, port);
+    shm::store::StoreFactory::SetTlsInfo(false, nullptr, 0);
+
+    std::vector<shm::store::StorePtr> stores;
+    stores.push_back(shm::store::StoreFactory::CreateStore(ip, port, true, 0, -1, -1, 0));
+    ASSERT_TRUE(stores.back() != nullptr);
+    for (uint32_t rank = 1; rank < rank_size; rank++) {
+        stores.push_back(shm::store::StoreFactory::CreateStore(ip, port, false, rank, -1, -1, 0));
+        ASSERT_TRUE(stores.back() != nullptr);
+    }
+
+    std::vector<std::thread> threads;
+    for (uint32_t rank = 0; rank < rank_size; rank++) {
+        threads.emplace_back([&stores, &body, &node_of_rank, rank, rank_size]() {
+            auto prefix = shm::store::StoreFactory::PrefixStore(stores[rank], "GROUP_TEST_");
+            shm::store::SmemGroupOption opt = {rank_size, rank, 10000U, false, nullptr, nullptr};
+            auto group = shm::store::SmemNetGroupEngine::Create(prefix, opt);
+            ASSERT_TRUE(group != nullptr);
+            if (!node_of_rank.empty()) {
+                ASSERT_EQ(0, group->StartNodeRelay(node_of_rank, 0));
+            }
+            body(group);
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    stores.clear();
+    shm::store::StoreFactory::DestroyStore();
+}
+
+TEST(StoreGroupEngineTest, alltoall_delivers_only_own_blocks)
+{
+    constexpr uint32_t rank_size = 5U;
+    constexpr uint32_t block = 48U;
+    std::atomic<uint32_t> failures{0};
+    run_group_ranks(rank_size, [&failures](shm::store::SmemGroupEnginePtr &group) {
+        uint32_t rank = group->GetLocalRank();
+        for (uint32_t round = 0; round < 3U; round++) {
+            std::vector<char> send(rank_size * block);
+            std::vector<char> recv(rank_size * block, 0);
+            for (uint32_t dst = 0; dst < rank_size; dst++) {
+                for (uint32_t i = 0; i < block; i++) {
+                    send[dst * block + i] = static_cast<char>(group_pattern(rank, dst, i + round));
+                }
+            }
+            if (group->GroupAllToAll(send.data(), block, recv.data()) != 0) {
+                failures++;
+                continue;
+            }
+            for (uint32_t src = 0; src < rank_size; src++) {
+                for (uint32_t i = 0; i < block; i++) {
+                    if (static_cast<uint8_t>(recv[src * block + i]) != group_pattern(src, rank, i + round)) {
+                        failures++;
+                    }
+                }
+            }
+        }
+    });
+    EXPECT_EQ(0U, failures.load());
+}
+
+TEST(StoreGroupEngineTest, alltoallv_handles_uneven_and_empty_blocks)
+{
+    constexpr uint32_t rank_size = 4U;
+    std::atomic<uint32_t> failures{0};
+    run_group_ranks(rank_size, [&failures](shm::store::SmemGroupEnginePtr &group) {
+        uint32_t rank = group->GetLocalRank();
+        std::vector<uint32_t> send_sizes(rank_size);
+        std::vector<uint32_t> recv_sizes(rank_size);
+        std::vector<char> send;
+        uint32_t recv_total = 0;
+        for (uint32_t peer = 0; peer < rank_size; peer++) {
+            send_sizes[peer] = group_block_size(rank, peer);
+            recv_sizes[peer] = group_block_size(peer, rank);
+            recv_total += recv_sizes[peer];
+            for (uint32_t i = 0; i < send_sizes[peer]; i++) {
+                send.push_back(static_cast<char>(group_pattern(rank, peer, i)));
+            }
+        }
+        std::vector<char> recv(recv_total + 1U, 0);
+        send.push_back(0);
+        if (group->GroupAllToAllV(send.data(), send_sizes.data(), recv.data(), recv_sizes.data()) != 0) {
+            failures++;
+            return;
+        }
+        uint32_t offset = 0;
+        for (uint32_t src = 0; src < rank_size; src++) {
+            for (uint32_t i = 0; i < recv_sizes[src]; i++) {
+                if (static_cast<uint8_t>(recv[offset + i]) != group_pattern(src, rank, i)) {
+                    failures++;
+                }
+            }
+            offset += recv_sizes[src];
+        }
+        // a barrier after alltoallv still lines up, the sequence numbers did not diverge
+        if (group->GroupBarrier() != 0) {
+            failures++;
+        }
+    });
+    EXPECT_EQ(0U, failures.load());
+}
+
+TEST(StoreGroupEngineTest, allgather_places_blocks_in_rank_order)
+{
+    constexpr uint32_t rank_size = 6U;
+    std::atomic<uint32_t> failures{0};
+    run_group_ranks(rank_size, [&failures](shm::store::SmemGroupEnginePtr &group) {
+        uint32_t rank = group->GetLocalRank();
+        // several rounds of different sizes, every round is a fresh server side gather
+        for (uint32_t block : {1U, 64U, 4096U}) {
+            std::vector<char> send(block);
+            std::vector<char> recv(rank_size * block, 0);
+            for (uint32_t i = 0; i < block; i++) {
+                send[i] = static_cast<char>(group_pattern(rank, 0U, i));
+            }
+            if (group->GroupAllGather(send.data(), block, recv.data(), rank_size * block) != 0) {
+                failures++;
+                continue;
+            }
+            for (uint32_t src = 0; src < rank_size; src++) {
+                for (uint32_t i = 0; i < block; i++) {
+                    if (static_cast<uint8_t>(recv[src * block + i]) != group_pattern(src, 0U, i)) {
+                        failures++;
+                    }
+                }
+            }
+        }
+    });
+    EXPECT_EQ(0U, failures.load());
+}
+
+TEST(StoreGroupEngineTest, node_relay_keeps_barrier_and_allgather_results)
+{
+    // uneven nodes whose ranks are interleaved, node 2 has a single rank and talks to the root by itself
+    const std::vector<uint32_t> node_of_rank = {0U, 1U, 0U, 1U, 0U, 0U, 1U, 2U};
+    const auto rank_size = static_cast<uint32_t>(node_of_rank.size());
+    std::atomic<uint32_t> failures{0};
+    std::atomic<uint32_t> arrived{0};
+    run_group_ranks(rank_size, [&failures, &arrived, rank_size](shm::store::SmemGroupEnginePtr &group) {
+        uint32_t rank = group->GetLocalRank();
+        for (uint32_t round = 0; round < 3U; round++) {
+            // nobody leaves a barrier before everybody entered it
+            arrived++;
+            if (group->GroupBarrier() != 0 || arrived.load() < rank_size * (round + 1U)) {
+                failures++;
+            }
+            for (uint32_t block : {1U, 64U, 4096U}) {
+                std::vector<char> send(block);
+                std::vector<char> recv(rank_size * block, 0);
+                for (uint32_t i = 0; i < block; i++) {
+                    send[i] = static_cast<char>(group_pattern(rank, round, i));
+                }
+                if (group->GroupAllGather(send.data(), block, recv.data(), rank_size * block) != 0) {
+                    failures++;
+                    continue;
+                }
+                for (uint32_t src = 0; src < rank_size; src++) {
+                    for (uint32_t i = 0; i < block; i++) {
+                        if (static_cast<uint8_t>(recv[src * block + i]) != group_pattern(src, round, i)) {
+                            failures++;
+                        }
+                    }
+                }
+            }
+            if (group->GroupBarrier() != 0) {
+                failures++;
+            }
+        }
+        // alltoall keeps using the root store
+        std::vector<char> send(rank_size * 4U, static_cast<char>(rank));
+        std::vector<char> recv(rank_size * 4U, 0);
+        if (group->GroupAllToAll(send.data(), 4U, recv.data()) != 0) {
+            failures++;
+        }
+        for (uint32_t src = 0; src < rank_size; src++) {
+            if (recv[src * 4U] != static_cast<char>(src)) {
+                failures++;
+            }
+        }
+    }, node_of_rank);
+    EXPECT_EQ(0U, failures.load());
+}
+
+static uint32_t group_alltoall_failures(shm::store::SmemGroupEnginePtr &group, uint32_t rank_size, uint32_t round)
+{
+    constexpr uint32_t block = 16U;
+    uint32_t rank = group->GetLocalRank();
+    std::vector<char> send(rank_size * block);
+    std::vector<char> recv(rank_size * block, 0);
+    for (uint32_t dst = 0; dst < rank_size; dst++) {
+        for (uint32_t i = 0; i < block; i++) {
+            send[dst * block + i] = static_cast<char>(group_pattern(rank, dst, i + round));
+        }
+    }
+    if (group->GetRankSize() != rank_size || group->GroupAllToAll(send.data(), block, recv.data()) != 0) {
+        return 1U;
+    }
+    uint32_t failures = 0;
+    for (uint32_t src = 0; src < rank_size; src++) {
+        for (uint32_t i = 0; i < block; i++) {
+            if (static_cast<uint8_t>(recv[src * block + i]) != group_pattern(src, rank, i + round)) {
+                failures++;
+            }
+        }
+    }
+    return failures;
+}
+
+TEST(StoreGroupEngineTest, alltoall_after_a_rank_joins)
+{
+    // the members run alltoall before the last rank joins, after the version bump everybody starts over at the same sn
+    constexpr uint32_t rank_size = 3U;
+    const std::string ip = "127.0.0.1";
+    auto port = group_find_free_port();
+    ASSERT_NE(0, port);
+    shm::store::StoreFactory::SetTlsInfo(false, nullptr, 0);
+    std::vector<shm::store::StorePtr> stores;
+    stores.push_back(shm::store::StoreFactory::CreateStore(ip, port, true, 0, -1, -1, 0));
+    ASSERT_TRUE(stores.back() != nullptr);
+    for (uint32_t rank = 1; rank < rank_size; rank++) {
+        stores.push_back(shm::store::StoreFactory::CreateStore(ip, port, false, rank, -1, -1, 0));
+        ASSERT_TRUE(stores.back() != nullptr);
+    }
+
+    // a joiner reads the group size before the members have seen its event, so it waits for them in its callback
+    std::atomic<uint32_t> seen{0};
+    std::vector<shm::store::SmemGroupEnginePtr> groups;
+    for (uint32_t rank = 0; rank < rank_size; rank++) {
+        auto on_join = [&seen, rank](uint32_t joiner) -> int32_t {
+            if (joiner != rank) {
+                seen++;
+                return 0;
+            }
+            while (seen.load() < rank * (rank - 1U) / 2U) {
+                std::this_thread::yield();
+            }
+            return 0;
+        };
+        auto prefix = shm::store::StoreFactory::PrefixStore(stores[rank], "GROUP_TEST_");
+        shm::store::SmemGroupOption opt = {1U, rank, 2000U, true, on_join, nullptr};
+        groups.push_back(shm::store::SmemNetGroupEngine::Create(prefix, opt));
+        ASSERT_TRUE(groups.back() != nullptr);
+    }
+
+    std::atomic<uint32_t> failures{0};
+    auto run_alltoall = [&groups, &failures](uint32_t members, uint32_t round) {
+        std::vector<std::thread> threads;
+        for (uint32_t rank = 0; rank < members; rank++) {
+            threads.emplace_back([&groups, &failures, rank, members, round]() {
+                failures += group_alltoall_failures(groups[rank], members, round);
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    };
+    ASSERT_EQ(0, groups[0]->GroupJoin());
+    ASSERT_EQ(0, groups[1]->GroupJoin());
+    run_alltoall(2U, 0U);
+    run_alltoall(2U, 1U);
+    ASSERT_EQ(0, groups[2]->GroupJoin());
+    run_alltoall(3U, 2U);
+    EXPECT_EQ(0U, failures.load());
+
+    groups.clear();
+    stores.clear();
+    shm::store::StoreFactory::DestroyStore();
+}
@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "store_message_packer.h"
+
+using shm::store::MessageType;
+using shm::store::SmemMessage;
+using shm::store::SmemMessagePacker;
+using shm::store::SmemMessageView;
+
+TEST(StoreMessagePackerTest, view_and_owning_paths_agree)
+{
+    SmemMessage message{MessageType::CAS};
+    message.userDef = 42;
+    message.keys = {"key_0", ""};
+    message.values = {{1, 2, 3}, {}, std::vector<uint8_t>(4096, 7)};
+
+    // packing a view writes exactly the bytes the owning packer does
+    auto packed = SmemMessagePacker::Pack(message);
+    SmemMessageView view{message};
+    ASSERT_EQ(packed.size(), SmemMessagePacker::PackedSize(view));
+    auto buffer = SmemMessagePacker::PackBuffer(view);
+    ASSERT_TRUE(buffer != nullptr);
+    ASSERT_EQ(packed.size(), buffer->DataLen());
+    EXPECT_EQ(packed, std::vector<uint8_t>(buffer->DataPtr(), buffer->DataPtr() + buffer->DataLen()));
+
+    // the unpacked view points into the packed bytes
+    SmemMessageView unpacked;
+    ASSERT_EQ(static_cast<int64_t>(packed.size()), SmemMessagePacker::UnpackView(packed.data(), packed.size(), unpacked));
+    EXPECT_EQ(MessageType::CAS, unpacked.mt);
+    EXPECT_EQ(42, unpacked.userDef);
+    ASSERT_EQ(2U, unpacked.keys.size());
+    EXPECT_EQ("key_0", unpacked.keys[0]);
+    EXPECT_TRUE(unpacked.keys[1].empty());
+    ASSERT_EQ(3U, unpacked.values.size());
+    for (size_t i = 0; i < message.values.size(); i++) {
+        EXPECT_EQ(message.values[i], unpacked.values[i].ToVector());
+    }
+    EXPECT_GE(unpacked.values[2].data, packed.data());
+    EXPECT_LT(unpacked.values[2].data, packed.data() + packed.size());
+
+    SmemMessage copied;
+    ASSERT_EQ(static_cast<int64_t>(packed.size()), SmemMessagePacker::Unpack(packed.data(), packed.size(), copied));
+    EXPECT_EQ(message.keys, copied.keys);
+    EXPECT_EQ(message.values, copied.values);
+
+    // truncated or inconsistent input is rejected instead of read past
+    for (size_t len : {packed.size() - 1U, packed.size() / 2U, static_cast<size_t>(8U)}) {
+        SmemMessageView partial;
+        EXPECT_LT(SmemMessagePacker::UnpackView(packed.data(), len, partial), 0) << "len=" << len;
+    }
+    auto corrupted = packed;
+    corrupted[0]++;
+    corrupted.push_back(0);
+    SmemMessageView bad;
+    EXPECT_LT(SmemMessagePacker::UnpackView(corrupted.data(), corrupted.size(), bad), 0);
+}
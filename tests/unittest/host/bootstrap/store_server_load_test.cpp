@@ -0,0 +1,343 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "store_factory.h"
+#include "store_tcp_config_server.h"
+
+// synthetic SET/GET/ADD load from several client links against one AccStoreServer
+static uint16_t load_find_free_port()
+{
+    int sockfd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (sockfd < 0) {
+        return 0;
+    }
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    if (::bind(sockfd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(sockfd);
+        return 0;
+    }
+    socklen_t len = sizeof(addr);
+    ::getsockname(sockfd, (struct sockaddr *)&addr, &len);
+    close(sockfd);
+    return ntohs(addr.sin_port);
+}
+
+class StoreServerLoadTest : public ::testing::Test {
+protected:
+    void StartServer(uint32_t shards, uint16_t workers)
+    {
+        port_ = load_find_free_port();
+        ASSERT_NE(0, port_);
+        shm::store::StoreFactory::SetTlsInfo(false, nullptr, 0);
+        server_ = shm::store::SmMakeRef<shm::store::AccStoreServer>(ip_, port_, -1, 0, shards, workers);
+        ASSERT_TRUE(server_ != nullptr);
+        AcclinkTlsOption tlsOption;
+        tlsOption.enableTls = false;
+        ASSERT_EQ(0, server_->Startup(tlsOption));
+    }
+
+    shm::store::StorePtr Connect(int32_t rank)
+    {
+        return shm::store::StoreFactory::CreateStore(ip_, port_, false, rank, -1, -1, 0);
+    }
+
+    // SET, GET and ADD in equal parts, every client on its own keys plus one shared counter, returns the failures
+    int RunOps(uint32_t shards, int clients, int opsPerClient)
+    {
+        StartServer(shards, shm::store::AccStoreServer::DEFAULT_WORKER_COUNT);
+        if (server_ == nullptr) {
+            return clients;
+        }
+        std::vector<shm::store::StorePtr> stores;
+        for (int rank = 0; rank < clients; rank++) {
+            stores.push_back(Connect(rank));
+            if (stores.back() == nullptr) {
+                return clients;
+            }
+        }
+
+        std::atomic<int> failures{0};
+        std::vector<std::thread> threads;
+        for (int rank = 0; rank < clients; rank++) {
+            threads.emplace_back([&stores, &failures, rank, opsPerClient]() {
+                int64_t counter = 0;
+                std::string value;
+                for (int i = 0; i < opsPerClient / 3; i++) {
+                    auto key = "load_" + std::to_string(rank) + "_" + std::to_string(i);
+                    if (stores[rank]->Set(key, key) != 0 || stores[rank]->Get(key, value, 0) != 0 || value != key ||
+                        stores[rank]->Add("load_counter", 1, counter) != 0) {
+                        failures++;
+                    }
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        stores.clear();
+        server_->Shutdown();
+        server_ = nullptr;
+        return failures.load();
+    }
+
+    // every store enters the given rounds of one barrier key, returns the failures
+    static int RunBarriers(const std::vector<shm::store::StorePtr> &stores, int rounds)
+    {
+        std::atomic<int> failures{0};
+        std::vector<std::thread> threads;
+        for (auto &store : stores) {
+            threads.emplace_back([&store, &failures, rounds, size = static_cast<uint32_t>(stores.size())]() {
+                for (int i = 0; i < rounds; i++) {
+                    if (store->Barrier("barrier", size, 5000) != 0) {
+                        failures++;
+                    }
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        return failures.load();
+    }
+
+    void TearDown() override
+    {
+        if (server_ != nullptr) {
+            server_->Shutdown();
+            server_ = nullptr;
+        }
+        shm::store::StoreFactory::DestroyStore();
+    }
+
+    const std::string ip_ = "127.0.0.1";
+    uint16_t port_ = 0;
+    shm::store::AccStoreServerPtr server_;
+};
+
+TEST_F(StoreServerLoadTest, waiters_and_timeouts_across_shards)
+{
+    StartServer(8U, 2U);
+    auto setter = Connect(1);
+    auto getter = Connect(2);
+    ASSERT_TRUE(setter != nullptr && getter != nullptr);
+
+    // blocking GETs on keys spread over every shard are woken by the SET on the same key
+    constexpr int keys = 32;
+    std::atomic<int> woken{0};
+    std::thread waiter([&getter, &woken]() {
+        for (int i = 0; i < keys; i++) {
+            std::string value;
+            if (getter->Get("wait_" + std::to_string(i), value, 5000) == 0 && value == std::to_string(i)) {
+                woken++;
+            }
+        }
+    });
+    for (int i = 0; i < keys; i++) {
+        EXPECT_EQ(0, setter->Set("wait_" + std::to_string(i), std::to_string(i)));
+    }
+    waiter.join();
+    EXPECT_EQ(keys, woken.load());
+
+    // the timer thread expires waiters in every shard
+    std::string value;
+    EXPECT_NE(0, getter->Get("never_set", value, 50));
+}
+
+TEST_F(StoreServerLoadTest, concurrent_ops_across_shard_counts)
+{
+    for (uint32_t shards : {1U, 4U, 16U}) {
+        EXPECT_EQ(0, RunOps(shards, 8, 300));
+    }
+}
+
+TEST_F(StoreServerLoadTest, barrier_releases_all_and_drops_key)
+{
+    StartServer(4U, 2U);
+    constexpr int clients = 4;
+    std::vector<shm::store::StorePtr> stores;
+    for (int rank = 0; rank < clients; rank++) {
+        stores.push_back(Connect(rank));
+        ASSERT_TRUE(stores.back() != nullptr);
+    }
+
+    // the same key every round: a released barrier must not leave anything behind on the server
+    EXPECT_EQ(0, RunBarriers(stores, 200));
+
+    // a different size on a pending barrier is rejected, the pending one times out.
+    // a barrier of one passes without a trace while no other is pending, and is rejected once one is
+    auto pending = std::async(std::launch::async, [&stores]() { return stores[0]->Barrier("partial", 2U, 200); });
+    for (int i = 0; i < 10000 && stores[1]->Barrier("partial", 1U, 5000) == 0; i++) {
+        std::this_thread::yield();
+    }
+    EXPECT_NE(0, stores[1]->Barrier("partial", 3U, 5000));
+    EXPECT_NE(0, pending.get());
+    // the client gives up about when the server does, wait for the server to expire its waiter first
+    for (int i = 0; i < 10000 && stores[1]->Barrier("partial", 1U, 5000) != 0; i++) {
+        std::this_thread::yield();
+    }
+
+    // the timed out barrier is dropped with its last waiter, a complete retry on the same key passes
+    auto retry = std::async(std::launch::async, [&stores]() { return stores[0]->Barrier("partial", 2U, 5000); });
+    EXPECT_EQ(0, stores[1]->Barrier("partial", 2U, 5000));
+    EXPECT_EQ(0, retry.get());
+}
+
+TEST_F(StoreServerLoadTest, timed_out_gather_is_dropped)
+{
+    StartServer(4U, 2U);
+    auto rank0 = Connect(0);
+    auto rank1 = Connect(1);
+    ASSERT_TRUE(rank0 != nullptr && rank1 != nullptr);
+
+    // rank 0 gives up alone, its block must not make the retry look like a duplicate
+    std::vector<uint8_t> output;
+    EXPECT_NE(0, rank0->Gather("gather", 0U, 2U, {0U}, output, 50));
+    // the client gives up about when the server does, a gather of one is rejected until the server dropped it
+    for (int i = 0; i < 10000 && rank1->Gather("gather", 0U, 1U, {0U}, output, 5000) != 0; i++) {
+        std::this_thread::yield();
+    }
+
+    std::vector<uint8_t> output1;
+    auto retry = std::async(std::launch::async, [&rank0, &output]() {
+        return rank0->Gather("gather", 0U, 2U, {0U}, output, 5000);
+    });
+    EXPECT_EQ(0, rank1->Gather("gather", 1U, 2U, {1U}, output1, 5000));
+    EXPECT_EQ(0, retry.get());
+    EXPECT_EQ((std::vector<uint8_t>{0U, 1U}), output);
+    EXPECT_EQ(output, output1);
+}
+
+TEST_F(StoreServerLoadTest, async_and_multi_results_match_sync)
+{
+    StartServer(4U, 2U);
+    auto store = Connect(1);
+    ASSERT_TRUE(store != nullptr);
+    constexpr int keys = 64;
+    auto key_of = [](const char *prefix, int i) { return std::string(prefix) + std::to_string(i); };
+    auto bytes_of = [](const std::string &text) { return std::vector<uint8_t>(text.begin(), text.end()); };
+
+    for (int i = 0; i < keys; i++) {
+        EXPECT_EQ(0, store->Set(key_of("sync_", i), std::to_string(i)));
+    }
+
+    // pipelined: every request is on the wire before the first response is awaited
+    std::vector<std::future<int32_t>> futures;
+    for (int i = 0; i < keys; i++) {
+        futures.push_back(store->SetAsync(key_of("async_", i), bytes_of(std::to_string(i))));
+    }
+    for (auto &future : futures) {
+        EXPECT_EQ(0, future.get());
+    }
+
+    std::vector<std::vector<uint8_t>> values(keys);
+    std::vector<int64_t> sums(keys);
+    futures.clear();
+    for (int i = 0; i < keys; i++) {
+        futures.push_back(store->GetAsync(key_of("async_", i), values[i], 1000));
+        futures.push_back(store->AddAsync(key_of("counter_", i % 4), 1, sums[i]));
+    }
+    for (auto &future : futures) {
+        EXPECT_EQ(0, future.get());
+    }
+    for (int i = 0; i < keys; i++) {
+        EXPECT_EQ(bytes_of(std::to_string(i)), values[i]);
+    }
+
+    // one frame: removes of existing and missing keys, a get, an add and appends, each with its own result
+    std::vector<shm::store::StoreMultiOp> ops;
+    for (int i = 0; i < keys; i++) {
+        ops.push_back({shm::store::MessageType::REMOVE, key_of("sync_", i)});
+    }
+    ops.push_back({shm::store::MessageType::REMOVE, "never_set"});
+    ops.push_back({shm::store::MessageType::GET, "async_7"});
+    ops.push_back({shm::store::MessageType::ADD, "counter_0", bytes_of("10")});
+    ops.push_back({shm::store::MessageType::SET, "multi_set", bytes_of("value")});
+    ops.push_back({shm::store::MessageType::APPEND, "multi_append", bytes_of("abc")});
+    ops.push_back({shm::store::MessageType::APPEND, "multi_append", bytes_of("de")});
+    ASSERT_EQ(0, store->Multi(ops));
+    for (int i = 0; i < keys; i++) {
+        EXPECT_EQ(0, ops[i].result);
+    }
+    EXPECT_EQ(shm::store::StoreErrorCode::NOT_EXIST, ops[keys].result);
+    EXPECT_EQ(bytes_of("7"), ops[keys + 1].value);
+    EXPECT_EQ(bytes_of(std::to_string(keys / 4 + 10)), ops[keys + 2].value);
+    EXPECT_EQ(bytes_of("3"), ops[keys + 4].value);
+    EXPECT_EQ(bytes_of("5"), ops[keys + 5].value);
+    std::string value;
+    EXPECT_NE(0, store->Get("sync_0", value, 0));
+    EXPECT_EQ(0, store->Get("multi_set", value, 0));
+    EXPECT_EQ("value", value);
+    EXPECT_EQ(0, store->Get("multi_append", value, 0));
+    EXPECT_EQ("abcde", value);
+
+    // a pipeline deeper than the link send queue waits for the queue to drain instead of failing
+    constexpr int deep = 8 * shm::store::AccStoreServer::LINK_SEND_QUEUE_SIZE;
+    const std::vector<uint8_t> block(16384U, 1U);
+    futures.clear();
+    for (int i = 0; i < deep; i++) {
+        futures.push_back(store->SetAsync(key_of("deep_", i % keys), block));
+    }
+    for (auto &future : futures) {
+        EXPECT_EQ(0, future.get());
+    }
+}
+
+// every client parks its GETs on the one key, the last store sets it and then one more key
+TEST_F(StoreServerLoadTest, wakeup_fans_out_one_buffer_to_all_waiters)
+{
+    constexpr int clients = 16;
+    constexpr int waitsPerClient = 128;
+    StartServer(4U, shm::store::AccStoreServer::DEFAULT_WORKER_COUNT);
+    std::vector<shm::store::StorePtr> stores;
+    for (int rank = 0; rank <= clients; rank++) {
+        stores.push_back(Connect(rank));
+        ASSERT_TRUE(stores.back() != nullptr);
+    }
+
+    // a missing-key GET on the same link fences the parked GETs in on the server
+    std::vector<std::vector<std::vector<uint8_t>>> values(clients, std::vector<std::vector<uint8_t>>(waitsPerClient));
+    std::vector<std::future<int32_t>> futures;
+    std::string fence;
+    for (int rank = 0; rank < clients; rank++) {
+        for (int i = 0; i < waitsPerClient; i++) {
+            futures.push_back(stores[rank]->GetAsync("fanout", values[rank][i], 10000));
+        }
+        EXPECT_NE(0, stores[rank]->Get("fence", fence, 0));
+    }
+
+    // the next request of the setter is served by the same worker once the wakeup is done
+    const std::vector<uint8_t> payload(512, 0x3c);
+    ASSERT_EQ(0, stores[clients]->Set("fanout", payload));
+    ASSERT_EQ(0, stores[clients]->Set("after_fanout", payload));
+    for (auto &future : futures) {
+        EXPECT_EQ(0, future.get());
+    }
+    for (auto &perClient : values) {
+        for (auto &value : perClient) {
+            EXPECT_EQ(payload, value);
+        }
+    }
+}
@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "store_timer_wheel.h"
+
+using shm::store::StoreTimerWheel;
+
+TEST(StoreTimerWheelTest, fires_each_timer_once_at_its_deadline)
+{
+    constexpr int64_t start = 1000000;
+    StoreTimerWheel wheel{start};
+    std::mt19937_64 random{7};
+    std::unordered_map<uint64_t, int64_t> deadlines;
+    std::unordered_map<uint64_t, StoreTimerWheel::Handle> handles;
+    // due already, inside level 0, across every level boundary, and a few hours out
+    for (uint64_t id = 0; id < 20000U; id++) {
+        int64_t delay = static_cast<int64_t>(random() % (id % 10U == 0 ? 20000000U : 300000U)) - 10;
+        deadlines[id] = start + delay;
+        handles.emplace(id, wheel.Add(id, start + delay));
+    }
+    for (uint64_t id = 0; id < 20000U; id += 7U) {
+        wheel.Cancel(handles.at(id));
+        deadlines.erase(id);
+    }
+    ASSERT_EQ(deadlines.size(), wheel.Size());
+
+    std::vector<uint64_t> expired;
+    int64_t now = start;
+    while (!deadlines.empty()) {
+        now += static_cast<int64_t>(random() % 5000U);
+        wheel.Expire(now, expired);
+        for (auto id : expired) {
+            auto pos = deadlines.find(id);
+            ASSERT_TRUE(pos != deadlines.end()) << "id " << id << " fired twice or after cancel";
+            ASSERT_LE(pos->second, now);
+            deadlines.erase(pos);
+        }
+        expired.clear();
+        for (auto &pending : deadlines) {
+            ASSERT_GT(pending.second, now) << "id " << pending.first << " is late";
+        }
+    }
+    EXPECT_EQ(0U, wheel.Size());
+
+    // a timer added after a long idle period is not affected by it
+    wheel.Expire(now + 100000, expired);
+    wheel.Add(1U, now + 100010);
+    wheel.Expire(now + 100009, expired);
+    EXPECT_TRUE(expired.empty());
+    wheel.Expire(now + 100010, expired);
+    EXPECT_EQ(std::vector<uint64_t>{1U}, expired);
+}
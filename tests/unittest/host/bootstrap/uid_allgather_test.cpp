@@ -0,0 +1,235 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+#include <dlfcn.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "host/shmem_host_def.h"
+#include "utils/shmemi_host_types.h"
+#include "shmemi_host_def.h"
+
+// loopback multi-process runs of the UID bootstrap plugin, every rank is a forked process
+static const char *const uid_plugin_path = "./aclshmem_bootstrap_uid.so";
+
+static uint16_t uid_find_free_port()
+{
+    int sockfd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (sockfd < 0) {
+        return 0;
+    }
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    if (::bind(sockfd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(sockfd);
+        return 0;
+    }
+    socklen_t len = sizeof(addr);
+    ::getsockname(sockfd, (struct sockaddr *)&addr, &len);
+    close(sockfd);
+    return ntohs(addr.sin_port);
+}
+
+static uint8_t uid_pattern(int rank, size_t i)
+{
+    return static_cast<uint8_t>(rank * 131 + i * 7);
+}
+
+static uint8_t uid_alltoall_pattern(int src, int dst, size_t i)
+{
+    return static_cast<uint8_t>(src * 31 + dst * 7 + i);
+}
+
+// symmetric so that recv_sizes[src] on dst equals send_sizes[dst] on src, zero sized blocks included
+static int uid_alltoallv_size(int src, int dst)
+{
+    return (src + dst) % 5 * 3;
+}
+
+static int uid_check_alltoall(int rank, int nranks, int len, int rounds, aclshmemi_bootstrap_handle_t &handle)
+{
+    std::vector<uint8_t> send(static_cast<size_t>(len) * nranks);
+    std::vector<uint8_t> recv(send.size());
+    for (int dst = 0; dst < nranks; dst++) {
+        for (int i = 0; i < len; i++) {
+            send[dst * len + i] = uid_alltoall_pattern(rank, dst, i);
+        }
+    }
+    int ret = 0;
+    for (int r = 0; r < rounds && ret == 0; r++) {
+        std::fill(recv.begin(), recv.end(), 0);
+        ret = handle.alltoall(send.data(), recv.data(), len, &handle);
+        for (int src = 0; src < nranks && ret == 0; src++) {
+            for (int i = 0; i < len; i++) {
+                if (recv[src * len + i] != uid_alltoall_pattern(src, rank, i)) {
+                    ret = ACLSHMEM_INNER_ERROR;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::vector<int> sizes(nranks);
+    std::vector<uint8_t> vsend;
+    size_t recv_total = 0;
+    for (int peer = 0; peer < nranks; peer++) {
+        sizes[peer] = uid_alltoallv_size(rank, peer);
+        recv_total += sizes[peer];
+        for (int i = 0; i < sizes[peer]; i++) {
+            vsend.push_back(uid_alltoall_pattern(rank, peer, i));
+        }
+    }
+    std::vector<uint8_t> vrecv(recv_total + 1, 0);
+    vsend.push_back(0);
+    if (ret == 0) {
+        ret = handle.alltoallv(vsend.data(), sizes.data(), vrecv.data(), sizes.data(), &handle);
+    }
+    size_t offset = 0;
+    for (int src = 0; src < nranks && ret == 0; src++) {
+        for (int i = 0; i < sizes[src]; i++) {
+            if (vrecv[offset + i] != uid_alltoall_pattern(src, rank, i)) {
+                ret = ACLSHMEM_INNER_ERROR;
+                break;
+            }
+        }
+        offset += sizes[src];
+    }
+    return ret;
+}
+
+static int uid_run_rank(int rank, int nranks, const std::string &ipport, int len, int rounds)
+{
+    void *plugin = dlopen(uid_plugin_path, RTLD_NOW);
+    if (plugin == nullptr) {
+        return ACLSHMEM_INNER_ERROR;
+    }
+    using plugin_init_func = int (*)(void *, aclshmemi_bootstrap_handle_t *);
+    auto plugin_init = reinterpret_cast<plugin_init_func>(dlsym(plugin, "aclshmemi_bootstrap_plugin_init"));
+    if (plugin_init == nullptr) {
+        return ACLSHMEM_INNER_ERROR;
+    }
+
+    aclshmemi_bootstrap_uid_state_t uid{};
+    uid.my_pe = rank;
+    uid.n_pes = nranks;
+    aclshmemi_bootstrap_handle_t handle{};
+    handle.use_attr_ipport = true;
+    strncpy(handle.ipport, ipport.c_str(), sizeof(handle.ipport) - 1);
+
+    auto ret = plugin_init(&uid, &handle);
+    if (ret != 0) {
+        return ret;
+    }
+
+    std::vector<uint8_t> in(len);
+    std::vector<uint8_t> out(static_cast<size_t>(len) * nranks);
+    for (size_t i = 0; i < in.size(); i++) {
+        in[i] = uid_pattern(rank, i);
+    }
+    for (int r = 0; r < rounds && ret == 0; r++) {
+        std::fill(out.begin(), out.end(), 0);
+        ret = handle.allgather(in.data(), out.data(), len, &handle);
+        for (int peer = 0; peer < nranks && ret == 0; peer++) {
+            for (size_t i = 0; i < in.size(); i++) {
+                if (out[peer * in.size() + i] != uid_pattern(peer, i)) {
+                    ret = ACLSHMEM_INNER_ERROR;
+                    break;
+                }
+            }
+        }
+    }
+
+    for (int r = 0; r < rounds && ret == 0; r++) {
+        ret = handle.barrier(&handle);
+    }
+
+    if (ret == 0) {
+        ret = uid_check_alltoall(rank, nranks, len, rounds, handle);
+    }
+    handle.finalize(&handle);
+    return ret;
+}
+
+using uid_env_list = std::vector<std::pair<const char *, const char *>>;
+
+// runs one bootstrap session with nranks processes, every rank checks its own results
+static bool uid_run_session(int nranks, const uid_env_list &envs, int len, int rounds)
+{
+    auto port = uid_find_free_port();
+    if (port == 0) {
+        return false;
+    }
+    std::string ipport = "127.0.0.1:" + std::to_string(port);
+
+    std::vector<pid_t> pids;
+    for (int rank = 0; rank < nranks; rank++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            for (const auto &env : envs) {
+                setenv(env.first, env.second, 1);
+            }
+            _exit(uid_run_rank(rank, nranks, ipport, len, rounds) == 0 ? 0 : 1);
+        }
+        pids.push_back(pid);
+    }
+
+    bool success = true;
+    for (auto pid : pids) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        success = success && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+    return success;
+}
+
+static bool uid_plugin_present()
+{
+    return access(uid_plugin_path, F_OK) == 0;
+}
+
+TEST(BootstrapUidTest, allgather_algorithms_agree)
+{
+    if (!uid_plugin_present()) {
+        GTEST_SKIP() << "uid bootstrap SO not present, skipping";
+    }
+    // rd falls back to bruck when nranks is not a power of two, 40KB per rank takes the threaded send path
+    for (const char *algo : {"ring", "bruck", "rd", "auto"}) {
+        for (int nranks : {2, 3, 5, 8}) {
+            for (int len : {4, 512, 40000}) {
+                EXPECT_TRUE(uid_run_session(nranks, {{"SHMEM_BOOTSTRAP_ALLGATHER_ALGO", algo}}, len, 3))
+                    << "algo=" << algo << ", nranks=" << nranks << ", len=" << len;
+            }
+        }
+    }
+}
+
+TEST(BootstrapUidTest, barrier_algorithms_complete)
+{
+    if (!uid_plugin_present()) {
+        GTEST_SKIP() << "uid bootstrap SO not present, skipping";
+    }
+    for (const char *algo : {"ring", "v2", "dissemination"}) {
+        for (int nranks : {2, 3, 5, 8}) {
+            EXPECT_TRUE(uid_run_session(nranks, {{"SHMEM_BOOTSTRAP_BARRIER_ALGO", algo}}, 4, 3))
+                << "algo=" << algo << ", nranks=" << nranks;
+        }
+    }
+}
+
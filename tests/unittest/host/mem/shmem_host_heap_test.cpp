@@ -9,9 +9,11 @@
  */
 #include <cstdint>
 #include <unordered_set>
+#include <vector>
 #include <gtest/gtest.h>
 
 #include "acl/acl.h"
+#include "shmem.h"
 #include "shmemi_host_common.h"
 #include "unittest_main_test.h"
 
@@ -519,4 +521,231 @@ TEST_F(ShareMemoryManagerTest, free_merge)
             test_finalize(stream, device_id);
         },
         local_mem_size, process_count);
-}
\ No newline at end of file
+}
+
+TEST_F(ShareMemoryManagerTest, malloc_batch_success)
+{
+    const int process_count = test_gnpu_num;
+    uint64_t local_mem_size = heap_memory_size;
+    test_mutil_task(
+        [this](int rank_id, int n_ranks, uint64_t local_mem_size) {
+            int32_t device_id = rank_id % test_gnpu_num + test_first_npu;
+            aclrtStream stream;
+            test_init(rank_id, n_ranks, local_mem_size, &stream);
+            const size_t sizes[] = {64UL, 4096UL, 100UL, 256UL * 1024UL};
+            const size_t count = sizeof(sizes) / sizeof(sizes[0]);
+            void *ptrs[count];
+            EXPECT_EQ(ACLSHMEM_SUCCESS, aclshmemx_malloc_batch(sizes, count, ptrs));
+            std::unordered_set<void *> unique_ptrs;
+            for (size_t i = 0; i < count; ++i) {
+                EXPECT_NE(nullptr, ptrs[i]);
+                unique_ptrs.insert(ptrs[i]);
+            }
+            EXPECT_EQ(count, unique_ptrs.size());
+            aclshmemx_free_batch(ptrs, count);
+
+            auto ptr = aclshmem_malloc(heap_memory_size);
+            EXPECT_NE(nullptr, ptr);
+            aclshmem_free(ptr);
+            test_finalize(stream, device_id);
+        },
+        local_mem_size, process_count);
+}
+
+TEST_F(ShareMemoryManagerTest, malloc_batch_invalid_param)
+{
+    const int process_count = test_gnpu_num;
+    uint64_t local_mem_size = heap_memory_size;
+    test_mutil_task(
+        [this](int rank_id, int n_ranks, uint64_t local_mem_size) {
+            int32_t device_id = rank_id % test_gnpu_num + test_first_npu;
+            aclrtStream stream;
+            test_init(rank_id, n_ranks, local_mem_size, &stream);
+            size_t sizes[] = {64UL, 0UL};
+            void *ptrs[2] = {nullptr, nullptr};
+            EXPECT_EQ(ACLSHMEM_INVALID_PARAM, aclshmemx_malloc_batch(nullptr, 2, ptrs));
+            EXPECT_EQ(ACLSHMEM_INVALID_PARAM, aclshmemx_malloc_batch(sizes, 0, ptrs));
+            EXPECT_NE(ACLSHMEM_SUCCESS, aclshmemx_malloc_batch(sizes, 2, ptrs));
+            EXPECT_EQ(nullptr, ptrs[0]);
+            EXPECT_EQ(nullptr, ptrs[1]);
+            test_finalize(stream, device_id);
+        },
+        local_mem_size, process_count);
+}
+
+TEST_F(ShareMemoryManagerTest, free_deferred_released_at_next_barrier)
+{
+    const int process_count = test_gnpu_num;
+    uint64_t local_mem_size = heap_memory_size;
+    test_mutil_task(
+        [this](int rank_id, int n_ranks, uint64_t local_mem_size) {
+            int32_t device_id = rank_id % test_gnpu_num + test_first_npu;
+            aclrtStream stream;
+            test_init(rank_id, n_ranks, local_mem_size, &stream);
+            auto ptr = aclshmem_malloc(heap_memory_size);
+            ASSERT_NE(nullptr, ptr);
+            aclshmemx_free_deferred(ptr);
+
+            // the block is still held while this malloc allocates, its barrier flushes the deferred free
+            auto busy = aclshmem_malloc(heap_memory_size);
+            EXPECT_EQ(nullptr, busy);
+
+            auto again = aclshmem_malloc(heap_memory_size);
+            EXPECT_NE(nullptr, again);
+            aclshmem_free(again);
+            test_finalize(stream, device_id);
+        },
+        local_mem_size, process_count);
+}
+
+TEST_F(ShareMemoryManagerTest, heap_stats_track_fragmentation)
+{
+    const int process_count = test_gnpu_num;
+    uint64_t local_mem_size = heap_memory_size;
+    test_mutil_task(
+        [this](int rank_id, int n_ranks, uint64_t local_mem_size) {
+            int32_t device_id = rank_id % test_gnpu_num + test_first_npu;
+            aclrtStream stream;
+            test_init(rank_id, n_ranks, local_mem_size, &stream);
+            EXPECT_EQ(ACLSHMEM_INVALID_PARAM, aclshmemx_heap_stats(nullptr));
+
+            // init already holds a few internal buffers, compare against that baseline
+            aclshmemx_heap_stats_t base{};
+            ASSERT_EQ(ACLSHMEM_SUCCESS, aclshmemx_heap_stats(&base));
+            EXPECT_EQ(base.total_bytes, base.used_bytes + base.free_bytes);
+            EXPECT_LE(base.largest_free_block, base.free_bytes);
+
+            // free every other block, leaving 256KB holes in front of the tail
+            constexpr uint64_t block_size = 256UL * 1024UL;
+            std::vector<void *> ptrs;
+            for (int i = 0; i < 8; i++) {
+                ptrs.push_back(aclshmem_malloc(block_size));
+                ASSERT_NE(nullptr, ptrs.back());
+            }
+            for (size_t i = 0; i < ptrs.size(); i += 2) {
+                aclshmem_free(ptrs[i]);
+            }
+            aclshmemx_heap_stats_t stats{};
+            ASSERT_EQ(ACLSHMEM_SUCCESS, aclshmemx_heap_stats(&stats));
+            EXPECT_EQ(base.used_bytes + 4UL * block_size, stats.used_bytes);
+            EXPECT_GE(stats.high_water_mark, base.used_bytes + 8UL * block_size);
+            EXPECT_EQ(base.allocated_blocks + 4UL, stats.allocated_blocks);
+            EXPECT_GE(stats.free_block_count, base.free_block_count + 3UL);
+            EXPECT_GE(stats.free_block_histogram[12], base.free_block_histogram[12] + 3UL);
+            EXPECT_LT(stats.largest_free_block, stats.free_bytes);
+
+            for (size_t i = 1; i < ptrs.size(); i += 2) {
+                aclshmem_free(ptrs[i]);
+            }
+            ASSERT_EQ(ACLSHMEM_SUCCESS, aclshmemx_heap_stats(&stats));
+            EXPECT_EQ(base.used_bytes, stats.used_bytes);
+            EXPECT_EQ(base.free_block_count, stats.free_block_count);
+            EXPECT_EQ(base.largest_free_block, stats.largest_free_block);
+            test_finalize(stream, device_id);
+        },
+        local_mem_size, process_count);
+}
+
+TEST_F(ShareMemoryManagerTest, heap_commits_on_demand)
+{
+    const int process_count = test_gnpu_num;
+    uint64_t local_mem_size = heap_memory_size;
+    test_mutil_task(
+        [this](int rank_id, int n_ranks, uint64_t local_mem_size) {
+            int32_t device_id = rank_id % test_gnpu_num + test_first_npu;
+            aclrtStream stream;
+            // only the first 2MB is backed at init, the blocks below have to grow the heap
+            setenv("SHMEM_HEAP_COMMIT_GRANULE_MB", "2", 1);
+            test_init(rank_id, n_ranks, local_mem_size, &stream);
+            constexpr uint64_t block_size = 1024UL * 1024UL;
+            std::vector<void *> ptrs;
+            for (int i = 0; i < 4; i++) {
+                ptrs.push_back(aclshmem_calloc(1, block_size));
+                ASSERT_NE(nullptr, ptrs.back());
+            }
+            uint32_t value = 0xffffffffU;
+            ASSERT_EQ(aclrtMemcpy(&value, sizeof(value), ptrs.back(), sizeof(value), ACL_MEMCPY_DEVICE_TO_HOST), 0);
+            EXPECT_EQ(value, 0u);
+
+            // the peers reach the grown block through the transports as well
+            constexpr size_t chunk_size = 4096;
+            auto grown = ptrs.back();
+            auto fill = [](int32_t seed) {
+                std::vector<uint32_t> pattern(chunk_size / sizeof(uint32_t));
+                for (size_t i = 0; i < pattern.size(); i++) {
+                    pattern[i] = static_cast<uint32_t>(i) * 31U + static_cast<uint32_t>(seed);
+                }
+                return pattern;
+            };
+            int32_t prev_pe = (rank_id + n_ranks - 1) % n_ranks;
+            int32_t next_pe = (rank_id + 1) % n_ranks;
+            auto local = fill(rank_id);
+            ASSERT_EQ(aclrtMemcpy(grown, chunk_size, local.data(), chunk_size, ACL_MEMCPY_HOST_TO_DEVICE), 0);
+            aclshmemi_control_barrier_all();
+
+            aclshmem_handle_t handle;
+            handle.team_id = ACLSHMEM_TEAM_WORLD;
+            aclshmemx_getmem_on_stream(ptrs[0], grown, chunk_size, prev_pe, stream);
+            aclshmemx_handle_wait(handle, stream);
+            ASSERT_EQ(aclrtSynchronizeStream(stream), 0);
+            std::vector<uint32_t> result(local.size(), 0);
+            ASSERT_EQ(aclrtMemcpy(result.data(), chunk_size, ptrs[0], chunk_size, ACL_MEMCPY_DEVICE_TO_HOST), 0);
+            EXPECT_EQ(fill(prev_pe), result);
+            aclshmemi_control_barrier_all();
+
+            auto put_data = fill(rank_id + n_ranks);
+            ASSERT_EQ(aclrtMemcpy(ptrs[1], chunk_size, put_data.data(), chunk_size, ACL_MEMCPY_HOST_TO_DEVICE), 0);
+            aclshmemx_putmem_on_stream(grown, ptrs[1], chunk_size, next_pe, stream);
+            aclshmemx_handle_wait(handle, stream);
+            ASSERT_EQ(aclrtSynchronizeStream(stream), 0);
+            aclshmemi_control_barrier_all();
+            ASSERT_EQ(aclrtMemcpy(result.data(), chunk_size, grown, chunk_size, ACL_MEMCPY_DEVICE_TO_HOST), 0);
+            EXPECT_EQ(fill(prev_pe + n_ranks), result);
+
+            for (auto ptr : ptrs) {
+                aclshmem_free(ptr);
+            }
+            test_finalize(stream, device_id);
+            unsetenv("SHMEM_HEAP_COMMIT_GRANULE_MB");
+        },
+        local_mem_size, process_count);
+}
+
+TEST_F(ShareMemoryManagerTest, realloc_in_place_and_move)
+{
+    const int process_count = test_gnpu_num;
+    uint64_t local_mem_size = heap_memory_size;
+    test_mutil_task(
+        [this](int rank_id, int n_ranks, uint64_t local_mem_size) {
+            int32_t device_id = rank_id % test_gnpu_num + test_first_npu;
+            aclrtStream stream;
+            test_init(rank_id, n_ranks, local_mem_size, &stream);
+            constexpr uint64_t block_size = 256UL * 1024UL;
+            std::vector<uint32_t> pattern(block_size / sizeof(uint32_t));
+            for (size_t i = 0; i < pattern.size(); i++) {
+                pattern[i] = static_cast<uint32_t>(i) + static_cast<uint32_t>(rank_id);
+            }
+
+            // nothing behind ptr yet, so it grows in place
+            auto ptr = aclshmemx_malloc(block_size);
+            ASSERT_NE(nullptr, ptr);
+            ASSERT_EQ(aclrtMemcpy(ptr, block_size, pattern.data(), block_size, ACL_MEMCPY_HOST_TO_DEVICE), 0);
+            auto grown = aclshmemx_realloc(ptr, 2UL * block_size);
+            EXPECT_EQ(ptr, grown);
+
+            // a block right behind forces the move path, the contents follow the block
+            auto blocker = aclshmemx_malloc(block_size);
+            ASSERT_NE(nullptr, blocker);
+            auto moved = aclshmemx_realloc(grown, 4UL * block_size);
+            ASSERT_NE(nullptr, moved);
+            EXPECT_NE(grown, moved);
+            std::vector<uint32_t> result(pattern.size(), 0);
+            ASSERT_EQ(aclrtMemcpy(result.data(), block_size, moved, block_size, ACL_MEMCPY_DEVICE_TO_HOST), 0);
+            EXPECT_EQ(pattern, result);
+
+            EXPECT_EQ(nullptr, aclshmemx_realloc(moved, 0));
+            aclshmemx_free(blocker);
+            test_finalize(stream, device_id);
+        },
+        local_mem_size, process_count);
+}
@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "mem/shmemi_mgr.h"
+
+// memory_manager only does bookkeeping, the heap base is never dereferenced
+static uint8_t *const contention_heap_base = (uint8_t *)(ptrdiff_t)0x100000000UL;
+static constexpr uint64_t contention_heap_size = 1UL * 1024UL * 1024UL * 1024UL;
+
+static uint64_t contention_test_size(uint32_t i)
+{
+    // half slab sized, half served by the best-fit trees
+    static const uint64_t sizes[] = {64UL, 1024UL, 16384UL, 262144UL, 2UL * 1024UL * 1024UL, 4096UL};
+    return sizes[i % (sizeof(sizes) / sizeof(sizes[0]))];
+}
+
+// readers validate long lived pointers while one writer allocates and releases other blocks for the given batches
+static uint64_t run_lookup_contention(memory_manager &manager, const std::vector<void *> &live, uint32_t reader_num,
+                                      uint32_t churn_batches)
+{
+    std::atomic<bool> stop{false};
+    std::atomic<uint32_t> ready{0};
+    std::atomic<uint64_t> failures{0};
+
+    std::vector<std::thread> readers;
+    for (uint32_t t = 0; t < reader_num; t++) {
+        readers.emplace_back([&manager, &live, &stop, &ready, &failures, t]() {
+            uint64_t local_failures = 0;
+            uint64_t size = 0;
+            uint32_t i = t;
+            ready.fetch_add(1U);
+            while (!stop.load(std::memory_order_relaxed)) {
+                auto ptr = live[i % live.size()];
+                if (!manager.allocated_size(ptr, size) || size < contention_test_size(i % live.size())) {
+                    local_failures++;
+                }
+                i += 7U;
+            }
+            failures.fetch_add(local_failures);
+        });
+    }
+
+    // the churn starts once every reader is looking up
+    while (ready.load() < reader_num) {
+        std::this_thread::yield();
+    }
+    std::vector<void *> churn;
+    for (uint32_t batch = 0; batch < churn_batches; batch++) {
+        for (uint32_t i = 0; i < 64U; i++) {
+            churn.push_back(manager.allocate(contention_test_size(i)));
+        }
+        for (auto ptr : churn) {
+            manager.release(ptr);
+        }
+        churn.clear();
+    }
+    stop.store(true);
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    return failures.load();
+}
+
+TEST(MemoryManagerContentionTest, lookups_stay_consistent_under_churn)
+{
+    memory_manager manager{contention_heap_base, contention_heap_size};
+    std::vector<void *> live;
+    for (uint32_t i = 0; i < 256U; i++) {
+        live.push_back(manager.allocate(contention_test_size(i)));
+        ASSERT_NE(nullptr, live.back());
+    }
+
+    EXPECT_EQ(0UL, run_lookup_contention(manager, live, 4U, 200U));
+
+    for (auto ptr : live) {
+        EXPECT_EQ(0, manager.release(ptr));
+    }
+    EXPECT_EQ(contention_heap_base, manager.allocate(contention_heap_size));
+}
+
+TEST(MemoryManagerContentionTest, concurrent_release_is_linearizable)
+{
+    memory_manager manager{contention_heap_base, contention_heap_size};
+    constexpr uint32_t block_num = 4096U;
+    std::vector<void *> blocks;
+    for (uint32_t i = 0; i < block_num; i++) {
+        blocks.push_back(manager.allocate(contention_test_size(i) / 2U + 16UL));
+        ASSERT_NE(nullptr, blocks.back());
+    }
+
+    // every block is released by all threads, exactly one of them must win
+    std::atomic<uint32_t> success{0};
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < 4U; t++) {
+        threads.emplace_back([&manager, &blocks, &success]() {
+            for (auto ptr : blocks) {
+                if (manager.release(ptr) == 0) {
+                    success.fetch_add(1U);
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(block_num, success.load());
+    EXPECT_EQ(contention_heap_base, manager.allocate(contention_heap_size));
+}
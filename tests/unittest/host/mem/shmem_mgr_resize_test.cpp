@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+#include <cstdint>
+#include <gtest/gtest.h>
+
+#include "mem/shmemi_mgr.h"
+
+// memory_manager only does bookkeeping, the heap base is never dereferenced
+static uint8_t *const resize_heap_base = (uint8_t *)(ptrdiff_t)0x100000000UL;
+static constexpr uint64_t resize_heap_size = 64UL * 1024UL * 1024UL;
+static constexpr uint64_t resize_block_size = 1024UL * 1024UL;
+
+TEST(MemoryManagerResizeTest, grow_into_free_neighbour)
+{
+    memory_manager manager{resize_heap_base, resize_heap_size};
+    auto ptr = manager.allocate(resize_block_size);
+    ASSERT_NE(nullptr, ptr);
+
+    EXPECT_TRUE(manager.can_change_size(ptr, 4UL * resize_block_size));
+    EXPECT_TRUE(manager.change_size(ptr, 4UL * resize_block_size));
+    uint64_t size = 0;
+    EXPECT_TRUE(manager.allocated_size(ptr, size));
+    EXPECT_EQ(4UL * resize_block_size, size);
+
+    // the grown range is no longer handed out
+    auto next = static_cast<uint8_t *>(manager.allocate(resize_block_size));
+    EXPECT_EQ(static_cast<uint8_t *>(ptr) + 4UL * resize_block_size, next);
+}
+
+TEST(MemoryManagerResizeTest, grow_blocked_by_used_neighbour)
+{
+    memory_manager manager{resize_heap_base, resize_heap_size};
+    auto ptr = manager.allocate(resize_block_size);
+    auto next = manager.allocate(resize_block_size);
+    ASSERT_NE(nullptr, ptr);
+    ASSERT_NE(nullptr, next);
+
+    EXPECT_FALSE(manager.can_change_size(ptr, 2UL * resize_block_size));
+    EXPECT_FALSE(manager.change_size(ptr, 2UL * resize_block_size));
+    uint64_t size = 0;
+    EXPECT_TRUE(manager.allocated_size(ptr, size));
+    EXPECT_EQ(resize_block_size, size);
+
+    EXPECT_EQ(0, manager.release(next));
+    EXPECT_TRUE(manager.can_change_size(ptr, 2UL * resize_block_size));
+}
+
+TEST(MemoryManagerResizeTest, shrink_keeps_alignment)
+{
+    memory_manager manager{resize_heap_base, resize_heap_size};
+    auto ptr = static_cast<uint8_t *>(manager.allocate(resize_block_size));
+    ASSERT_NE(nullptr, ptr);
+
+    // odd sizes are rounded up so the idle block behind stays aligned
+    EXPECT_TRUE(manager.can_change_size(ptr, resize_block_size / 2U + 1UL));
+    EXPECT_TRUE(manager.change_size(ptr, resize_block_size / 2U + 1UL));
+    auto next = static_cast<uint8_t *>(manager.allocate(resize_block_size));
+    ASSERT_NE(nullptr, next);
+    EXPECT_EQ(0UL, reinterpret_cast<uintptr_t>(next) & 15UL);
+    EXPECT_EQ(ptr + resize_block_size / 2U + 16UL, next);
+
+    EXPECT_EQ(0, manager.release(ptr));
+    EXPECT_EQ(0, manager.release(next));
+    EXPECT_EQ(resize_heap_base, manager.allocate(resize_heap_size));
+}
+
+TEST(MemoryManagerResizeTest, slab_slot_resizes_within_slot)
+{
+    memory_manager manager{resize_heap_base, resize_heap_size};
+    auto ptr = manager.allocate(100UL);
+    ASSERT_NE(nullptr, ptr);
+    uint64_t slot_size = 0;
+    ASSERT_TRUE(manager.allocated_size(ptr, slot_size));
+
+    EXPECT_TRUE(manager.can_change_size(ptr, slot_size));
+    EXPECT_FALSE(manager.can_change_size(ptr, slot_size + 1UL));
+    EXPECT_FALSE(manager.can_change_size(nullptr, 16UL));
+    EXPECT_FALSE(manager.can_change_size(ptr, 0UL));
+
+    // a neighbour keeps the span alive, the freed slot must not be resizable
+    auto other = manager.allocate(100UL);
+    ASSERT_NE(nullptr, other);
+    EXPECT_EQ(0, manager.release(ptr));
+    EXPECT_FALSE(manager.can_change_size(ptr, 16UL));
+    EXPECT_TRUE(manager.can_change_size(other, 16UL));
+}
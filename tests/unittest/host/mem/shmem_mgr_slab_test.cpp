@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+#include <cstdint>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "mem/shmemi_mgr.h"
+
+// memory_manager only does bookkeeping, the heap base is never dereferenced
+static uint8_t *const slab_heap_base = (uint8_t *)(ptrdiff_t)0x100000000UL;
+static constexpr uint64_t slab_heap_size = 1UL * 1024UL * 1024UL * 1024UL;
+
+static uint64_t slab_test_size(uint32_t i)
+{
+    // MoE style mix of small symmetric buffers, 48B ~ 60KB
+    static const uint64_t sizes[] = {48UL, 200UL, 1024UL, 3000UL, 4096UL, 16384UL, 61440UL, 512UL};
+    return sizes[i % (sizeof(sizes) / sizeof(sizes[0]))];
+}
+
+TEST(MemoryManagerSlabTest, small_allocations_are_symmetric)
+{
+    memory_manager pe0{slab_heap_base, slab_heap_size};
+    memory_manager pe1{slab_heap_base, slab_heap_size};
+    std::vector<void *> ptrs;
+
+    for (uint32_t i = 0; i < 4096U; i++) {
+        auto p0 = pe0.allocate(slab_test_size(i));
+        auto p1 = pe1.allocate(slab_test_size(i));
+        ASSERT_NE(nullptr, p0);
+        EXPECT_EQ(p0, p1);
+        ptrs.push_back(p0);
+        if ((i % 3U) == 0) {
+            EXPECT_EQ(0, pe0.release(ptrs[i / 2U]));
+            EXPECT_EQ(0, pe1.release(ptrs[i / 2U]));
+            ptrs[i / 2U] = nullptr;
+        }
+    }
+}
+
+TEST(MemoryManagerSlabTest, small_allocation_alignment)
+{
+    memory_manager manager{slab_heap_base, slab_heap_size};
+    for (uint64_t alignment = 16UL; alignment <= 65536UL; alignment <<= 1U) {
+        auto ptr = manager.aligned_allocate(alignment, 48UL);
+        ASSERT_NE(nullptr, ptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) & (alignment - 1UL), 0UL);
+    }
+}
+
+TEST(MemoryManagerSlabTest, invalid_release_does_not_corrupt)
+{
+    memory_manager manager{slab_heap_base, slab_heap_size};
+    auto ptr = static_cast<uint8_t *>(manager.allocate(1024UL));
+    ASSERT_NE(nullptr, ptr);
+
+    uint64_t size = 0;
+    EXPECT_TRUE(manager.allocated_size(ptr, size));
+    EXPECT_GE(size, 1024UL);
+    EXPECT_FALSE(manager.allocated_size(ptr + 64, size));
+
+    EXPECT_NE(0, manager.release(ptr + 64));
+    EXPECT_FALSE(manager.change_size(ptr + 64, 512UL));
+
+    // a neighbour keeps the span alive, the freed slot must not be resizable
+    auto other = manager.allocate(1024UL);
+    ASSERT_NE(nullptr, other);
+    EXPECT_EQ(0, manager.release(ptr));
+    EXPECT_NE(0, manager.release(ptr));
+    EXPECT_FALSE(manager.change_size(ptr, 512UL));
+    EXPECT_TRUE(manager.change_size(other, 512UL));
+}
+
+TEST(MemoryManagerSlabTest, spans_return_to_tree_when_idle)
+{
+    memory_manager manager{slab_heap_base, slab_heap_size};
+    std::vector<void *> ptrs;
+    for (uint32_t i = 0; i < 10000U; i++) {
+        ptrs.push_back(manager.allocate(slab_test_size(i)));
+        ASSERT_NE(nullptr, ptrs.back());
+    }
+    for (auto ptr : ptrs) {
+        EXPECT_EQ(0, manager.release(ptr));
+    }
+
+    auto whole = manager.allocate(slab_heap_size);
+    EXPECT_EQ(slab_heap_base, whole);
+}